@@ -0,0 +1,73 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __SPIR_BENCH_H__
+#define __SPIR_BENCH_H__
+
+#include "spir_name_mangler/BuiltinParser.h"
+#include "llvm/Support/raw_ostream.h"
+#include <stddef.h>
+
+namespace SPIR { namespace bench {
+
+/// @brief Input shared by all benchmarks: the built-ins of opencl_spir.h.
+struct BenchInput {
+  /// The header's contents.
+  llvm::StringRef header;
+  /// The overloads of the header, parsed for SPIR (32 bit).
+  BuiltinDeclarationList builtins32;
+  /// The overloads of the header, parsed for SPIR64.
+  BuiltinDeclarationList builtins64;
+  /// Number of times each measured loop is repeated.
+  unsigned iterations;
+};
+
+typedef void (BenchFunc)(const BenchInput&, llvm::raw_ostream&);
+
+/// @brief Registers a benchmark function, see SPIR_BENCHMARK.
+struct BenchRegistration {
+  BenchRegistration(const char* name, BenchFunc* func);
+};
+
+/// @brief Wall clock stopwatch.
+class Stopwatch {
+public:
+  Stopwatch();
+
+  /// @brief Restarts the measurement.
+  void reset();
+
+  /// @brief Returns the seconds passed since construction or last reset.
+  double elapsed() const;
+
+private:
+  double m_start;
+};
+
+/// @brief Returns the number of calls to operator new so far.
+size_t getAllocationCount();
+
+/// @brief Prints a single measurement line.
+/// @param label what was measured.
+/// @param seconds total time of the measurement.
+/// @param ops number of operations performed in that time.
+void report(llvm::raw_ostream& o, const char* label, double seconds,
+            size_t ops);
+
+/// @brief Prints a single counter line (bytes, allocations, ...).
+void reportCount(llvm::raw_ostream& o, const char* label, size_t count,
+                 const char* unit);
+
+}} // End SPIR::bench namespace
+
+/// @brief Defines and registers a benchmark function named 'name'.
+#define SPIR_BENCHMARK(name) \
+  static void name##Bench(const SPIR::bench::BenchInput&, llvm::raw_ostream&); \
+  static SPIR::bench::BenchRegistration name##Registration(#name, name##Bench); \
+  static void name##Bench
+
+#endif //__SPIR_BENCH_H__
@@ -0,0 +1,137 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/system_error.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+#ifndef SPIR_OPENCL_HEADER
+#define SPIR_OPENCL_HEADER "opencl_spir.h"
+#endif
+
+static cl::opt<std::string>
+HeaderFilename("header", cl::desc("OpenCL built-ins header"),
+    cl::init(SPIR_OPENCL_HEADER), cl::value_desc("filename"));
+
+static cl::opt<unsigned>
+Iterations("iterations", cl::desc("Number of repetitions of each loop"),
+    cl::init(10));
+
+static cl::opt<std::string>
+Filter("filter", cl::desc("Run only benchmarks whose name contains this"),
+    cl::init(""));
+
+static std::atomic<size_t> AllocationCount(0);
+
+// Count all heap allocations of the process.
+void* operator new(size_t size) {
+  ++AllocationCount;
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+namespace {
+  struct Benchmark {
+    const char* name;
+    BenchFunc* func;
+  };
+}
+
+static std::vector<Benchmark>& getBenchmarks() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+namespace SPIR { namespace bench {
+
+BenchRegistration::BenchRegistration(const char* name, BenchFunc* func) {
+  Benchmark b = { name, func };
+  getBenchmarks().push_back(b);
+}
+
+size_t getAllocationCount() {
+  return AllocationCount;
+}
+
+Stopwatch::Stopwatch() {
+  reset();
+}
+
+void Stopwatch::reset() {
+  m_start = TimeRecord::getCurrentTime(true).getWallTime();
+}
+
+double Stopwatch::elapsed() const {
+  return TimeRecord::getCurrentTime(false).getWallTime() - m_start;
+}
+
+void report(raw_ostream& o, const char* label, double seconds, size_t ops) {
+  o << "  " << left_justify(label, 48)
+    << format("%10.3f ms", seconds * 1e3);
+  if (ops)
+    o << format("%10.1f ns/op", seconds * 1e9 / ops);
+  o << "\n";
+}
+
+void reportCount(raw_ostream& o, const char* label, size_t count,
+                 const char* unit) {
+  o << "  " << left_justify(label, 48)
+    << format("%10lu %s", (unsigned long)count, unit) << "\n";
+}
+
+}} // End SPIR::bench namespace
+
+int main(int argc, const char *argv[]) {
+  cl::ParseCommandLineOptions(argc, argv, "SPIR name mangler benchmarks");
+
+  OwningPtr<MemoryBuffer> header;
+  error_code ErrCode = MemoryBuffer::getFile(HeaderFilename, header);
+  if (!header.get()) {
+    errs() << "Cannot read " << HeaderFilename << ": "
+           << ErrCode.message() << "\n";
+    return 1;
+  }
+
+  BenchInput input;
+  input.header = header->getBuffer();
+  input.iterations = Iterations;
+  unsigned failures32 = parseBuiltinHeader(input.header, false,
+                                           input.builtins32);
+  unsigned failures64 = parseBuiltinHeader(input.header, true,
+                                           input.builtins64);
+  outs() << "Parsed " << input.builtins32.size() << " built-in overloads from "
+         << HeaderFilename << " (" << failures32 << "/" << failures64
+         << " declarations skipped)\n";
+
+  std::vector<Benchmark>& benchmarks = getBenchmarks();
+  for (unsigned i = 0; i < benchmarks.size(); ++i) {
+    if (StringRef(benchmarks[i].name).find(Filter) == StringRef::npos)
+      continue;
+    outs() << "\n" << benchmarks[i].name << ":\n";
+    benchmarks[i].func(input, outs());
+  }
+  return 0;
+}
@@ -0,0 +1,75 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/BuiltinDatabase.h"
+#include "spir_name_mangler/BuiltinTable.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "llvm/ADT/OwningPtr.h"
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+// Compares the ways a runtime can get the built-ins at start up: parsing the
+// OpenCL header, building descriptors from the linked built-in table, or
+// loading the built-in database (and finding a name in it).
+SPIR_BENCHMARK(BuiltinDatabase)(const BenchInput& input, raw_ostream& o) {
+  size_t count = 0;
+  Stopwatch sw;
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    BuiltinDeclarationList builtins32, builtins64;
+    parseBuiltinHeader(input.header, false, builtins32);
+    parseBuiltinHeader(input.header, true, builtins64);
+    count += builtins32.size() + builtins64.size();
+  }
+  report(o, "load, parsing the header", sw.elapsed(), input.iterations);
+
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    std::vector<FunctionDescriptor> fds;
+    fds.reserve(2 * BI_NUM_BUILTINS);
+    for (unsigned i = 0; i < BI_NUM_BUILTINS; ++i) {
+      fds.push_back(getBuiltinDescriptor((BuiltinID)i, false));
+      fds.push_back(getBuiltinDescriptor((BuiltinID)i, true));
+    }
+    count += fds.size();
+  }
+  report(o, "load, descriptors of the built-in table", sw.elapsed(),
+    input.iterations);
+
+  std::string error;
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    OwningPtr<BuiltinDatabase> db(
+      BuiltinDatabase::open(SPIR_BUILTIN_DATABASE, error));
+    if (!db) {
+      o << "  " << error << "\n";
+      return;
+    }
+    count += db->lookup("_Z3cosf", false) != BuiltinDatabase::NOT_FOUND;
+  }
+  report(o, "load, opening the database", sw.elapsed(), input.iterations);
+
+  OwningPtr<BuiltinDatabase> db(
+    BuiltinDatabase::open(SPIR_BUILTIN_DATABASE, error));
+  std::vector<std::string> names;
+  for (unsigned i = 0; i < input.builtins32.size(); ++i)
+    names.push_back(mangle(input.builtins32[i].descriptor));
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it)
+    for (unsigned i = 0; i < names.size(); ++i)
+      count += db->lookup(names[i], false) != BuiltinDatabase::NOT_FOUND;
+  report(o, "database lookup", sw.elapsed(), names.size() * input.iterations);
+
+  reportCount(o, "database size", db->getSize(), "bytes");
+  // Keep the loops from being optimized away.
+  if (!count)
+    o << "  (nothing loaded)\n";
+}
@@ -0,0 +1,90 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/BuiltinTable.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+typedef std::map<std::string, BuiltinID> BuiltinMap;
+
+// Looks the names up in a map, as std::string keys (converted from StringRef
+// first, as for the name of an llvm::Function, when 'convert' is set).
+static void lookupMap(const BuiltinMap& map,
+                      const std::vector<std::string>& names,
+                      const std::vector<StringRef>& refs, bool convert,
+                      const BenchInput& input, const char* label,
+                      raw_ostream& o) {
+  size_t found = 0;
+  Stopwatch sw;
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 0; i < names.size(); ++i) {
+      BuiltinMap::const_iterator entry =
+        convert ? map.find(refs[i].str()) : map.find(names[i]);
+      found += entry != map.end();
+    }
+  }
+  report(o, label, sw.elapsed(), names.size() * input.iterations);
+  // Keep the loops from being optimized away.
+  if (found == 1)
+    o << "  (one name found)\n";
+}
+
+static void lookupHash(const std::vector<StringRef>& refs,
+                       const BenchInput& input, const char* label,
+                       raw_ostream& o) {
+  size_t found = 0;
+  Stopwatch sw;
+  for (unsigned it = 0; it < input.iterations; ++it)
+    for (unsigned i = 0; i < refs.size(); ++i)
+      found += lookupBuiltin(refs[i], false).isValid();
+  report(o, label, sw.elapsed(), refs.size() * input.iterations);
+  if (found == 1)
+    o << "  (one name found)\n";
+}
+
+// Compares finding the built-ins of opencl_spir.h by mangled name, in a
+// std::map and with lookupBuiltin(), for names of built-ins and for names
+// that are not.
+SPIR_BENCHMARK(BuiltinLookup)(const BenchInput& input, raw_ostream& o) {
+  BuiltinMap map;
+  for (unsigned i = 0; i < BI_NUM_BUILTINS; ++i) {
+    BuiltinID id = static_cast<BuiltinID>(i);
+    map[getBuiltinMangledName(id, false).str()] = id;
+  }
+
+  // The names of the header's declarations, and the same names without
+  // their last character (not built-ins).
+  std::vector<std::string> hits, misses;
+  for (unsigned i = 0; i < input.builtins32.size(); ++i) {
+    hits.push_back(mangle(input.builtins32[i].descriptor));
+    misses.push_back(hits.back().substr(0, hits.back().size() - 1));
+  }
+  std::vector<StringRef> hitRefs(hits.begin(), hits.end());
+  std::vector<StringRef> missRefs(misses.begin(), misses.end());
+
+  lookupMap(map, hits, hitRefs, false, input, "std::map, built-ins", o);
+  lookupMap(map, hits, hitRefs, true, input,
+    "std::map from StringRef, built-ins", o);
+  lookupHash(hitRefs, input, "lookupBuiltin, built-ins", o);
+  lookupMap(map, misses, missRefs, false, input, "std::map, other names", o);
+  lookupMap(map, misses, missRefs, true, input,
+    "std::map from StringRef, other names", o);
+  lookupHash(missRefs, input, "lookupBuiltin, other names", o);
+
+  size_t allocations = getAllocationCount();
+  for (unsigned i = 0; i < hitRefs.size(); ++i)
+    lookupBuiltin(hitRefs[i], false);
+  reportCount(o, "lookupBuiltin allocations",
+    getAllocationCount() - allocations, "allocations");
+}
@@ -0,0 +1,73 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/NameRecognizer.h"
+
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+// Mangles every overload of opencl_spir.h, then parses all names back with
+// both demangler variants and the recognizer.
+SPIR_BENCHMARK(Demangle)(const BenchInput& input, raw_ostream& o) {
+  const BuiltinDeclarationList& builtins = input.builtins32;
+  std::vector<std::string> names;
+  for (unsigned i = 0; i < builtins.size(); ++i)
+    names.push_back(mangle(builtins[i].descriptor));
+
+  // Sanity: every name must survive a round trip.
+  unsigned mismatches = 0;
+  for (unsigned i = 0; i < names.size(); ++i) {
+    if (!(demangle(names[i]) == builtins[i].descriptor))
+      ++mismatches;
+  }
+  reportCount(o, "round trip mismatches", mismatches, "names");
+
+  size_t ops = names.size() * input.iterations;
+  unsigned params = 0;
+  Stopwatch sw;
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 0; i < names.size(); ++i)
+      params += mangle(builtins[i].descriptor).size();
+  }
+  report(o, "mangle (reference)", sw.elapsed(), ops);
+
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 0; i < names.size(); ++i)
+      params += demangle(names[i]).parameters.size();
+  }
+  report(o, "demangle to FunctionDescriptor", sw.elapsed(), ops);
+
+  sw.reset();
+  DemangledName dn;
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 0; i < names.size(); ++i) {
+      if (demangle(names[i], dn))
+        params += dn.numParameters;
+    }
+  }
+  report(o, "demangle to DemangledName view", sw.elapsed(), ops);
+
+  sw.reset();
+  RecognizedName rn;
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 0; i < names.size(); ++i) {
+      if (recognize(names[i], rn))
+        params += rn.numParameters;
+    }
+  }
+  report(o, "recognize", sw.elapsed(), ops);
+  // Keep the loops from being optimized away.
+  if (!params)
+    o << "  (no parameters)\n";
+}
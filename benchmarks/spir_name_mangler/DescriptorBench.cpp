@@ -0,0 +1,77 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/FunctionDescriptor.h"
+
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+namespace {
+
+// A descriptor with the parameters in a std::vector, as TypeVector used to
+// be, for comparison.
+struct HeapDescriptor {
+  std::string name;
+  std::vector<RefParamType> parameters;
+};
+
+// Constructs, copies and destroys one descriptor of type D per overload.
+template <typename D>
+void measure(const BenchInput& input, raw_ostream& o, const char* construct,
+             const char* copy, const char* destroy, const char* allocs) {
+  const BuiltinDeclarationList& builtins = input.builtins32;
+  size_t ops = builtins.size() * input.iterations;
+  double tConstruct = 0, tCopy = 0, tDestroy = 0;
+  size_t allocCount = 0;
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    std::vector<D>* fds = new std::vector<D>(builtins.size());
+    std::vector<D>* copies = new std::vector<D>(builtins.size());
+    // Only the allocations of the descriptors are counted, not the ones of
+    // the vectors holding them.
+    size_t allocsBefore = getAllocationCount();
+    Stopwatch sw;
+    for (unsigned i = 0; i < builtins.size(); ++i) {
+      const FunctionDescriptor& src = builtins[i].descriptor;
+      D& fd = (*fds)[i];
+      fd.name = src.name;
+      for (unsigned j = 0; j < src.parameters.size(); ++j)
+        fd.parameters.push_back(src.parameters[j]);
+    }
+    tConstruct += sw.elapsed();
+    sw.reset();
+    for (unsigned i = 0; i < builtins.size(); ++i)
+      (*copies)[i] = (*fds)[i];
+    tCopy += sw.elapsed();
+    allocCount += getAllocationCount() - allocsBefore;
+    sw.reset();
+    delete fds;
+    delete copies;
+    tDestroy += sw.elapsed();
+  }
+  report(o, construct, tConstruct, ops);
+  report(o, copy, tCopy, ops);
+  report(o, destroy, tDestroy, 2 * ops);
+  reportCount(o, allocs, allocCount / input.iterations, "allocs");
+}
+
+} // End anonymous namespace
+
+// Builds, copies and destroys a descriptor for each overload of
+// opencl_spir.h, with inline parameter storage and with std::vector.
+SPIR_BENCHMARK(Descriptor)(const BenchInput& input, raw_ostream& o) {
+  measure<HeapDescriptor>(input, o, "std::vector: construct",
+    "std::vector: copy", "std::vector: destroy",
+    "std::vector: allocations per iteration");
+  measure<FunctionDescriptor>(input, o, "TypeVector: construct",
+    "TypeVector: copy", "TypeVector: destroy",
+    "TypeVector: allocations per iteration");
+}
@@ -0,0 +1,96 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/GentypeFamily.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "llvm/ADT/SmallString.h"
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+// Returns the bytes of the ParamType nodes of a type (not counting the
+// allocator's overhead).
+static size_t getTypeBytes(const ParamType* type) {
+  if (const PointerType* p = dyn_cast<PointerType>(type))
+    return sizeof(PointerType) + getTypeBytes(p->getPointee());
+  if (const VectorType* v = dyn_cast<VectorType>(type))
+    return sizeof(VectorType) + getTypeBytes(v->getScalarType());
+  return sizeof(PrimitiveType);
+}
+
+// Compares the built-ins of opencl_spir.h held as declarations (a ParamType
+// tree per type) with the same built-ins grouped in gentype families, which
+// build the types of an overload only when asked.
+SPIR_BENCHMARK(GentypeFamily)(const BenchInput& input, raw_ostream& o) {
+  const BuiltinDeclarationList& builtins = input.builtins32;
+  size_t treeBytes = 0;
+  for (unsigned i = 0; i < builtins.size(); ++i) {
+    const BuiltinDeclaration& decl = builtins[i];
+    treeBytes += sizeof(decl) + decl.descriptor.name.capacity() +
+      getTypeBytes(decl.returnType);
+    for (unsigned p = 0; p < decl.descriptor.parameters.size(); ++p)
+      treeBytes += sizeof(RefParamType) +
+        getTypeBytes(decl.descriptor.parameters[p]);
+  }
+  reportCount(o, "declarations", builtins.size(), "overloads");
+  reportCount(o, "declaration list, at least", treeBytes, "bytes");
+
+  Stopwatch sw;
+  GentypeFamilySet set;
+  set.build(builtins);
+  report(o, "family construction", sw.elapsed(), 1);
+  reportCount(o, "families", set.size(), "families");
+  reportCount(o, "family overloads", set.getNumOverloads(), "overloads");
+  reportCount(o, "family set", set.getMemorySize(), "bytes");
+
+  SmallString<128> name;
+  size_t length = 0;
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 0; i < builtins.size(); ++i) {
+      name.clear();
+      mangle(builtins[i].descriptor, name);
+      length += name.size();
+    }
+  }
+  report(o, "mangle declarations", sw.elapsed(),
+         builtins.size() * input.iterations);
+
+  size_t allocations = getAllocationCount();
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned f = 0; f < set.size(); ++f) {
+      GentypeFamily family = set[f];
+      for (unsigned i = 0; i < family.size(); ++i) {
+        name.clear();
+        family.mangle(i, name);
+        length -= name.size();
+      }
+    }
+  }
+  report(o, "enumerate and mangle families", sw.elapsed(),
+         set.getNumOverloads() * input.iterations);
+  reportCount(o, "allocations", getAllocationCount() - allocations,
+              "allocs");
+
+  allocations = getAllocationCount();
+  sw.reset();
+  for (unsigned f = 0; f < set.size(); ++f) {
+    GentypeFamily family = set[f];
+    for (unsigned i = 0; i < family.size(); ++i)
+      length += family.getDescriptor(i).parameters.size();
+  }
+  report(o, "expand families to descriptors", sw.elapsed(),
+         set.getNumOverloads());
+  reportCount(o, "allocations", getAllocationCount() - allocations,
+              "allocs");
+  // Keep the loops from being optimized away.
+  if (length == 1)
+    o << "  (one character)\n";
+}
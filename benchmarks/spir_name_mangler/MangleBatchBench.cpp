@@ -0,0 +1,66 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/MangleBatch.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "llvm/ADT/SmallString.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+// Mangles all overloads of opencl_spir.h into a table of names, one call at
+// a time and as a batch.
+SPIR_BENCHMARK(MangleBatch)(const BenchInput& input, raw_ostream& o) {
+  const BuiltinDeclarationList& builtins = input.builtins32;
+  std::vector<FunctionDescriptor> fds;
+  fds.reserve(builtins.size());
+  for (unsigned i = 0; i < builtins.size(); ++i)
+    fds.push_back(builtins[i].descriptor);
+  size_t ops = fds.size() * input.iterations;
+  size_t chars = 0;
+
+  Stopwatch sw;
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    // What callers do today: mangle each name into a shared pool.
+    std::string pool;
+    std::vector<size_t> offsets;
+    offsets.reserve(fds.size() + 1);
+    SmallString<128> buffer;
+    for (unsigned i = 0; i < fds.size(); ++i) {
+      buffer.clear();
+      mangle(fds[i], buffer);
+      offsets.push_back(pool.size());
+      pool.append(buffer.data(), buffer.size());
+    }
+    offsets.push_back(pool.size());
+    chars += pool.size();
+  }
+  report(o, "mangle, one at a time", sw.elapsed(), ops);
+
+  unsigned hardwareThreads = std::thread::hardware_concurrency();
+  unsigned threads[] = { 1, 4, hardwareThreads };
+  for (unsigned t = 0; t < 3; ++t) {
+    MangledNameTable table;
+    sw.reset();
+    for (unsigned it = 0; it < input.iterations; ++it) {
+      mangleBatch(fds, table, threads[t]);
+      chars += table.getPool().size();
+    }
+    std::string label = "mangleBatch, " + std::to_string(threads[t]) +
+      " thread(s)";
+    report(o, label.c_str(), sw.elapsed(), ops);
+  }
+  // Keep the loops from being optimized away.
+  if (!chars)
+    o << "  (empty names)\n";
+}
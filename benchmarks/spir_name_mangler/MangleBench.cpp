@@ -0,0 +1,75 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "llvm/ADT/SmallString.h"
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+// Mangles and prints all overloads of opencl_spir.h, into new strings and
+// into a reused buffer.
+SPIR_BENCHMARK(Mangle)(const BenchInput& input, raw_ostream& o) {
+  const BuiltinDeclarationList& builtins = input.builtins32;
+  size_t ops = builtins.size() * input.iterations;
+  size_t chars = 0;
+
+  size_t allocs = getAllocationCount();
+  Stopwatch sw;
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 0; i < builtins.size(); ++i)
+      chars += mangle(builtins[i].descriptor).size();
+  }
+  report(o, "mangle to std::string", sw.elapsed(), ops);
+  reportCount(o, "allocations", getAllocationCount() - allocs, "allocs");
+
+  SmallString<128> buffer;
+  allocs = getAllocationCount();
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 0; i < builtins.size(); ++i) {
+      buffer.clear();
+      mangle(builtins[i].descriptor, buffer);
+      chars += buffer.size();
+    }
+  }
+  report(o, "mangle to reused buffer", sw.elapsed(), ops);
+  reportCount(o, "allocations", getAllocationCount() - allocs, "allocs");
+
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 0; i < builtins.size(); ++i)
+      chars += mangledLength(builtins[i].descriptor);
+  }
+  report(o, "mangledLength", sw.elapsed(), ops);
+
+  allocs = getAllocationCount();
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 0; i < builtins.size(); ++i)
+      chars += builtins[i].descriptor.toString().size();
+  }
+  report(o, "toString to std::string", sw.elapsed(), ops);
+  reportCount(o, "allocations", getAllocationCount() - allocs, "allocs");
+
+  allocs = getAllocationCount();
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 0; i < builtins.size(); ++i) {
+      buffer.clear();
+      builtins[i].descriptor.toString(buffer);
+      chars += buffer.size();
+    }
+  }
+  report(o, "toString to reused buffer", sw.elapsed(), ops);
+  reportCount(o, "allocations", getAllocationCount() - allocs, "allocs");
+  // Keep the loops from being optimized away.
+  if (!chars)
+    o << "  (empty names)\n";
+}
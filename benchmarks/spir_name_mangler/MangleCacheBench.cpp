@@ -0,0 +1,70 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/MangleCache.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+
+#include <thread>
+#include <vector>
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+static const unsigned NumThreads = 4;
+
+// Mangles a hot set of a few hundred overloads over and over, as a front end
+// compiling many kernels does.
+SPIR_BENCHMARK(MangleCache)(const BenchInput& input, raw_ostream& o) {
+  std::vector<FunctionDescriptor> hot;
+  const BuiltinDeclarationList& builtins = input.builtins32;
+  for (unsigned i = 0; i < builtins.size(); i += 32)
+    hot.push_back(builtins[i].descriptor);
+  reportCount(o, "hot set", hot.size(), "descriptors");
+  const unsigned rounds = 100 * input.iterations;
+  size_t ops = hot.size() * rounds;
+
+  size_t chars = 0;
+  size_t allocs = getAllocationCount();
+  Stopwatch sw;
+  for (unsigned it = 0; it < rounds; ++it)
+    for (unsigned i = 0; i < hot.size(); ++i)
+      chars += mangle(hot[i]).size();
+  report(o, "mangle", sw.elapsed(), ops);
+  reportCount(o, "allocations", getAllocationCount() - allocs, "allocs");
+
+  MangleCache cache;
+  allocs = getAllocationCount();
+  sw.reset();
+  for (unsigned it = 0; it < rounds; ++it)
+    for (unsigned i = 0; i < hot.size(); ++i)
+      chars += cache.get(hot[i]).size();
+  report(o, "MangleCache::get", sw.elapsed(), ops);
+  reportCount(o, "allocations", getAllocationCount() - allocs, "allocs");
+
+  std::vector<std::thread> threads;
+  sw.reset();
+  for (unsigned t = 0; t < NumThreads; ++t) {
+    threads.push_back(std::thread([&cache, &hot, rounds]() {
+      for (unsigned it = 0; it < rounds; ++it)
+        for (unsigned i = 0; i < hot.size(); ++i)
+          cache.get(hot[i]);
+    }));
+  }
+  for (unsigned t = 0; t < NumThreads; ++t)
+    threads[t].join();
+  report(o, "MangleCache::get, 4 threads (wall time)", sw.elapsed(),
+         ops * NumThreads);
+
+  MangleCache::Statistics stats = cache.getStatistics();
+  reportCount(o, "hits", stats.hits, "lookups");
+  reportCount(o, "misses", stats.misses, "lookups");
+  reportCount(o, "cached bytes", stats.bytes, "bytes");
+  if (!chars)
+    o << "  (empty names)\n";
+}
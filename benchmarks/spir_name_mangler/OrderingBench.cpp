@@ -0,0 +1,109 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/FunctionDescriptor.h"
+#include "llvm/ADT/DenseMap.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+// The ordering FunctionDescriptor::operator< used to implement, which
+// compares the parameters through their string representation.
+struct ToStringLess {
+  bool operator()(const FunctionDescriptor& l,
+                  const FunctionDescriptor& r) const {
+    int strCmp = l.name.compare(r.name);
+    if (strCmp)
+      return (strCmp < 0);
+    size_t len = l.parameters.size(), thatLen = r.parameters.size();
+    if (len != thatLen)
+      return len < thatLen;
+    for (size_t i = 0; i < len; ++i) {
+      int cmp = l.parameters[i]->toString().compare(
+        r.parameters[i]->toString());
+      if (cmp)
+        return (cmp < 0);
+    }
+    return false;
+  }
+};
+
+template <typename Less>
+static double sortAll(const std::vector<FunctionDescriptor>& fds,
+                      unsigned iterations, Less less) {
+  double seconds = 0;
+  for (unsigned it = 0; it < iterations; ++it) {
+    std::vector<FunctionDescriptor> sorted = fds;
+    Stopwatch sw;
+    std::sort(sorted.begin(), sorted.end(), less);
+    seconds += sw.elapsed();
+  }
+  return seconds;
+}
+
+// Sorts and indexes all overloads of opencl_spir.h with the string based
+// ordering, the structural ordering, and hash containers.
+SPIR_BENCHMARK(Ordering)(const BenchInput& input, raw_ostream& o) {
+  std::vector<FunctionDescriptor> fds;
+  for (unsigned i = 0; i < input.builtins32.size(); ++i)
+    fds.push_back(input.builtins32[i].descriptor);
+  // Start from a scrambled order.
+  std::reverse(fds.begin(), fds.end());
+  size_t ops = fds.size() * input.iterations;
+
+  report(o, "std::sort, toString ordering",
+         sortAll(fds, input.iterations, ToStringLess()), ops);
+  report(o, "std::sort, structural ordering",
+         sortAll(fds, input.iterations, std::less<FunctionDescriptor>()), ops);
+
+  std::map<FunctionDescriptor, unsigned, ToStringLess> stringMap;
+  std::map<FunctionDescriptor, unsigned> map;
+  std::unordered_map<FunctionDescriptor, unsigned> unorderedMap;
+  DenseMap<FunctionDescriptor, unsigned> denseMap;
+  for (unsigned i = 0; i < fds.size(); ++i) {
+    stringMap[fds[i]] = i;
+    map[fds[i]] = i;
+    unorderedMap[fds[i]] = i;
+    denseMap[fds[i]] = i;
+  }
+  // Some overloads are declared twice, e.g. through size_t and uint.
+  reportCount(o, "distinct overloads", map.size(), "descriptors");
+  if (stringMap.size() != map.size() || unorderedMap.size() != map.size() ||
+      denseMap.size() != map.size())
+    o << "  ERROR: containers disagree on the distinct overloads\n";
+
+  unsigned found = 0;
+  Stopwatch sw;
+  for (unsigned it = 0; it < input.iterations; ++it)
+    for (unsigned i = 0; i < fds.size(); ++i)
+      found += stringMap.count(fds[i]);
+  report(o, "std::map lookup, toString ordering", sw.elapsed(), ops);
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it)
+    for (unsigned i = 0; i < fds.size(); ++i)
+      found += map.count(fds[i]);
+  report(o, "std::map lookup, structural ordering", sw.elapsed(), ops);
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it)
+    for (unsigned i = 0; i < fds.size(); ++i)
+      found += unorderedMap.count(fds[i]);
+  report(o, "std::unordered_map lookup", sw.elapsed(), ops);
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it)
+    for (unsigned i = 0; i < fds.size(); ++i)
+      found += denseMap.count(fds[i]);
+  report(o, "DenseMap lookup", sw.elapsed(), ops);
+  if (found != 4 * ops)
+    o << "  ERROR: lookup failures\n";
+}
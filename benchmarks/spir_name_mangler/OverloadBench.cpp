@@ -0,0 +1,100 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/OverloadResolver.h"
+#include <vector>
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+// A call to a built-in.
+struct Call {
+  StringRef name;
+  std::vector<PackedType> args;
+};
+
+// Returns the index of the declaration whose parameters equal the arguments,
+// scanning all declarations (an exact match only).
+static unsigned scan(const BuiltinDeclarationList& builtins,
+                     const FunctionDescriptor& call) {
+  for (unsigned i = 0; i < builtins.size(); ++i) {
+    const FunctionDescriptor& fd = builtins[i].descriptor;
+    if (fd.name != call.name ||
+        fd.parameters.size() != call.parameters.size())
+      continue;
+    unsigned p = 0;
+    while (p < fd.parameters.size() &&
+           fd.parameters[p]->equals(call.parameters[p]))
+      ++p;
+    if (p == fd.parameters.size())
+      return i;
+  }
+  return builtins.size();
+}
+
+static void resolveCalls(const OverloadResolver& resolver,
+                         const std::vector<Call>& calls,
+                         const BenchInput& input, const char* label,
+                         raw_ostream& o) {
+  size_t found = 0;
+  Stopwatch sw;
+  for (unsigned it = 0; it < input.iterations; ++it)
+    for (unsigned i = 0; i < calls.size(); ++i)
+      found += resolver.resolve(calls[i].name, calls[i].args).isFound();
+  report(o, label, sw.elapsed(), calls.size() * input.iterations);
+  // Keep the loops from being optimized away.
+  if (found == 1)
+    o << "  (one call resolved)\n";
+}
+
+// Resolves calls to the built-ins of opencl_spir.h: with the types of the
+// parameters, and with int for every arithmetic scalar (which ranks all
+// overloads with scalar parameters). Scanning the declarations for an exact
+// match is the baseline.
+SPIR_BENCHMARK(Overload)(const BenchInput& input, raw_ostream& o) {
+  Stopwatch sw;
+  OverloadResolver resolver(false);
+  report(o, "index construction", sw.elapsed(), 1);
+
+  std::vector<Call> exact, converted;
+  for (unsigned i = 0; i < BI_NUM_BUILTINS; ++i) {
+    BuiltinID id = static_cast<BuiltinID>(i);
+    Call call;
+    call.name = getBuiltinName(id);
+    bool scalars = false;
+    for (unsigned p = 0; p < getBuiltinNumParameters(id); ++p) {
+      PackedType param = getBuiltinParameter(id, p, false);
+      if (param != PackedType::getPrimitive(PRIMITIVE_VOID))
+        call.args.push_back(param);
+    }
+    exact.push_back(call);
+    for (unsigned a = 0; a < call.args.size(); ++a) {
+      PackedType arg = call.args[a];
+      if (!arg.isPointer() && !arg.isVector() &&
+          arg.getPrimitive() <= PRIMITIVE_DOUBLE) {
+        call.args[a] = PackedType::getPrimitive(PRIMITIVE_INT);
+        scalars = true;
+      }
+    }
+    if (scalars)
+      converted.push_back(call);
+  }
+  resolveCalls(resolver, exact, input, "resolve, exact types", o);
+  resolveCalls(resolver, converted, input, "resolve, int scalars", o);
+
+  // The scan is slow, only every 64th declaration is looked for.
+  const BuiltinDeclarationList& builtins = input.builtins32;
+  size_t found = 0, ops = 0;
+  sw.reset();
+  for (unsigned i = 0; i < builtins.size(); i += 64, ++ops)
+    found += scan(builtins, builtins[i].descriptor) < builtins.size();
+  report(o, "linear scan with ParamType::equals", sw.elapsed(), ops);
+  if (found == 1)
+    o << "  (one call resolved)\n";
+}
@@ -0,0 +1,92 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/PackedType.h"
+#include "llvm/ADT/SmallString.h"
+
+#include <vector>
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+// Mangles and compares the overloads of opencl_spir.h whose parameters all
+// have a packed encoding, through ParamType and through PackedType.
+SPIR_BENCHMARK(PackedType)(const BenchInput& input, raw_ostream& o) {
+  const BuiltinDeclarationList& builtins = input.builtins32;
+  std::vector<const FunctionDescriptor*> fds;
+  std::vector<std::vector<PackedType> > packed;
+  for (unsigned i = 0; i < builtins.size(); ++i) {
+    const FunctionDescriptor& fd = builtins[i].descriptor;
+    std::vector<PackedType> params;
+    for (unsigned j = 0; j < fd.parameters.size(); ++j) {
+      PackedType t = PackedType::get(fd.parameters[j]);
+      if (!t.isValid())
+        break;
+      params.push_back(t);
+    }
+    if (params.size() != fd.parameters.size())
+      continue;
+    fds.push_back(&fd);
+    packed.push_back(params);
+  }
+  reportCount(o, "packable overloads", fds.size(), "decls");
+  reportCount(o, "other overloads", builtins.size() - fds.size(), "decls");
+
+  size_t ops = fds.size() * input.iterations;
+  size_t chars = 0;
+  SmallString<128> buffer;
+  Stopwatch sw;
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 0; i < fds.size(); ++i) {
+      buffer.clear();
+      mangle(*fds[i], buffer);
+      chars += buffer.size();
+    }
+  }
+  report(o, "ParamType: mangle", sw.elapsed(), ops);
+
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 0; i < fds.size(); ++i) {
+      buffer.clear();
+      mangle(fds[i]->name, packed[i], buffer);
+      chars += buffer.size();
+    }
+  }
+  report(o, "PackedType: mangle", sw.elapsed(), ops);
+
+  // Compares the parameters of each overload with those of the next one,
+  // as overload lookups do.
+  size_t equal = 0;
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 1; i < fds.size(); ++i) {
+      const TypeVector& l = fds[i - 1]->parameters;
+      const TypeVector& r = fds[i]->parameters;
+      for (unsigned j = 0; j < l.size() && j < r.size(); ++j)
+        equal += l[j]->equals(r[j]);
+    }
+  }
+  report(o, "ParamType: compare parameters", sw.elapsed(), ops);
+
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    for (unsigned i = 1; i < fds.size(); ++i) {
+      const std::vector<PackedType>& l = packed[i - 1];
+      const std::vector<PackedType>& r = packed[i];
+      for (unsigned j = 0; j < l.size() && j < r.size(); ++j)
+        equal += l[j] == r[j];
+    }
+  }
+  report(o, "PackedType: compare parameters", sw.elapsed(), ops);
+  // Keep the loops from being optimized away.
+  if (!chars || !equal)
+    o << "  (empty names)\n";
+}
@@ -0,0 +1,50 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+// Counts the heap allocations needed to build, copy and demangle the
+// descriptors of all opencl_spir.h overloads.
+SPIR_BENCHMARK(RefCount)(const BenchInput& input, raw_ostream& o) {
+  size_t allocs = getAllocationCount();
+  Stopwatch sw;
+  BuiltinDeclarationList builtins;
+  parseBuiltinHeader(input.header, true, builtins);
+  report(o, "parse all overloads", sw.elapsed(), builtins.size());
+  reportCount(o, "allocations", getAllocationCount() - allocs, "allocs");
+
+  std::vector<std::string> names;
+  for (unsigned i = 0; i < builtins.size(); ++i)
+    names.push_back(mangle(builtins[i].descriptor));
+
+  allocs = getAllocationCount();
+  sw.reset();
+  std::vector<FunctionDescriptor> descriptors;
+  for (unsigned i = 0; i < names.size(); ++i)
+    descriptors.push_back(demangle(names[i]));
+  report(o, "demangle all overloads", sw.elapsed(), names.size());
+  reportCount(o, "allocations", getAllocationCount() - allocs, "allocs");
+
+  allocs = getAllocationCount();
+  sw.reset();
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    std::vector<FunctionDescriptor> copies = descriptors;
+    copies.push_back(FunctionDescriptor());
+  }
+  report(o, "copy all descriptors", sw.elapsed(),
+         descriptors.size() * input.iterations);
+  reportCount(o, "allocations per copy",
+              (getAllocationCount() - allocs) / input.iterations, "allocs");
+}
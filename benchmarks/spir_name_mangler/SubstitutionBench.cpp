@@ -0,0 +1,62 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "llvm/ADT/SmallString.h"
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+// Returns the size of a string table holding the names of all overloads
+// (each terminated by a NUL), as in a bitcode or object file.
+static size_t getSymbolTableSize(const BuiltinDeclarationList& builtins,
+                                 ManglingMode mode) {
+  size_t bytes = 0;
+  for (unsigned i = 0; i < builtins.size(); ++i)
+    bytes += mangledLength(builtins[i].descriptor, mode) + 1;
+  return bytes;
+}
+
+// Compares the symbol table size of opencl_spir.h with and without
+// substitutions, and the cost of mangling with them.
+SPIR_BENCHMARK(Substitution)(const BenchInput& input, raw_ostream& o) {
+  reportCount(o, "SPIR symbol table, full",
+    getSymbolTableSize(input.builtins32, MANGLING_DEFAULT), "bytes");
+  reportCount(o, "SPIR symbol table, substitutions",
+    getSymbolTableSize(input.builtins32, MANGLING_SUBSTITUTIONS), "bytes");
+  reportCount(o, "SPIR64 symbol table, full",
+    getSymbolTableSize(input.builtins64, MANGLING_DEFAULT), "bytes");
+  reportCount(o, "SPIR64 symbol table, substitutions",
+    getSymbolTableSize(input.builtins64, MANGLING_SUBSTITUTIONS), "bytes");
+
+  const BuiltinDeclarationList& builtins = input.builtins32;
+  size_t ops = builtins.size() * input.iterations;
+  size_t chars = 0;
+  SmallString<128> buffer;
+  static const ManglingMode modes[] = {
+    MANGLING_DEFAULT, MANGLING_SUBSTITUTIONS
+  };
+  static const char* labels[] = {
+    "mangle, full", "mangle, substitutions"
+  };
+  for (unsigned m = 0; m < 2; ++m) {
+    Stopwatch sw;
+    for (unsigned it = 0; it < input.iterations; ++it) {
+      for (unsigned i = 0; i < builtins.size(); ++i) {
+        buffer.clear();
+        mangle(builtins[i].descriptor, modes[m], buffer);
+        chars += buffer.size();
+      }
+    }
+    report(o, labels[m], sw.elapsed(), ops);
+  }
+  // Keep the loops from being optimized away.
+  if (!chars)
+    o << "  (empty names)\n";
+}
@@ -0,0 +1,100 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/TypeArena.h"
+#include "llvm/Support/Process.h"
+
+#include <vector>
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+// Deep copy of a type, on the heap.
+static RefParamType cloneOnHeap(const ParamType* type) {
+  if (const PrimitiveType* p = dyn_cast<PrimitiveType>(type))
+    return new PrimitiveType(p->getPrimitive());
+  if (const VectorType* v = dyn_cast<VectorType>(type))
+    return new VectorType(cloneOnHeap(v->getScalarType()), v->getLength());
+  if (const PointerType* p = dyn_cast<PointerType>(type)) {
+    PointerType* copy = new PointerType(cloneOnHeap(p->getPointee()));
+    copy->setAddressSpace(p->getAddressSpace());
+    for (unsigned i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
+      TypeAttributeEnum qual = (TypeAttributeEnum)i;
+      copy->setQualifier(qual, p->hasQualifier(qual));
+    }
+    return copy;
+  }
+  return new UserDefinedType(dyn_cast<UserDefinedType>(type)->getName());
+}
+
+// Builds the parameter types of all overloads on the heap and in an arena,
+// then tears them down.
+SPIR_BENCHMARK(TypeArena)(const BenchInput& input, raw_ostream& o) {
+  const BuiltinDeclarationList& builtins = input.builtins64;
+  double build = 0, destroy = 0;
+  size_t allocs = 0, memory = 0;
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    std::vector<FunctionDescriptor>* fds = new std::vector<FunctionDescriptor>;
+    fds->reserve(builtins.size());
+    size_t allocsBefore = getAllocationCount();
+    size_t memoryBefore = sys::Process::GetMallocUsage();
+    Stopwatch sw;
+    for (unsigned i = 0; i < builtins.size(); ++i) {
+      const FunctionDescriptor& src = builtins[i].descriptor;
+      fds->push_back(FunctionDescriptor(src.name));
+      TypeVector& params = fds->back().parameters;
+      params.reserve(src.parameters.size());
+      for (unsigned j = 0; j < src.parameters.size(); ++j)
+        params.push_back(cloneOnHeap(src.parameters[j]));
+    }
+    build += sw.elapsed();
+    memory = sys::Process::GetMallocUsage() - memoryBefore;
+    allocs = getAllocationCount() - allocsBefore;
+    sw.reset();
+    delete fds;
+    destroy += sw.elapsed();
+  }
+  report(o, "heap: build all descriptors", build, builtins.size() *
+         input.iterations);
+  reportCount(o, "heap: allocations", allocs, "allocs");
+  reportCount(o, "heap: memory in use", memory, "bytes");
+  report(o, "heap: destroy all descriptors", destroy, builtins.size() *
+         input.iterations);
+
+  build = destroy = 0;
+  for (unsigned it = 0; it < input.iterations; ++it) {
+    std::vector<FunctionDescriptor>* fds = new std::vector<FunctionDescriptor>;
+    fds->reserve(builtins.size());
+    size_t allocsBefore = getAllocationCount();
+    size_t memoryBefore = sys::Process::GetMallocUsage();
+    Stopwatch sw;
+    TypeArena* arena = new TypeArena;
+    for (unsigned i = 0; i < builtins.size(); ++i) {
+      const FunctionDescriptor& src = builtins[i].descriptor;
+      fds->push_back(FunctionDescriptor(src.name));
+      TypeVector& params = fds->back().parameters;
+      params.reserve(src.parameters.size());
+      for (unsigned j = 0; j < src.parameters.size(); ++j)
+        params.push_back(arena->clone(src.parameters[j]));
+    }
+    build += sw.elapsed();
+    memory = sys::Process::GetMallocUsage() - memoryBefore;
+    allocs = getAllocationCount() - allocsBefore;
+    sw.reset();
+    delete fds;
+    delete arena;
+    destroy += sw.elapsed();
+  }
+  report(o, "arena: build all descriptors", build, builtins.size() *
+         input.iterations);
+  reportCount(o, "arena: allocations", allocs, "allocs");
+  reportCount(o, "arena: memory in use", memory, "bytes");
+  report(o, "arena: destroy all descriptors", destroy, builtins.size() *
+         input.iterations);
+}
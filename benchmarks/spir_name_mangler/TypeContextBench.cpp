@@ -0,0 +1,80 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "Bench.h"
+#include "spir_name_mangler/TypeContext.h"
+
+#include <set>
+
+using namespace llvm;
+using namespace SPIR;
+using namespace SPIR::bench;
+
+// Collects the distinct nodes reachable from the given type.
+static void collectNodes(const ParamType* type, std::set<const ParamType*>& s) {
+  if (!s.insert(type).second)
+    return;
+  if (const VectorType* v = dyn_cast<VectorType>(type))
+    collectNodes(v->getScalarType(), s);
+  else if (const PointerType* p = dyn_cast<PointerType>(type))
+    collectNodes(p->getPointee(), s);
+}
+
+static size_t countNodes(const BuiltinDeclarationList& builtins) {
+  std::set<const ParamType*> nodes;
+  for (unsigned i = 0; i < builtins.size(); ++i) {
+    const TypeVector& params = builtins[i].descriptor.parameters;
+    for (unsigned j = 0; j < params.size(); ++j)
+      collectNodes(params[j], nodes);
+  }
+  return nodes.size();
+}
+
+// Compares every overload with its successor (mostly the same name with
+// other parameter types) and with itself.
+static unsigned compareAll(const BuiltinDeclarationList& builtins,
+                           const BuiltinDeclarationList& copies,
+                           unsigned iterations) {
+  unsigned equal = 0;
+  for (unsigned it = 0; it < iterations; ++it) {
+    for (unsigned i = 1; i < builtins.size(); ++i) {
+      equal += builtins[i].descriptor == copies[i].descriptor;
+      equal += builtins[i].descriptor == copies[i - 1].descriptor;
+    }
+  }
+  return equal;
+}
+
+// Uniques the parameters of all overloads, and compares the memory footprint
+// and descriptor comparison time with the freshly parsed ones.
+SPIR_BENCHMARK(TypeContext)(const BenchInput& input, raw_ostream& o) {
+  const BuiltinDeclarationList& builtins = input.builtins64;
+  // Separate trees, so the comparisons below do not hit identical nodes.
+  BuiltinDeclarationList copies;
+  parseBuiltinHeader(input.header, true, copies);
+  reportCount(o, "type nodes (parsed)", countNodes(builtins), "nodes");
+
+  Stopwatch sw;
+  TypeContext ctx;
+  BuiltinDeclarationList uniqued = builtins, uniquedCopies = copies;
+  for (unsigned i = 0; i < uniqued.size(); ++i) {
+    ctx.unique(uniqued[i].descriptor);
+    ctx.unique(uniquedCopies[i].descriptor);
+  }
+  report(o, "uniquing all overloads twice", sw.elapsed(), 2 * uniqued.size());
+  reportCount(o, "type nodes (uniqued)", ctx.size(), "nodes");
+
+  size_t ops = 2 * (builtins.size() - 1) * input.iterations;
+  sw.reset();
+  unsigned equal = compareAll(builtins, copies, input.iterations);
+  report(o, "FunctionDescriptor == (parsed)", sw.elapsed(), ops);
+  sw.reset();
+  unsigned uniquedEqual = compareAll(uniqued, uniquedCopies, input.iterations);
+  report(o, "FunctionDescriptor == (uniqued)", sw.elapsed(), ops);
+  if (equal != uniquedEqual)
+    o << "  ERROR: uniquing changed the result of comparisons\n";
+}
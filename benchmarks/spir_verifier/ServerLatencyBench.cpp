@@ -0,0 +1,196 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+// Compares the latency of a verification by spir_verifier -server with the
+// latency of a spir_verifier process per file.
+
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/system_error.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace llvm;
+
+static cl::list<std::string>
+InputFilenames(cl::Positional, cl::desc("<input bitcode files>"),
+    cl::OneOrMore, cl::value_desc("filename"));
+
+static cl::opt<std::string>
+VerifierPath("verifier", cl::desc("The spir_verifier executable"),
+    cl::init("spir_verifier"), cl::value_desc("filename"));
+
+static cl::opt<unsigned>
+Iterations("iterations", cl::desc("Number of times each file is verified"),
+    cl::init(20));
+
+static double getWallTime() {
+  return TimeRecord::getCurrentTime(true).getWallTime();
+}
+
+/// @brief Starts the verifier with the given arguments.
+/// @param Args the arguments, after the executable.
+/// @param In if not null, receives the verifier's standard input.
+/// @param Out if not null, receives the verifier's standard output.
+/// @returns the process, or -1.
+static pid_t startVerifier(const std::vector<std::string> &Args, FILE **In,
+                           FILE **Out) {
+  int InPipe[2], OutPipe[2];
+  if (pipe(InPipe) || pipe(OutPipe))
+    return -1;
+  pid_t Pid = fork();
+  if (Pid == 0) {
+    int Null = open("/dev/null", O_RDWR);
+    dup2(In ? InPipe[0] : Null, 0);
+    dup2(Out ? OutPipe[1] : Null, 1);
+    dup2(Null, 2);
+    std::vector<char *> Argv;
+    Argv.push_back(const_cast<char *>(VerifierPath.c_str()));
+    for (unsigned i = 0; i < Args.size(); i++)
+      Argv.push_back(const_cast<char *>(Args[i].c_str()));
+    Argv.push_back(NULL);
+    execvp(Argv[0], &Argv[0]);
+    _exit(127);
+  }
+  close(InPipe[0]);
+  close(OutPipe[1]);
+  if (In)
+    *In = fdopen(InPipe[1], "w");
+  else
+    close(InPipe[1]);
+  if (Out)
+    *Out = fdopen(OutPipe[0], "r");
+  else
+    close(OutPipe[0]);
+  return Pid;
+}
+
+/// @brief Prints the median, 99th percentile and mean of the latencies.
+static void report(raw_ostream &O, const char *Label,
+                   std::vector<double> &Latencies) {
+  if (Latencies.empty())
+    return;
+  std::sort(Latencies.begin(), Latencies.end());
+  double Sum = 0;
+  for (unsigned i = 0; i < Latencies.size(); i++)
+    Sum += Latencies[i];
+  size_t P99 = std::min(Latencies.size() - 1, Latencies.size() * 99 / 100);
+  O << "  " << left_justify(Label, 32)
+    << format("p50 %9.3f ms", Latencies[Latencies.size() / 2] * 1e3)
+    << format("  p99 %9.3f ms", Latencies[P99] * 1e3)
+    << format("  mean %9.3f ms", Sum / Latencies.size() * 1e3) << "\n";
+}
+
+/// @brief Measures a spir_verifier process per file.
+static bool measureProcesses(std::vector<double> &Latencies) {
+  for (unsigned it = 0; it < Iterations; it++) {
+    for (unsigned i = 0; i < InputFilenames.size(); i++) {
+      double Start = getWallTime();
+      pid_t Pid = startVerifier(
+        std::vector<std::string>(1, InputFilenames[i]), NULL, NULL);
+      int Status;
+      if (Pid < 0 || waitpid(Pid, &Status, 0) != Pid ||
+          !WIFEXITED(Status) || WEXITSTATUS(Status) == 127)
+        return false;
+      Latencies.push_back(getWallTime() - Start);
+    }
+  }
+  return true;
+}
+
+/// @brief Measures the requests to a spir_verifier -server, sent one at a
+///        time.
+/// @param Bitcode if true, the files are sent as bitcode requests, else as
+///        file requests.
+static bool measureServer(const std::vector<std::string> &Contents,
+                          bool Bitcode, std::vector<double> &Latencies) {
+  FILE *In, *Out;
+  pid_t Pid = startVerifier(std::vector<std::string>(1, "-server"), &In,
+                            &Out);
+  if (Pid < 0)
+    return false;
+  bool Ok = true;
+  std::vector<char> Report;
+  for (unsigned it = 0; Ok && it < Iterations; it++) {
+    for (unsigned i = 0; Ok && i < InputFilenames.size(); i++) {
+      double Start = getWallTime();
+      if (Bitcode) {
+        fprintf(In, "bitcode %u\n", (unsigned)Contents[i].size());
+        fwrite(Contents[i].data(), 1, Contents[i].size(), In);
+      } else {
+        fprintf(In, "file %s\n", InputFilenames[i].c_str());
+      }
+      fflush(In);
+
+      char Verdict[32];
+      unsigned Size;
+      if (fscanf(Out, "%31s %u", Verdict, &Size) != 2 || fgetc(Out) != '\n') {
+        Ok = false;
+        break;
+      }
+      Report.resize(Size + 1);
+      if (fread(&Report[0], 1, Size, Out) != Size)
+        Ok = false;
+      Latencies.push_back(getWallTime() - Start);
+    }
+  }
+  fclose(In);
+  fclose(Out);
+  int Status;
+  waitpid(Pid, &Status, 0);
+  return Ok;
+}
+
+int main(int argc, const char *argv[]) {
+  cl::ParseCommandLineOptions(argc, argv,
+    "spir_verifier -server latency benchmark");
+  // A verifier which died is reported, rather than ending the benchmark.
+  signal(SIGPIPE, SIG_IGN);
+
+  std::vector<std::string> Contents;
+  for (unsigned i = 0; i < InputFilenames.size(); i++) {
+    OwningPtr<MemoryBuffer> File;
+    error_code ErrCode = MemoryBuffer::getFile(InputFilenames[i], File);
+    if (!File.get()) {
+      errs() << "Cannot read " << InputFilenames[i] << ": "
+             << ErrCode.message() << "\n";
+      return 1;
+    }
+    Contents.push_back(File->getBuffer().str());
+  }
+
+  outs() << "Verifying " << InputFilenames.size() << " files "
+         << Iterations << " times:\n";
+  std::vector<double> Latencies;
+  if (!measureProcesses(Latencies)) {
+    errs() << "Cannot run " << VerifierPath << "\n";
+    return 1;
+  }
+  report(outs(), "process per file", Latencies);
+
+  for (unsigned Bitcode = 0; Bitcode < 2; Bitcode++) {
+    Latencies.clear();
+    if (!measureServer(Contents, Bitcode, Latencies)) {
+      errs() << "Unexpected answer from " << VerifierPath << " -server\n";
+      return 1;
+    }
+    report(outs(), Bitcode ? "server, bitcode requests" :
+                             "server, file requests", Latencies);
+  }
+  return 0;
+}
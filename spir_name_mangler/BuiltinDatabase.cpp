@@ -0,0 +1,383 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "BuiltinDatabase.h"
+#include "BuiltinHash.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/system_error.h"
+#include <assert.h>
+#include <string.h>
+
+namespace SPIR {
+
+  /// Sections start at multiples of this.
+  static const uint32_t SectionAlignment = 8;
+  /// Distance between a SPIR section and the same SPIR64 section.
+  static const unsigned WidthSections =
+    BDB_RETURN_TYPES_64 - BDB_RETURN_TYPES_32;
+
+  static llvm::StringRef toBytes(llvm::ArrayRef<uint32_t> a) {
+    return llvm::StringRef(reinterpret_cast<const char*>(a.data()),
+                           a.size() * sizeof(uint32_t));
+  }
+
+  /// @brief Returns the contents of a section.
+  static llvm::StringRef getSection(const BuiltinDatabaseTables& tables,
+                                    unsigned section) {
+    const BuiltinDatabaseTables::Signatures* sigs = tables.signatures;
+    if (section >= BDB_RETURN_TYPES_64 && section < BDB_HASH_DISPLACEMENTS) {
+      ++sigs;
+      section -= WidthSections;
+    }
+    switch (section) {
+    case BDB_FAMILY_NAMES:            return tables.familyNames;
+    case BDB_FAMILY_NAME_OFFSETS:     return toBytes(tables.familyNameOffsets);
+    case BDB_FAMILIES:                return toBytes(tables.families);
+    case BDB_ATTRIBUTES:              return toBytes(tables.attributes);
+    case BDB_NUM_PARAMETERS:          return toBytes(tables.numParameters);
+    case BDB_RETURN_TYPES_32:         return toBytes(sigs->returnTypes);
+    case BDB_FIRST_PARAMETERS_32:     return toBytes(sigs->firstParameters);
+    case BDB_PARAMETERS_32:           return toBytes(sigs->parameters);
+    case BDB_MANGLED_NAMES_32:        return sigs->mangledNames;
+    case BDB_MANGLED_NAME_OFFSETS_32: return toBytes(sigs->mangledNameOffsets);
+    case BDB_HASH_DISPLACEMENTS:      return toBytes(tables.hashDisplacements);
+    case BDB_HASH_SLOTS:              return toBytes(tables.hashSlots);
+    }
+    assert(false && "unknown section");
+    return llvm::StringRef();
+  }
+
+  static uint32_t alignSection(uint32_t offset) {
+    return (offset + SectionAlignment - 1) & ~(SectionAlignment - 1);
+  }
+
+  void writeBuiltinDatabase(const BuiltinDatabaseTables& tables,
+                            llvm::raw_ostream& o) {
+    unsigned numBuiltins = tables.families.size();
+    assert(tables.attributes.size() == numBuiltins &&
+           tables.numParameters.size() == numBuiltins &&
+           tables.hashSlots.size() >= numBuiltins && "inconsistent tables");
+    BuiltinDatabaseHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BuiltinDatabaseMagic, sizeof(header.magic));
+    header.hashSeed = tables.hashSeed;
+    header.version = BuiltinDatabaseVersion;
+    header.byteOrder = BuiltinDatabaseByteOrder;
+    header.numBuiltins = numBuiltins;
+    header.numFamilies = tables.familyNameOffsets.size() - 1;
+    header.hashNumBuckets = tables.hashDisplacements.size();
+    header.hashNumSlots = tables.hashSlots.size();
+    uint32_t offset = alignSection(sizeof(header));
+    for (unsigned s = 0; s < BDB_NUM_SECTIONS; ++s) {
+      header.sections[s].offset = offset;
+      header.sections[s].size = getSection(tables, s).size();
+      offset = alignSection(offset + header.sections[s].size);
+    }
+    header.fileSize = offset;
+
+    static const char padding[SectionAlignment] = { 0 };
+    o.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint32_t written = sizeof(header);
+    for (unsigned s = 0; s < BDB_NUM_SECTIONS; ++s) {
+      o.write(padding, header.sections[s].offset - written);
+      llvm::StringRef contents = getSection(tables, s);
+      o.write(contents.data(), contents.size());
+      written = header.sections[s].offset + contents.size();
+    }
+    o.write(padding, header.fileSize - written);
+  }
+
+  //
+  // Loading
+  //
+
+  /// @brief Checks a section, a string pool when elementSize is 1, a table
+  ///        of 32 bit numbers when 4.
+  /// @param count the expected number of elements, 0 for any. It is 64 bit
+  ///        wide, so that counts derived from the header cannot wrap.
+  static bool checkSection(const BuiltinDatabaseHeader& header,
+                           unsigned section, uint32_t elementSize,
+                           uint64_t count, std::string& error) {
+    uint32_t offset = header.sections[section].offset;
+    uint32_t size = header.sections[section].size;
+    if (offset % SectionAlignment || offset > header.fileSize ||
+        size > header.fileSize - offset || size % elementSize ||
+        (count && size != count * elementSize)) {
+      error = "malformed section";
+      return false;
+    }
+    return true;
+  }
+
+  static llvm::ArrayRef<uint32_t> getTable(const char* file,
+                                           const BuiltinDatabaseHeader& header,
+                                           unsigned section) {
+    return llvm::ArrayRef<uint32_t>(
+      reinterpret_cast<const uint32_t*>(file + header.sections[section].offset),
+      header.sections[section].size / sizeof(uint32_t));
+  }
+
+  static llvm::StringRef getPool(const char* file,
+                                 const BuiltinDatabaseHeader& header,
+                                 unsigned section) {
+    return llvm::StringRef(file + header.sections[section].offset,
+                           header.sections[section].size);
+  }
+
+  /// @brief Checks that the offsets of a pool end with its size.
+  static bool checkPool(llvm::StringRef pool, llvm::ArrayRef<uint32_t> offsets,
+                        std::string& error) {
+    if (offsets.empty() || offsets.back() != pool.size() ||
+        (!pool.empty() && pool.back())) {
+      error = "malformed string pool";
+      return false;
+    }
+    return true;
+  }
+
+  /// @brief Checks that a type word is one PackedType builds: a known
+  ///        primitive, an OpenCL vector length and no stray bits.
+  static bool checkType(uint32_t bits) {
+    PackedType type = PackedType::fromBits(bits);
+    if (!type.isValid() || type.getPrimitive() > PRIMITIVE_LAST)
+      return false;
+    unsigned len = type.getLength();
+    if (len != 0 && len != 2 && len != 3 && len != 4 && len != 8 && len != 16)
+      return false;
+    PackedType rebuilt = len ? PackedType::getVector(type.getPrimitive(), len)
+                             : PackedType::getPrimitive(type.getPrimitive());
+    if (type.isPointer())
+      rebuilt = rebuilt.getPointer(type.getAddressSpace(),
+                                   type.getQualifiers());
+    return rebuilt == type;
+  }
+
+  /// @brief Checks that the family and the parameter lists of each built-in
+  ///        are within their tables, and that its types are well formed, so
+  ///        that queries need no checks.
+  static bool checkBuiltins(const BuiltinDatabaseTables& tables,
+                            std::string& error) {
+    uint32_t numFamilies = tables.familyNameOffsets.size() - 1;
+    for (unsigned id = 0; id < tables.families.size(); ++id) {
+      bool valid = tables.families[id] < numFamilies;
+      for (unsigned w = 0; valid && w < 2; ++w) {
+        const BuiltinDatabaseTables::Signatures& sigs = tables.signatures[w];
+        uint32_t first = sigs.firstParameters[id];
+        uint32_t num = tables.numParameters[id];
+        valid = (uint64_t)first + num <= sigs.parameters.size() &&
+          checkType(sigs.returnTypes[id]);
+        for (uint32_t i = 0; valid && i < num; ++i)
+          valid = checkType(sigs.parameters[first + i]);
+      }
+      if (!valid) {
+        error = "malformed built-in table";
+        return false;
+      }
+    }
+    return true;
+  }
+
+  BuiltinDatabase* BuiltinDatabase::open(llvm::StringRef path,
+                                         std::string& error) {
+    llvm::OwningPtr<llvm::MemoryBuffer> buffer;
+    // Without a NUL terminator, the file is mapped rather than read.
+    llvm::error_code ec = llvm::MemoryBuffer::getFile(path, buffer, -1,
+                                                      false);
+    if (!buffer) {
+      error = "cannot read " + path.str() + ": " + ec.message();
+      return NULL;
+    }
+    return get(buffer.take(), error);
+  }
+
+  BuiltinDatabase* BuiltinDatabase::get(llvm::MemoryBuffer* buffer,
+                                        std::string& error) {
+    // Deletes the buffer on failure.
+    llvm::OwningPtr<BuiltinDatabase> db(new BuiltinDatabase(buffer));
+    const char* file = buffer->getBufferStart();
+    size_t fileSize = buffer->getBufferSize();
+    if (fileSize < sizeof(BuiltinDatabaseHeader) ||
+        memcmp(file, BuiltinDatabaseMagic, sizeof(BuiltinDatabaseMagic))) {
+      error = "not a built-in database";
+      return NULL;
+    }
+    if (reinterpret_cast<uintptr_t>(file) % SectionAlignment) {
+      error = "misaligned built-in database";
+      return NULL;
+    }
+    const BuiltinDatabaseHeader& header =
+      *reinterpret_cast<const BuiltinDatabaseHeader*>(file);
+    if (header.version != BuiltinDatabaseVersion ||
+        header.byteOrder != BuiltinDatabaseByteOrder) {
+      error = "unsupported built-in database version or byte order";
+      return NULL;
+    }
+    if (header.fileSize != fileSize) {
+      error = "truncated built-in database";
+      return NULL;
+    }
+
+    uint32_t numBuiltins = header.numBuiltins;
+    // The slots hold the built-in ids next to the width flags.
+    if (!header.hashNumBuckets || !header.hashNumSlots ||
+        header.hashNumSlots < numBuiltins ||
+        numBuiltins > BUILTIN_SLOT_ID_MASK + 1) {
+      error = "malformed built-in database hash";
+      return NULL;
+    }
+    bool valid =
+      checkSection(header, BDB_FAMILY_NAMES, 1, 0, error) &&
+      checkSection(header, BDB_FAMILY_NAME_OFFSETS, 4,
+                   (uint64_t)header.numFamilies + 1, error) &&
+      checkSection(header, BDB_FAMILIES, 4, numBuiltins, error) &&
+      checkSection(header, BDB_ATTRIBUTES, 4, numBuiltins, error) &&
+      checkSection(header, BDB_NUM_PARAMETERS, 4, numBuiltins, error) &&
+      checkSection(header, BDB_HASH_DISPLACEMENTS, 4, header.hashNumBuckets,
+                   error) &&
+      checkSection(header, BDB_HASH_SLOTS, 4, header.hashNumSlots, error);
+    for (unsigned width = 0; valid && width <= WidthSections;
+         width += WidthSections)
+      valid =
+        checkSection(header, BDB_RETURN_TYPES_32 + width, 4, numBuiltins,
+                     error) &&
+        checkSection(header, BDB_FIRST_PARAMETERS_32 + width, 4, numBuiltins,
+                     error) &&
+        checkSection(header, BDB_PARAMETERS_32 + width, 4, 0, error) &&
+        checkSection(header, BDB_MANGLED_NAMES_32 + width, 1, 0, error) &&
+        checkSection(header, BDB_MANGLED_NAME_OFFSETS_32 + width, 4,
+                     (uint64_t)numBuiltins + 1, error);
+    if (!valid) {
+      return NULL;
+    }
+
+    BuiltinDatabaseTables& tables = db->m_tables;
+    tables.familyNames = getPool(file, header, BDB_FAMILY_NAMES);
+    tables.familyNameOffsets = getTable(file, header, BDB_FAMILY_NAME_OFFSETS);
+    tables.families = getTable(file, header, BDB_FAMILIES);
+    tables.attributes = getTable(file, header, BDB_ATTRIBUTES);
+    tables.numParameters = getTable(file, header, BDB_NUM_PARAMETERS);
+    for (unsigned w = 0; w < 2; ++w) {
+      unsigned width = w * WidthSections;
+      BuiltinDatabaseTables::Signatures& sigs = tables.signatures[w];
+      sigs.returnTypes = getTable(file, header, BDB_RETURN_TYPES_32 + width);
+      sigs.firstParameters =
+        getTable(file, header, BDB_FIRST_PARAMETERS_32 + width);
+      sigs.parameters = getTable(file, header, BDB_PARAMETERS_32 + width);
+      sigs.mangledNames = getPool(file, header, BDB_MANGLED_NAMES_32 + width);
+      sigs.mangledNameOffsets =
+        getTable(file, header, BDB_MANGLED_NAME_OFFSETS_32 + width);
+      if (!checkPool(sigs.mangledNames, sigs.mangledNameOffsets, error)) {
+        return NULL;
+      }
+    }
+    tables.hashSeed = header.hashSeed;
+    tables.hashDisplacements = getTable(file, header, BDB_HASH_DISPLACEMENTS);
+    tables.hashSlots = getTable(file, header, BDB_HASH_SLOTS);
+    if (!checkPool(tables.familyNames, tables.familyNameOffsets, error) ||
+        !checkBuiltins(tables, error)) {
+      return NULL;
+    }
+    return db.take();
+  }
+
+  const unsigned BuiltinDatabase::NOT_FOUND;
+
+  BuiltinDatabase::BuiltinDatabase(llvm::MemoryBuffer* buffer)
+    : m_buffer(buffer) {
+    m_tables.hashSeed = 0;
+  }
+
+  BuiltinDatabase::~BuiltinDatabase() {
+  }
+
+  //
+  // Queries
+  //
+
+  static llvm::StringRef getPoolString(llvm::StringRef pool,
+                                       llvm::ArrayRef<uint32_t> offsets,
+                                       unsigned i) {
+    // Strings are back to back in the pool, each followed by a NUL.
+    return pool.slice(offsets[i], offsets[i + 1] - 1);
+  }
+
+  size_t BuiltinDatabase::getSize() const {
+    return m_buffer->getBufferSize();
+  }
+
+  llvm::StringRef BuiltinDatabase::getFamilyName(unsigned family) const {
+    assert(family < getNumFamilies() && "invalid built-in family");
+    return getPoolString(m_tables.familyNames, m_tables.familyNameOffsets,
+                         family);
+  }
+
+  unsigned BuiltinDatabase::getFamily(unsigned id) const {
+    assert(id < getNumBuiltins() && "invalid built-in");
+    return m_tables.families[id];
+  }
+
+  llvm::StringRef BuiltinDatabase::getName(unsigned id) const {
+    return getFamilyName(getFamily(id));
+  }
+
+  llvm::StringRef BuiltinDatabase::getMangledName(unsigned id,
+                                                  bool is64Bit) const {
+    assert(id < getNumBuiltins() && "invalid built-in");
+    const BuiltinDatabaseTables::Signatures& sigs =
+      m_tables.signatures[is64Bit];
+    return getPoolString(sigs.mangledNames, sigs.mangledNameOffsets, id);
+  }
+
+  unsigned BuiltinDatabase::getAttributes(unsigned id) const {
+    assert(id < getNumBuiltins() && "invalid built-in");
+    return m_tables.attributes[id];
+  }
+
+  unsigned BuiltinDatabase::getNumParameters(unsigned id) const {
+    assert(id < getNumBuiltins() && "invalid built-in");
+    return m_tables.numParameters[id];
+  }
+
+  PackedType BuiltinDatabase::getReturnType(unsigned id, bool is64Bit) const {
+    assert(id < getNumBuiltins() && "invalid built-in");
+    return PackedType::fromBits(m_tables.signatures[is64Bit].returnTypes[id]);
+  }
+
+  PackedType BuiltinDatabase::getParameter(unsigned id, unsigned i,
+                                           bool is64Bit) const {
+    assert(i < getNumParameters(id) && "parameter index out of range");
+    const BuiltinDatabaseTables::Signatures& sigs =
+      m_tables.signatures[is64Bit];
+    return PackedType::fromBits(sigs.parameters[sigs.firstParameters[id] + i]);
+  }
+
+  FunctionDescriptor BuiltinDatabase::getDescriptor(unsigned id,
+                                                    bool is64Bit) const {
+    FunctionDescriptor fd(getName(id).str());
+    unsigned numParameters = getNumParameters(id);
+    fd.parameters.reserve(numParameters);
+    for (unsigned i = 0; i < numParameters; ++i)
+      fd.parameters.push_back(getParameter(id, i, is64Bit).toParamType());
+    return fd;
+  }
+
+  unsigned BuiltinDatabase::lookup(llvm::StringRef mangled,
+                                   bool is64Bit) const {
+    uint64_t h = hashBuiltinName(mangled, m_tables.hashSeed);
+    uint32_t displacement = m_tables.hashDisplacements[
+      getBuiltinHashBucket(h, m_tables.hashDisplacements.size())];
+    uint32_t slot = m_tables.hashSlots[
+      getBuiltinHashSlot(h, displacement, m_tables.hashSlots.size())];
+    unsigned id = slot & BUILTIN_SLOT_ID_MASK;
+    if (!(slot & (is64Bit ? BUILTIN_SLOT_SPIR64 : BUILTIN_SLOT_SPIR32)) ||
+        id >= getNumBuiltins() || getMangledName(id, is64Bit) != mangled)
+      return NOT_FOUND;
+    return id;
+  }
+
+} // End SPIR namespace
@@ -0,0 +1,215 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __BUILTIN_DATABASE_H__
+#define __BUILTIN_DATABASE_H__
+
+#include "FunctionDescriptor.h"
+#include "PackedType.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/DataTypes.h"
+#include <string>
+
+namespace llvm {
+  class MemoryBuffer;
+  class raw_ostream;
+}
+
+namespace SPIR {
+
+  /// A built-in database is a file holding the tables of BuiltinTable.h, for
+  /// programs that load the built-ins of an OpenCL header at run time rather
+  /// than link them. spir-builtin-gen writes one next to the generated
+  /// tables (opencl_spir.bdb). It is read in place: a header, followed by
+  /// sections of 32 bit numbers and string pools, found by their offset from
+  /// the start of the file. Numbers are in the byte order of the writer.
+
+  /// The first bytes of a database file.
+  static const char BuiltinDatabaseMagic[8] = {
+    'S', 'P', 'I', 'R', 'B', 'I', 'D', 'B'
+  };
+  /// Version of the format, increased by any change to it (or to the hash
+  /// functions of BuiltinHash.h).
+  static const uint32_t BuiltinDatabaseVersion = 1;
+  /// Written as is, to tell the byte order of the file.
+  static const uint32_t BuiltinDatabaseByteOrder = 0x01020304;
+
+  /// @brief The sections of a database file.
+  enum BuiltinDatabaseSection {
+    /// Names of the families, each followed by a NUL.
+    BDB_FAMILY_NAMES,
+    /// Start of each family name, followed by the size of the pool.
+    BDB_FAMILY_NAME_OFFSETS,
+    /// Family of each built-in.
+    BDB_FAMILIES,
+    /// BuiltinAttribute mask of each built-in.
+    BDB_ATTRIBUTES,
+    /// Number of parameters of each built-in.
+    BDB_NUM_PARAMETERS,
+    /// The sections of SPIR, then the same of SPIR64. Return type (a
+    /// PackedType) of each built-in.
+    BDB_RETURN_TYPES_32,
+    /// Index of the first parameter of each built-in in BDB_PARAMETERS.
+    BDB_FIRST_PARAMETERS_32,
+    /// All parameters (PackedType), back to back.
+    BDB_PARAMETERS_32,
+    /// Mangled names, each followed by a NUL.
+    BDB_MANGLED_NAMES_32,
+    /// Start of each mangled name, followed by the size of the pool.
+    BDB_MANGLED_NAME_OFFSETS_32,
+    BDB_RETURN_TYPES_64,
+    BDB_FIRST_PARAMETERS_64,
+    BDB_PARAMETERS_64,
+    BDB_MANGLED_NAMES_64,
+    BDB_MANGLED_NAME_OFFSETS_64,
+    /// Displacement of each bucket of the hash of the mangled names.
+    BDB_HASH_DISPLACEMENTS,
+    /// The slots of the hash (see BuiltinSlotBits).
+    BDB_HASH_SLOTS,
+    BDB_NUM_SECTIONS
+  };
+
+  /// @brief The header of a database file.
+  struct BuiltinDatabaseHeader {
+    char magic[8];
+    /// Seed of the hash of the mangled names.
+    uint64_t hashSeed;
+    uint32_t version;
+    uint32_t byteOrder;
+    /// Size of the whole file.
+    uint32_t fileSize;
+    uint32_t numBuiltins;
+    uint32_t numFamilies;
+    uint32_t hashNumBuckets;
+    uint32_t hashNumSlots;
+    uint32_t reserved;
+    /// Offset and size (in bytes) of each section.
+    struct {
+      uint32_t offset;
+      uint32_t size;
+    } sections[BDB_NUM_SECTIONS];
+  };
+
+  /// @brief The tables of a database, as written by writeBuiltinDatabase()
+  ///        and read by BuiltinDatabase. Built-ins and families are
+  ///        identified by their index.
+  struct BuiltinDatabaseTables {
+    /// @brief The tables of a pointer size.
+    struct Signatures {
+      llvm::ArrayRef<uint32_t> returnTypes;
+      llvm::ArrayRef<uint32_t> firstParameters;
+      llvm::ArrayRef<uint32_t> parameters;
+      llvm::StringRef mangledNames;
+      llvm::ArrayRef<uint32_t> mangledNameOffsets;
+    };
+
+    llvm::StringRef familyNames;
+    llvm::ArrayRef<uint32_t> familyNameOffsets;
+    llvm::ArrayRef<uint32_t> families;
+    llvm::ArrayRef<uint32_t> attributes;
+    llvm::ArrayRef<uint32_t> numParameters;
+    /// SPIR, then SPIR64.
+    Signatures signatures[2];
+    uint64_t hashSeed;
+    llvm::ArrayRef<uint32_t> hashDisplacements;
+    llvm::ArrayRef<uint32_t> hashSlots;
+  };
+
+  /// @brief Writes a database file.
+  /// @param BuiltinDatabaseTables the tables, consistent with each other.
+  /// @param llvm::raw_ostream the (binary) stream to write to.
+  void writeBuiltinDatabase(const BuiltinDatabaseTables&, llvm::raw_ostream&);
+
+  /// @brief A database file, loaded in place: queries read the file's
+  ///        tables, nothing is parsed or copied. The header, the bounds of
+  ///        the sections, the indices the tables hold and the packed types
+  ///        of the signatures are checked when loading, so queries on a
+  ///        loaded database need no further checks.
+  class BuiltinDatabase {
+  public:
+    /// Returned by lookup() for names that are not built-ins.
+    static const unsigned NOT_FOUND = ~0U;
+
+    /// @brief Maps a database file.
+    /// @param llvm::StringRef the path of the file.
+    /// @param std::string receives the reason of a failure.
+    /// @return the database, NULL on failure.
+    static BuiltinDatabase* open(llvm::StringRef path, std::string& error);
+
+    /// @brief Loads a database from a buffer (8 byte aligned).
+    /// @param llvm::MemoryBuffer the buffer, owned by the database (deleted
+    ///        on failure).
+    /// @param std::string receives the reason of a failure.
+    /// @return the database, NULL on failure.
+    static BuiltinDatabase* get(llvm::MemoryBuffer*, std::string& error);
+
+    ~BuiltinDatabase();
+
+    unsigned getNumBuiltins() const {
+      return m_tables.families.size();
+    }
+
+    unsigned getNumFamilies() const {
+      return m_tables.familyNameOffsets.size() - 1;
+    }
+
+    /// @brief Returns the size of the file.
+    size_t getSize() const;
+
+    const BuiltinDatabaseTables& getTables() const {
+      return m_tables;
+    }
+
+    /// @brief Returns the name of a family, e.g. "cos".
+    llvm::StringRef getFamilyName(unsigned family) const;
+
+    /// @brief Returns the family of a built-in.
+    unsigned getFamily(unsigned id) const;
+
+    /// @brief Returns the name of a built-in (stripped).
+    llvm::StringRef getName(unsigned id) const;
+
+    /// @brief Returns the mangled name of a built-in.
+    llvm::StringRef getMangledName(unsigned id, bool is64Bit) const;
+
+    /// @brief Returns the attributes of a built-in, a mask of
+    ///        BuiltinAttribute values.
+    unsigned getAttributes(unsigned id) const;
+
+    /// @brief Returns the number of parameters of a built-in.
+    unsigned getNumParameters(unsigned id) const;
+
+    /// @brief Returns the return type of a built-in.
+    PackedType getReturnType(unsigned id, bool is64Bit) const;
+
+    /// @brief Returns a parameter type of a built-in.
+    PackedType getParameter(unsigned id, unsigned i, bool is64Bit) const;
+
+    /// @brief Builds the function descriptor of a built-in.
+    FunctionDescriptor getDescriptor(unsigned id, bool is64Bit) const;
+
+    /// @brief Finds a built-in by its mangled name, as lookupBuiltin() does.
+    /// @return the built-in, NOT_FOUND if the name is not the mangled name
+    ///         of a built-in for that pointer size.
+    unsigned lookup(llvm::StringRef mangled, bool is64Bit) const;
+
+  private:
+    explicit BuiltinDatabase(llvm::MemoryBuffer*);
+
+    BuiltinDatabase(const BuiltinDatabase&);
+    BuiltinDatabase& operator=(const BuiltinDatabase&);
+
+    llvm::OwningPtr<llvm::MemoryBuffer> m_buffer;
+    /// Views of the buffer.
+    BuiltinDatabaseTables m_tables;
+  };
+
+} // End SPIR namespace
+
+#endif //__BUILTIN_DATABASE_H__
@@ -0,0 +1,86 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "BuiltinHash.h"
+#include <algorithm>
+#include <assert.h>
+
+namespace SPIR {
+
+  /// Names per bucket, on average.
+  static const unsigned BucketSize = 4;
+  /// The seed is changed when a bucket cannot be placed with a displacement
+  /// of 16 bits, this many times at most.
+  static const unsigned MaxSeeds = 16;
+
+  /// @brief Tries to place all names with the given seed, bucket by bucket,
+  ///        largest buckets first (hash and displace).
+  static bool buildBuiltinHash(llvm::ArrayRef<llvm::StringRef> names,
+                               llvm::ArrayRef<uint32_t> values, uint64_t seed,
+                               BuiltinHashTable& table) {
+    const unsigned numSlots = names.size();
+    const unsigned numBuckets = (numSlots + BucketSize - 1) / BucketSize;
+    std::vector<uint64_t> hashes(numSlots);
+    std::vector<std::vector<unsigned> > buckets(numBuckets);
+    for (unsigned i = 0; i < numSlots; ++i) {
+      hashes[i] = hashBuiltinName(names[i], seed);
+      buckets[getBuiltinHashBucket(hashes[i], numBuckets)].push_back(i);
+    }
+    std::vector<unsigned> order(numBuckets);
+    for (unsigned b = 0; b < numBuckets; ++b)
+      order[b] = b;
+    std::stable_sort(order.begin(), order.end(),
+      [&buckets](unsigned a, unsigned b) {
+        return buckets[a].size() > buckets[b].size();
+      });
+
+    std::vector<bool> used(numSlots, false);
+    std::vector<unsigned> placed;
+    table.seed = seed;
+    table.displacements.assign(numBuckets, 0);
+    table.slots.assign(numSlots, 0);
+    for (unsigned b = 0; b < numBuckets; ++b) {
+      const std::vector<unsigned>& bucket = buckets[order[b]];
+      if (bucket.empty())
+        break;
+      uint32_t d = 0;
+      for (; d <= 0xffff; ++d) {
+        placed.clear();
+        for (unsigned k = 0; k < bucket.size(); ++k) {
+          unsigned slot = getBuiltinHashSlot(hashes[bucket[k]], d, numSlots);
+          if (used[slot] ||
+              std::find(placed.begin(), placed.end(), slot) != placed.end())
+            break;
+          placed.push_back(slot);
+        }
+        if (placed.size() == bucket.size())
+          break;
+      }
+      if (d > 0xffff)
+        return false;
+      table.displacements[order[b]] = d;
+      for (unsigned k = 0; k < bucket.size(); ++k) {
+        used[placed[k]] = true;
+        table.slots[placed[k]] = values[bucket[k]];
+      }
+    }
+    return true;
+  }
+
+  bool buildBuiltinHash(llvm::ArrayRef<llvm::StringRef> names,
+                        llvm::ArrayRef<uint32_t> values,
+                        BuiltinHashTable& table) {
+    assert(names.size() == values.size() && "a value per name");
+    if (names.empty())
+      return false;
+    for (uint64_t seed = 0; seed < MaxSeeds; ++seed)
+      if (buildBuiltinHash(names, values, seed * 0x9e3779b97f4a7c15ULL, table))
+        return true;
+    return false;
+  }
+
+} // End SPIR namespace
@@ -0,0 +1,106 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __BUILTIN_HASH_H__
+#define __BUILTIN_HASH_H__
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/DataTypes.h"
+#include <string.h>
+#include <vector>
+
+namespace SPIR {
+
+  /// The hash functions of the minimal perfect hash of the built-in names,
+  /// shared by spir-builtin-gen and lookupBuiltin(). A name hashes to a
+  /// bucket, and the displacement of the bucket (found by the generator)
+  /// moves its names to distinct slots.
+
+  /// @brief Reads 8 bytes as a little endian number, on any host.
+  inline uint64_t readBuiltinHashWord(const char* p) {
+    uint64_t w;
+    memcpy(&w, p, sizeof(w));
+    const uint16_t one = 1;
+    if (*(const unsigned char*)&one)
+      return w;
+    uint64_t swapped = 0;
+    for (unsigned i = 0; i < sizeof(w); ++i)
+      swapped |= (uint64_t)(unsigned char)p[i] << (8 * i);
+    return swapped;
+  }
+
+  /// @brief Hashes a name, eight characters at a time.
+  inline uint64_t hashBuiltinName(llvm::StringRef s, uint64_t seed) {
+    const uint64_t mul = 0xff51afd7ed558ccdULL;
+    uint64_t h = seed ^ (s.size() * 0x9e3779b97f4a7c15ULL);
+    const char* p = s.data();
+    size_t n = s.size();
+    for (; n >= 8; p += 8, n -= 8) {
+      h = (h ^ readBuiltinHashWord(p)) * mul;
+      h ^= h >> 32;
+    }
+    if (n) {
+      char tail[8] = { 0 };
+      memcpy(tail, p, n);
+      h = (h ^ readBuiltinHashWord(tail)) * mul;
+    }
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 29;
+    return h;
+  }
+
+  /// @brief Returns the bucket of a hashed name.
+  inline unsigned getBuiltinHashBucket(uint64_t h, unsigned numBuckets) {
+    return (unsigned)(h >> 32) % numBuckets;
+  }
+
+  /// @brief Returns the slot of a hashed name, given the displacement of its
+  ///        bucket.
+  inline unsigned getBuiltinHashSlot(uint64_t h, uint32_t displacement,
+                                     unsigned numSlots) {
+    uint32_t x = (uint32_t)h ^ (displacement * 0x9e3779b9U);
+    x ^= x >> 16;
+    x *= 0x85ebca6bU;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35U;
+    x ^= x >> 16;
+    return x % numSlots;
+  }
+
+  /// The slots of the hash of the mangled built-in names hold a built-in,
+  /// and the pointer sizes its name is valid for.
+  enum BuiltinSlotBits {
+    BUILTIN_SLOT_ID_MASK = 0xffff,
+    BUILTIN_SLOT_SPIR32 = 1 << 16,
+    BUILTIN_SLOT_SPIR64 = 1 << 17
+  };
+
+  /// @brief A minimal perfect hash of a set of names, see buildBuiltinHash().
+  struct BuiltinHashTable {
+    /// The seed of hashBuiltinName().
+    uint64_t seed;
+    /// The displacement of each bucket (they fit in 16 bits).
+    std::vector<uint32_t> displacements;
+    /// The value of the name in each slot.
+    std::vector<uint32_t> slots;
+  };
+
+  /// @brief Builds a minimal perfect hash of the given names: there are as
+  ///        many slots as names, and each name has its own. The hash of
+  ///        other strings leads to some slot too, users compare the name.
+  /// @param llvm::ArrayRef<llvm::StringRef> the names, all distinct.
+  /// @param llvm::ArrayRef<uint32_t> the value of each name.
+  /// @param BuiltinHashTable receives the hash.
+  /// @return false if no hash was found (for instance if names repeat).
+  bool buildBuiltinHash(llvm::ArrayRef<llvm::StringRef> names,
+                        llvm::ArrayRef<uint32_t> values, BuiltinHashTable&);
+
+} // End SPIR namespace
+
+#endif //__BUILTIN_HASH_H__
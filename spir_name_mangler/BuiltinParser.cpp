@@ -0,0 +1,261 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "BuiltinParser.h"
+#include "ManglingUtils.h"
+#include "llvm/ADT/SmallVector.h"
+#include <ctype.h>
+#include <string.h>
+#include <utility>
+
+namespace SPIR {
+
+  typedef llvm::SmallVector<llvm::StringRef, 8> TokenList;
+
+  static const char* OverloadableAttr = "__attribute__((overloadable))";
+
+  // Splits a declarator into identifiers and '*' tokens.
+  static void tokenize(llvm::StringRef s, TokenList& tokens) {
+    size_t i = 0;
+    while (i < s.size()) {
+      char c = s[i];
+      if (isspace((unsigned char)c)) {
+        ++i;
+        continue;
+      }
+      if (c == '*') {
+        tokens.push_back(s.substr(i, 1));
+        ++i;
+        continue;
+      }
+      size_t start = i;
+      while (i < s.size() && !isspace((unsigned char)s[i]) && s[i] != '*')
+        ++i;
+      tokens.push_back(s.slice(start, i));
+    }
+  }
+
+  // Maps a (non vector) OpenCL type name to its primitive enumeration.
+  static TypePrimitiveEnum getPrimitive(llvm::StringRef name, bool is64Bit) {
+    for (unsigned i = PRIMITIVE_FIRST; i <= PRIMITIVE_LAST; i++) {
+      TypePrimitiveEnum primitive = (TypePrimitiveEnum)i;
+      if (name == readablePrimitiveString(primitive))
+        return primitive;
+    }
+    if (name == "size_t" || name == "uintptr_t")
+      return is64Bit ? PRIMITIVE_ULONG : PRIMITIVE_UINT;
+    if (name == "ptrdiff_t" || name == "intptr_t")
+      return is64Bit ? PRIMITIVE_LONG : PRIMITIVE_INT;
+    if (name == "cl_mem_fence_flags")
+      return PRIMITIVE_UINT;
+    return PRIMITIVE_NONE;
+  }
+
+  // Returns the unsigned counterpart of the given integer type name.
+  static TypePrimitiveEnum getUnsignedPrimitive(llvm::StringRef name) {
+    if (name == "char")
+      return PRIMITIVE_UCHAR;
+    if (name == "short")
+      return PRIMITIVE_USHORT;
+    if (name == "int")
+      return PRIMITIVE_UINT;
+    if (name == "long")
+      return PRIMITIVE_ULONG;
+    return PRIMITIVE_NONE;
+  }
+
+  // Parses a type name such as "float", "uint4" or "image2d_t".
+  static RefParamType parseTypeName(llvm::StringRef name, bool is64Bit) {
+    TypePrimitiveEnum primitive = getPrimitive(name, is64Bit);
+    if (primitive != PRIMITIVE_NONE)
+      return RefParamType(new PrimitiveType(primitive));
+    // Vector types are named <scalar><length>.
+    size_t digits = name.find_first_of("0123456789");
+    if (digits == llvm::StringRef::npos || digits == 0)
+      return RefParamType();
+    unsigned len;
+    if (name.substr(digits).getAsInteger(10, len))
+      return RefParamType();
+    primitive = getPrimitive(name.substr(0, digits), is64Bit);
+    if (primitive == PRIMITIVE_NONE || primitive > PRIMITIVE_DOUBLE)
+      return RefParamType();
+    RefParamType scalar(new PrimitiveType(primitive));
+    return RefParamType(new VectorType(scalar, len));
+  }
+
+  static bool isAccessQualifier(llvm::StringRef tok) {
+    return tok == "__read_only" || tok == "read_only" ||
+      tok == "__write_only" || tok == "write_only" ||
+      tok == "__read_write" || tok == "read_write";
+  }
+
+  static TypeAttributeEnum getAddressSpace(llvm::StringRef tok) {
+    if (tok == "__private" || tok == "private")
+      return ATTR_PRIVATE;
+    if (tok == "__global" || tok == "global")
+      return ATTR_GLOBAL;
+    if (tok == "__constant" || tok == "constant")
+      return ATTR_CONSTANT;
+    if (tok == "__local" || tok == "local")
+      return ATTR_LOCAL;
+    return ATTR_NONE;
+  }
+
+  static TypeAttributeEnum getQualifier(llvm::StringRef tok) {
+    if (tok == "restrict" || tok == "__restrict")
+      return ATTR_RESTRICT;
+    if (tok == "volatile")
+      return ATTR_VOLATILE;
+    if (tok == "const")
+      return ATTR_CONST;
+    return ATTR_NONE;
+  }
+
+  // Parses the tokens of a parameter (or return) declaration.
+  // The trailing parameter name, if any, is ignored.
+  static RefParamType parseType(const TokenList& tokens, bool is64Bit) {
+    bool qualifiers[ATTR_QUALIFIER_LAST - ATTR_QUALIFIER_FIRST + 1] = {};
+    TypeAttributeEnum addressSpace = ATTR_PRIVATE;
+    RefParamType type;
+    unsigned pointers = 0;
+    bool isUnsigned = false;
+    for (unsigned i = 0; i < tokens.size(); ++i) {
+      llvm::StringRef tok = tokens[i];
+      if (tok == "*") {
+        if (type.isNull())
+          return RefParamType();
+        ++pointers;
+        continue;
+      }
+      // Qualifiers following a '*' apply to the parameter itself and are
+      // not part of its mangled type.
+      TypeAttributeEnum attr = getQualifier(tok);
+      if (attr != ATTR_NONE) {
+        if (!pointers)
+          qualifiers[attr - ATTR_QUALIFIER_FIRST] = true;
+        continue;
+      }
+      attr = getAddressSpace(tok);
+      if (attr != ATTR_NONE) {
+        addressSpace = attr;
+        continue;
+      }
+      if (isAccessQualifier(tok))
+        continue;
+      if (!type.isNull()) {
+        // The parameter's name.
+        continue;
+      }
+      if (tok == "unsigned") {
+        isUnsigned = true;
+        continue;
+      }
+      if (isUnsigned) {
+        TypePrimitiveEnum primitive = getUnsignedPrimitive(tok);
+        if (primitive == PRIMITIVE_NONE)
+          return RefParamType();
+        type = RefParamType(new PrimitiveType(primitive));
+        continue;
+      }
+      type = parseTypeName(tok, is64Bit);
+      if (type.isNull())
+        return RefParamType();
+    }
+    if (isUnsigned && type.isNull())
+      type = RefParamType(new PrimitiveType(PRIMITIVE_UINT));
+    // Qualifiers and address space describe the innermost pointee.
+    for (unsigned i = 0; i < pointers; ++i) {
+      PointerType* p = new PointerType(type);
+      if (i == 0) {
+        for (unsigned q = ATTR_QUALIFIER_FIRST; q <= ATTR_QUALIFIER_LAST; q++)
+          p->setQualifier((TypeAttributeEnum)q,
+                          qualifiers[q - ATTR_QUALIFIER_FIRST]);
+        p->setAddressSpace(addressSpace);
+      }
+      type = RefParamType(p);
+    }
+    return type;
+  }
+
+  RefParamType parseBuiltinType(llvm::StringRef s, bool is64Bit) {
+    TokenList tokens;
+    tokenize(s, tokens);
+    if (tokens.empty())
+      return RefParamType();
+    return parseType(tokens, is64Bit);
+  }
+
+  bool parseBuiltinDeclaration(llvm::StringRef line, bool is64Bit,
+                               BuiltinDeclaration& decl) {
+    size_t attrPos = line.find(OverloadableAttr);
+    if (attrPos == llvm::StringRef::npos)
+      return false;
+    llvm::StringRef head = line.substr(0, attrPos);
+    llvm::StringRef tail = line.substr(attrPos + strlen(OverloadableAttr));
+    size_t open = tail.find('('), close = tail.rfind(')');
+    if (open == llvm::StringRef::npos || close == llvm::StringRef::npos ||
+        close < open)
+      return false;
+
+    // Collect return type, function attributes and function name.
+    TokenList prefix, retTokens;
+    tokenize(head, prefix);
+    tokenize(tail.substr(0, open), prefix);
+    if (prefix.size() < 2)
+      return false;
+    decl = BuiltinDeclaration();
+    decl.descriptor.name = prefix.back().str();
+    for (unsigned i = 0; i < prefix.size() - 1; ++i) {
+      if (prefix[i] == "const_func")
+        decl.isConst = true;
+      else if (prefix[i] == "readonly")
+        decl.isReadOnly = true;
+      else
+        retTokens.push_back(prefix[i]);
+    }
+    decl.returnType = parseType(retTokens, is64Bit);
+    if (decl.returnType.isNull())
+      return false;
+
+    // Parse the parameter list. An empty list is mangled as 'void'.
+    llvm::StringRef params = tail.slice(open + 1, close).trim();
+    if (params.empty())
+      params = "void";
+    while (!params.empty()) {
+      std::pair<llvm::StringRef, llvm::StringRef> split = params.split(',');
+      TokenList tokens;
+      tokenize(split.first, tokens);
+      RefParamType type = parseType(tokens, is64Bit);
+      if (type.isNull())
+        return false;
+      decl.descriptor.parameters.push_back(std::move(type));
+      params = split.second;
+    }
+    return true;
+  }
+
+  unsigned parseBuiltinHeader(llvm::StringRef contents, bool is64Bit,
+                              BuiltinDeclarationList& decls) {
+    unsigned failures = 0;
+    while (!contents.empty()) {
+      std::pair<llvm::StringRef, llvm::StringRef> split = contents.split('\n');
+      llvm::StringRef line = split.first.trim();
+      contents = split.second;
+      if (line.startswith("//") ||
+          line.find(OverloadableAttr) == llvm::StringRef::npos)
+        continue;
+      BuiltinDeclaration decl;
+      if (!parseBuiltinDeclaration(line, is64Bit, decl)) {
+        ++failures;
+        continue;
+      }
+      decls.push_back(std::move(decl));
+    }
+    return failures;
+  }
+
+} // End SPIR namespace
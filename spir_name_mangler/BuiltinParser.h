@@ -0,0 +1,63 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __BUILTIN_PARSER_H__
+#define __BUILTIN_PARSER_H__
+
+#include "FunctionDescriptor.h"
+#include "ParameterType.h"
+#include "llvm/ADT/StringRef.h"
+#include <vector>
+
+namespace SPIR {
+
+  /// @brief A built-in function declaration, as found in opencl_spir.h.
+  struct BuiltinDeclaration {
+    BuiltinDeclaration() : isConst(false), isReadOnly(false) {
+    }
+
+    /// The name and parameter list of the built-in.
+    FunctionDescriptor descriptor;
+    /// The return type of the built-in.
+    RefParamType returnType;
+    /// True if the built-in is declared const_func.
+    bool isConst;
+    /// True if the built-in is declared readonly.
+    bool isReadOnly;
+  };
+
+  typedef std::vector<BuiltinDeclaration> BuiltinDeclarationList;
+
+  /// @brief Parses a single overloadable built-in declaration, such as
+  ///        "float4 const_func __attribute__((overloadable)) cos(float4 x);".
+  /// @param llvm::StringRef the declaration (one line).
+  /// @param bool true if size_t and friends should be 64 bit wide (SPIR64).
+  /// @param BuiltinDeclaration the parsed declaration.
+  /// @return true on success, false if the line is not an overloadable
+  ///         declaration or it uses an unknown type.
+  bool parseBuiltinDeclaration(llvm::StringRef, bool is64Bit,
+                               BuiltinDeclaration&);
+
+  /// @brief Parses a single OpenCL C type, such as "const float4*" or
+  ///        "__global uint*" (as found in the kernel_arg_type metadata).
+  /// @param llvm::StringRef the type.
+  /// @param bool true if size_t and friends should be 64 bit wide (SPIR64).
+  /// @return the type, or a null reference if it is not a known type.
+  RefParamType parseBuiltinType(llvm::StringRef, bool is64Bit);
+
+  /// @brief Parses all overloadable built-in declarations of an OpenCL
+  ///        header (opencl_spir.h). Commented out declarations are skipped.
+  /// @param llvm::StringRef the contents of the header.
+  /// @param bool true if size_t and friends should be 64 bit wide (SPIR64).
+  /// @param BuiltinDeclarationList the list the declarations are appended to.
+  /// @return the number of overloadable declarations that failed to parse.
+  unsigned parseBuiltinHeader(llvm::StringRef, bool is64Bit,
+                              BuiltinDeclarationList&);
+
+} // End SPIR namespace
+
+#endif //__BUILTIN_PARSER_H__
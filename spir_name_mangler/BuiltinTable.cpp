@@ -0,0 +1,103 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "BuiltinTable.h"
+#include "BuiltinHash.h"
+#include <assert.h>
+
+namespace SPIR {
+
+  // The tables, indexed by BuiltinID (see spir-builtin-gen).
+#include "BuiltinTable.inc"
+
+  static llvm::StringRef getPoolString(const char* pool,
+                                       const uint32_t* offsets, unsigned i) {
+    // Strings are back to back in the pool, each followed by a NUL.
+    return llvm::StringRef(pool + offsets[i], offsets[i + 1] - offsets[i] - 1);
+  }
+
+  BuiltinFamily getBuiltinFamily(BuiltinID id) {
+    assert(id < BI_NUM_BUILTINS && "invalid built-in");
+    return static_cast<BuiltinFamily>(BuiltinFamilies[id]);
+  }
+
+  llvm::StringRef getBuiltinFamilyName(BuiltinFamily family) {
+    assert(family < BF_NUM_FAMILIES && "invalid built-in family");
+    return getPoolString(BuiltinFamilyNames, BuiltinFamilyNameOffsets,
+                         family);
+  }
+
+  llvm::StringRef getBuiltinName(BuiltinID id) {
+    return getBuiltinFamilyName(getBuiltinFamily(id));
+  }
+
+  llvm::StringRef getBuiltinMangledName(BuiltinID id, bool is64Bit) {
+    assert(id < BI_NUM_BUILTINS && "invalid built-in");
+    return is64Bit ?
+      getPoolString(Builtin64MangledNames, Builtin64MangledNameOffsets, id) :
+      getPoolString(Builtin32MangledNames, Builtin32MangledNameOffsets, id);
+  }
+
+  unsigned getBuiltinAttributes(BuiltinID id) {
+    assert(id < BI_NUM_BUILTINS && "invalid built-in");
+    return BuiltinAttributeMasks[id];
+  }
+
+  PackedType getBuiltinReturnType(BuiltinID id, bool is64Bit) {
+    assert(id < BI_NUM_BUILTINS && "invalid built-in");
+    return PackedType::fromBits(is64Bit ? Builtin64ReturnTypes[id] :
+                                Builtin32ReturnTypes[id]);
+  }
+
+  unsigned getBuiltinNumParameters(BuiltinID id) {
+    assert(id < BI_NUM_BUILTINS && "invalid built-in");
+    return BuiltinNumParameters[id];
+  }
+
+  PackedType getBuiltinParameter(BuiltinID id, unsigned i, bool is64Bit) {
+    assert(i < getBuiltinNumParameters(id) && "parameter index out of range");
+    return PackedType::fromBits(is64Bit ?
+      Builtin64Parameters[Builtin64FirstParameters[id] + i] :
+      Builtin32Parameters[Builtin32FirstParameters[id] + i]);
+  }
+
+  FunctionDescriptor getBuiltinDescriptor(BuiltinID id, bool is64Bit) {
+    FunctionDescriptor fd(getBuiltinName(id).str());
+    unsigned numParameters = getBuiltinNumParameters(id);
+    fd.parameters.reserve(numParameters);
+    for (unsigned i = 0; i < numParameters; ++i) {
+      PackedType param = getBuiltinParameter(id, i, is64Bit);
+      fd.parameters.push_back(param.toParamType());
+    }
+    return fd;
+  }
+
+  BuiltinRecord lookupBuiltin(llvm::StringRef mangled, bool is64Bit) {
+    BuiltinRecord record;
+    record.id = BI_NUM_BUILTINS;
+    record.family = BF_NUM_FAMILIES;
+    record.attributes = 0;
+    record.numParameters = 0;
+    record.is64Bit = is64Bit;
+    uint64_t h = hashBuiltinName(mangled, BuiltinHashSeed);
+    uint32_t displacement =
+      BuiltinHashDisplacements[getBuiltinHashBucket(h, BuiltinHashNumBuckets)];
+    uint32_t slot = BuiltinHashSlots[
+      getBuiltinHashSlot(h, displacement, BuiltinHashNumSlots)];
+    // Any string has a slot, check that it is the name of the slot.
+    BuiltinID id = static_cast<BuiltinID>(slot & BUILTIN_SLOT_ID_MASK);
+    if (!(slot & (is64Bit ? BUILTIN_SLOT_SPIR64 : BUILTIN_SLOT_SPIR32)) ||
+        getBuiltinMangledName(id, is64Bit) != mangled)
+      return record;
+    record.id = id;
+    record.family = getBuiltinFamily(id);
+    record.attributes = BuiltinAttributeMasks[id];
+    record.numParameters = BuiltinNumParameters[id];
+    return record;
+  }
+
+} // End SPIR namespace
@@ -0,0 +1,109 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __BUILTIN_TABLE_H__
+#define __BUILTIN_TABLE_H__
+
+#include "FunctionDescriptor.h"
+#include "PackedType.h"
+#include "llvm/ADT/StringRef.h"
+
+namespace SPIR {
+
+  /// @brief The overloadable built-ins of opencl_spir.h, generated at build
+  ///        time by spir-builtin-gen. Each is named after its SPIR mangled
+  ///        name without the "_Z", e.g. BI_3cosf.
+  enum BuiltinID {
+#define SPIR_BUILTIN(ID) ID,
+#include "BuiltinIDs.inc"
+#undef SPIR_BUILTIN
+    BI_NUM_BUILTINS
+  };
+
+  /// @brief The names of the built-ins, each the family of its overloads,
+  ///        e.g. BF_cos.
+  enum BuiltinFamily {
+#define SPIR_BUILTIN_FAMILY(ID) ID,
+#include "BuiltinFamilies.inc"
+#undef SPIR_BUILTIN_FAMILY
+    BF_NUM_FAMILIES
+  };
+
+  /// @brief Attributes of a built-in.
+  enum BuiltinAttribute {
+    /// Declared const_func.
+    BUILTIN_CONST = 1,
+    /// Declared readonly.
+    BUILTIN_READ_ONLY = 2
+  };
+
+  /// @brief Returns the family of the built-in.
+  BuiltinFamily getBuiltinFamily(BuiltinID);
+
+  /// @brief Returns the name of the family, e.g. "cos".
+  llvm::StringRef getBuiltinFamilyName(BuiltinFamily);
+
+  /// @brief Returns the name of the built-in (stripped), e.g. "cos".
+  llvm::StringRef getBuiltinName(BuiltinID);
+
+  /// @brief Returns the mangled name of the built-in.
+  /// @param bool true for SPIR64 (size_t and friends are 64 bit wide).
+  llvm::StringRef getBuiltinMangledName(BuiltinID, bool is64Bit);
+
+  /// @brief Returns the attributes of the built-in, a mask of
+  ///        BuiltinAttribute values.
+  unsigned getBuiltinAttributes(BuiltinID);
+
+  /// @brief Returns the return type of the built-in.
+  /// @param bool true for SPIR64.
+  PackedType getBuiltinReturnType(BuiltinID, bool is64Bit);
+
+  /// @brief Returns the number of parameters of the built-in (a 'void'
+  ///        parameter for built-ins without parameters).
+  unsigned getBuiltinNumParameters(BuiltinID);
+
+  /// @brief Returns a parameter type of the built-in.
+  /// @param unsigned index of the parameter.
+  /// @param bool true for SPIR64.
+  PackedType getBuiltinParameter(BuiltinID, unsigned, bool is64Bit);
+
+  /// @brief Builds the function descriptor of the built-in.
+  /// @param bool true for SPIR64.
+  FunctionDescriptor getBuiltinDescriptor(BuiltinID, bool is64Bit);
+
+  /// @brief What lookupBuiltin() knows of a mangled name.
+  struct BuiltinRecord {
+    /// The built-in, BI_NUM_BUILTINS if the name is not one.
+    BuiltinID id;
+    BuiltinFamily family;
+    /// A mask of BuiltinAttribute values.
+    unsigned attributes;
+    unsigned numParameters;
+    bool is64Bit;
+
+    bool isValid() const {
+      return id != BI_NUM_BUILTINS;
+    }
+
+    /// @brief Returns a parameter type of the built-in.
+    PackedType getParameter(unsigned i) const {
+      return getBuiltinParameter(id, i, is64Bit);
+    }
+  };
+
+  /// @brief Finds the built-in with the given mangled name, with a minimal
+  ///        perfect hash generated by spir-builtin-gen: one hash of the name
+  ///        and one string comparison, no allocation.
+  /// @param llvm::StringRef the mangled name.
+  /// @param bool true for SPIR64.
+  /// @return the record of the built-in, invalid if the name is not the
+  ///         mangled name of a built-in for that pointer size.
+  BuiltinRecord lookupBuiltin(llvm::StringRef, bool is64Bit);
+
+} // End SPIR namespace
+
+#endif //__BUILTIN_TABLE_H__
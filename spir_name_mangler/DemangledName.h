@@ -0,0 +1,81 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __DEMANGLED_NAME_H__
+#define __DEMANGLED_NAME_H__
+
+#include "ParameterType.h"
+#include "llvm/ADT/StringRef.h"
+
+namespace SPIR {
+
+  /// @brief A single node of a demangled parameter type. Nodes borrow their
+  ///        contents from the mangled string and from their DemangledName,
+  ///        so they are only valid while both are alive.
+  struct DemangledType {
+    /// The kind of the node (primitive, pointer, vector or user defined).
+    TypeEnum typeId;
+    /// The primitive enumeration (TYPE_ID_PRIMITIVE only).
+    TypePrimitiveEnum primitive;
+    /// The length of the vector (TYPE_ID_VECTOR only).
+    unsigned length;
+    /// The address space of the pointer (TYPE_ID_POINTER only).
+    TypeAttributeEnum addressSpace;
+    /// The pointer's enabled type qualifiers (TYPE_ID_POINTER only).
+    bool qualifiers[ATTR_QUALIFIER_LAST - ATTR_QUALIFIER_FIRST + 1];
+    /// The name of the user defined type (TYPE_ID_STRUCTURE only).
+    llvm::StringRef name;
+    /// Index of the pointee/scalar node (TYPE_ID_POINTER/TYPE_ID_VECTOR only).
+    unsigned element;
+
+    /// @brief Checks if the pointer has a certain qualifier.
+    /// @param TypeAttributeEnum qual - qualifier to check.
+    /// @return true if the qualifier exists and false otherwise.
+    bool hasQualifier(TypeAttributeEnum qual) const {
+      if (qual < ATTR_QUALIFIER_FIRST || qual > ATTR_QUALIFIER_LAST) {
+        return false;
+      }
+      return qualifiers[qual - ATTR_QUALIFIER_FIRST];
+    }
+  };
+
+  /// @brief Borrowed, fixed capacity view of a demangled function name.
+  ///        Filling it performs no heap allocation.
+  struct DemangledName {
+    /// Maximal number of parameters a view can hold.
+    static const unsigned MAX_PARAMETERS = 16;
+    /// Maximal number of type nodes (all parameters together) a view can hold.
+    static const unsigned MAX_TYPES = 48;
+
+    /// The name of the function (stripped), points into the mangled string.
+    llvm::StringRef name;
+    /// Number of parameters of the function.
+    unsigned numParameters;
+    /// Index of the root type node of each parameter.
+    unsigned parameters[MAX_PARAMETERS];
+    /// Number of used type nodes.
+    unsigned numTypes;
+    /// Type nodes storage.
+    DemangledType types[MAX_TYPES];
+
+    /// @brief Returns the root type node of the given parameter.
+    const DemangledType& getParameter(unsigned i) const {
+      assert(i < numParameters && "parameter index out of range");
+      return types[parameters[i]];
+    }
+
+    /// @brief Returns the pointee/scalar node of a pointer/vector node.
+    const DemangledType& getElement(const DemangledType& t) const {
+      assert((t.typeId == TYPE_ID_POINTER || t.typeId == TYPE_ID_VECTOR) &&
+        "only pointers and vectors have an element type");
+      return types[t.element];
+    }
+  };
+
+} // End SPIR namespace
+
+#endif //__DEMANGLED_NAME_H__
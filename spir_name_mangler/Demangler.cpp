@@ -0,0 +1,332 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "NameMangleAPI.h"
+#include "FunctionDescriptor.h"
+#include "ParameterType.h"
+#include "ManglingUtils.h"
+#include <string.h>
+
+namespace SPIR {
+
+/// Names come from arbitrary bitcode, so their characters may be negative,
+/// which isdigit() does not accept.
+static bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+/// @brief Recursive descent parser for the names emitted by MangleVisitor.
+///        It fills a DemangledName in place and never allocates. Substituted
+///        types share the node of the type they refer to.
+class DemangleParser {
+public:
+
+  DemangleParser(llvm::StringRef s, DemangledName& result):
+    m_cur(s.begin()), m_end(s.end()), m_result(result), m_numCandidates(0) {
+  }
+
+  bool parse() {
+    m_result.name = llvm::StringRef();
+    m_result.numParameters = 0;
+    m_result.numTypes = 0;
+    if (!consume("_Z"))
+      return false;
+    if (!parseSourceName(m_result.name))
+      return false;
+    while (m_cur != m_end) {
+      if (m_result.numParameters == DemangledName::MAX_PARAMETERS)
+        return false;
+      unsigned index;
+      if (!parseType(index))
+        return false;
+      m_result.parameters[m_result.numParameters++] = index;
+    }
+    return true;
+  }
+
+private:
+
+  bool consume(const char* s) {
+    size_t len = strlen(s);
+    if ((size_t)(m_end - m_cur) < len || strncmp(m_cur, s, len))
+      return false;
+    m_cur += len;
+    return true;
+  }
+
+  bool parseNumber(unsigned& n) {
+    if (m_cur == m_end || !isDigit(*m_cur))
+      return false;
+    // Leading zeros are not emitted by the mangler.
+    if (*m_cur == '0')
+      return false;
+    n = 0;
+    while (m_cur != m_end && isDigit(*m_cur)) {
+      // Guard against overflow on malformed input.
+      if (n > MAX_NUMBER / 10)
+        return false;
+      n = n * 10 + (*m_cur - '0');
+      ++m_cur;
+    }
+    return true;
+  }
+
+  bool parseSourceName(llvm::StringRef& name) {
+    unsigned len;
+    if (!parseNumber(len) || (size_t)(m_end - m_cur) < len)
+      return false;
+    name = llvm::StringRef(m_cur, len);
+    m_cur += len;
+    return true;
+  }
+
+  DemangledType* newType(TypeEnum typeId, unsigned& index) {
+    if (m_result.numTypes == DemangledName::MAX_TYPES)
+      return NULL;
+    index = m_result.numTypes++;
+    DemangledType* t = &m_result.types[index];
+    t->typeId = typeId;
+    t->primitive = PRIMITIVE_NONE;
+    t->length = 0;
+    t->addressSpace = ATTR_PRIVATE;
+    for (unsigned i = 0; i <= ATTR_QUALIFIER_LAST - ATTR_QUALIFIER_FIRST; i++)
+      t->qualifiers[i] = false;
+    t->name = llvm::StringRef();
+    t->element = 0;
+    return t;
+  }
+
+  bool parsePrimitive(TypePrimitiveEnum primitive, unsigned& index) {
+    DemangledType* t = newType(TYPE_ID_PRIMITIVE, index);
+    if (!t)
+      return false;
+    t->primitive = primitive;
+    return true;
+  }
+
+  bool parseType(unsigned& index) {
+    if (m_cur == m_end)
+      return false;
+    switch (*m_cur++) {
+    case 'b': return parsePrimitive(PRIMITIVE_BOOL, index);
+    case 'h': return parsePrimitive(PRIMITIVE_UCHAR, index);
+    case 'c': return parsePrimitive(PRIMITIVE_CHAR, index);
+    case 't': return parsePrimitive(PRIMITIVE_USHORT, index);
+    case 's': return parsePrimitive(PRIMITIVE_SHORT, index);
+    case 'j': return parsePrimitive(PRIMITIVE_UINT, index);
+    case 'i': return parsePrimitive(PRIMITIVE_INT, index);
+    case 'm': return parsePrimitive(PRIMITIVE_ULONG, index);
+    case 'l': return parsePrimitive(PRIMITIVE_LONG, index);
+    case 'f': return parsePrimitive(PRIMITIVE_FLOAT, index);
+    case 'd': return parsePrimitive(PRIMITIVE_DOUBLE, index);
+    case 'v': return parsePrimitive(PRIMITIVE_VOID, index);
+    case 'z': return parsePrimitive(PRIMITIVE_VAR_ARG, index);
+    case 'D':
+      if (m_cur == m_end)
+        return false;
+      if (*m_cur == 'h') {
+        ++m_cur;
+        return parsePrimitive(PRIMITIVE_HALF, index);
+      }
+      if (*m_cur == 'v') {
+        ++m_cur;
+        return parseVector(index);
+      }
+      return false;
+    case 'P':
+      return parsePointer(index);
+    case 'S': {
+      // Qualified pointees may only be substituted right after a 'P'.
+      const Candidate* c = parseSubstitution();
+      if (!c || c->pointee)
+        return false;
+      index = c->node;
+      return true;
+    }
+    default:
+      --m_cur;
+      return parseNamedType(index);
+    }
+  }
+
+  bool parseVector(unsigned& index) {
+    unsigned len;
+    if (!parseNumber(len) || !consume("_"))
+      return false;
+    DemangledType* t = newType(TYPE_ID_VECTOR, index);
+    if (!t)
+      return false;
+    t->length = len;
+    // The node array is not reallocated, so 't' stays valid.
+    return parseType(t->element) && addCandidate(index, false);
+  }
+
+  bool parsePointer(unsigned& index) {
+    DemangledType* t = newType(TYPE_ID_POINTER, index);
+    if (!t)
+      return false;
+    if (m_cur != m_end && *m_cur == 'S') {
+      ++m_cur;
+      const Candidate* c = parseSubstitution();
+      if (!c)
+        return false;
+      if (c->pointee) {
+        // The pointee with its qualifiers, as found in an earlier pointer.
+        const DemangledType& other = m_result.types[c->node];
+        for (unsigned i = 0; i <= ATTR_QUALIFIER_LAST - ATTR_QUALIFIER_FIRST;
+             i++)
+          t->qualifiers[i] = other.qualifiers[i];
+        t->addressSpace = other.addressSpace;
+        t->element = other.element;
+      } else {
+        t->element = c->node;
+      }
+      return addCandidate(index, false);
+    }
+    // Qualifiers are emitted in enumeration order, followed by the address
+    // space (see MangleVisitor::visit(const PointerType*)).
+    bool qualified = false;
+    for (unsigned i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
+      if (consume(getMangledAttribute((TypeAttributeEnum)i))) {
+        t->qualifiers[i - ATTR_QUALIFIER_FIRST] = true;
+        qualified = true;
+      }
+    }
+    for (unsigned i = ATTR_ADDR_SPACE_FIRST; i <= ATTR_ADDR_SPACE_LAST; i++) {
+      const char* attr = getMangledAttribute((TypeAttributeEnum)i);
+      if (*attr && consume(attr)) {
+        t->addressSpace = (TypeAttributeEnum)i;
+        qualified = true;
+        break;
+      }
+    }
+    if (!parseType(t->element))
+      return false;
+    // The qualified pointee completes before the pointer.
+    if (qualified && !addCandidate(index, true))
+      return false;
+    return addCandidate(index, false);
+  }
+
+  bool parseNamedType(unsigned& index) {
+    const char* start = m_cur;
+    llvm::StringRef name;
+    if (!parseSourceName(name))
+      return false;
+    // OpenCL opaque types are mangled as structures named ocl_*.
+    llvm::StringRef mangled(start, m_cur - start);
+    for (unsigned i = PRIMITIVE_FIRST; i <= PRIMITIVE_LAST; i++) {
+      TypePrimitiveEnum primitive = (TypePrimitiveEnum)i;
+      if (mangled == mangledPrimitiveString(primitive))
+        return parsePrimitive(primitive, index) && addCandidate(index, false);
+    }
+    DemangledType* t = newType(TYPE_ID_STRUCTURE, index);
+    if (!t)
+      return false;
+    t->name = name;
+    return addCandidate(index, false);
+  }
+
+  /// @brief A type that can be substituted.
+  struct Candidate {
+    /// The type node, or the pointer node of a qualified pointee.
+    unsigned node;
+    /// True for the (qualified) pointee of the pointer node.
+    bool pointee;
+  };
+
+  bool addCandidate(unsigned node, bool pointee) {
+    if (m_numCandidates == MAX_CANDIDATES)
+      return false;
+    m_candidates[m_numCandidates].node = node;
+    m_candidates[m_numCandidates].pointee = pointee;
+    ++m_numCandidates;
+    return true;
+  }
+
+  // Parses the rest of a substitution, after the 'S': "_" for the first
+  // candidate, or a base 36 number (upper case digits) and "_" for the next.
+  const Candidate* parseSubstitution() {
+    unsigned id = 0;
+    if (m_cur != m_end && *m_cur != '_') {
+      unsigned n = 0;
+      while (m_cur != m_end && *m_cur != '_') {
+        char c = *m_cur;
+        unsigned digit;
+        if (c >= '0' && c <= '9')
+          digit = c - '0';
+        else if (c >= 'A' && c <= 'Z')
+          digit = c - 'A' + 10;
+        else
+          return NULL;
+        if (n > MAX_NUMBER / 36)
+          return NULL;
+        n = n * 36 + digit;
+        ++m_cur;
+      }
+      id = n + 1;
+    }
+    if (!consume("_") || id >= m_numCandidates)
+      return NULL;
+    return &m_candidates[id];
+  }
+
+  static const unsigned MAX_NUMBER = 0xFFFFFF;
+  /// Each type node is at most one candidate, pointers with a qualified
+  /// pointee two.
+  static const unsigned MAX_CANDIDATES = 2 * DemangledName::MAX_TYPES;
+
+  const char* m_cur;
+  const char* m_end;
+  DemangledName& m_result;
+  Candidate m_candidates[MAX_CANDIDATES];
+  unsigned m_numCandidates;
+};
+
+bool demangle(llvm::StringRef s, DemangledName& result) {
+  DemangleParser parser(s, result);
+  return parser.parse();
+}
+
+static RefParamType createParamType(const DemangledName& dn,
+                                    const DemangledType& t) {
+  switch (t.typeId) {
+  case TYPE_ID_PRIMITIVE:
+    return RefParamType(new PrimitiveType(t.primitive));
+  case TYPE_ID_VECTOR:
+    return RefParamType(
+      new VectorType(createParamType(dn, dn.getElement(t)), t.length));
+  case TYPE_ID_POINTER: {
+    PointerType* p = new PointerType(createParamType(dn, dn.getElement(t)));
+    for (unsigned i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
+      TypeAttributeEnum qual = (TypeAttributeEnum)i;
+      p->setQualifier(qual, t.hasQualifier(qual));
+    }
+    p->setAddressSpace(t.addressSpace);
+    return RefParamType(p);
+  }
+  case TYPE_ID_STRUCTURE:
+    return RefParamType(new UserDefinedType(t.name.str()));
+  }
+  assert(false && "unknown type id");
+  return RefParamType();
+}
+
+FunctionDescriptor demangle(llvm::StringRef s) {
+  DemangledName dn;
+  if (!demangle(s, dn))
+    return FunctionDescriptor::null();
+  FunctionDescriptor fd;
+  fd.name = dn.name.str();
+  fd.parameters.reserve(dn.numParameters);
+  for (unsigned i = 0; i < dn.numParameters; ++i) {
+    fd.parameters.push_back(createParamType(dn, dn.getParameter(i)));
+  }
+  return fd;
+}
+
+} // End SPIR namespace
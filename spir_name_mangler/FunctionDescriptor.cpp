@@ -7,7 +7,8 @@
 
 #include "FunctionDescriptor.h"
 #include "ParameterType.h"
-#include <sstream>
+#include "ManglingUtils.h"
+#include "llvm/ADT/SmallString.h"
 
 namespace SPIR {
 
@@ -16,19 +17,27 @@ std::string FunctionDescriptor::nullString() {
 }
 
 std::string FunctionDescriptor::toString() const {
-  std::stringstream stream;
+  llvm::SmallString<128> stream;
+  toString(stream);
+  return stream.str().str();
+}
+
+void FunctionDescriptor::toString(llvm::SmallVectorImpl<char>& out) const {
   if (isNull()) {
-    return FunctionDescriptor::nullString();
+    appendString(out, FunctionDescriptor::nullString());
+    return;
   }
-  stream << name << "(";
+  appendString(out, name);
+  out.push_back('(');
   size_t paramCount = parameters.size();
   if (paramCount > 0) {
-    for (size_t i=0 ; i<paramCount-1 ; ++i)
-      stream << parameters[i]->toString() << ", ";
-    stream << parameters[paramCount-1]->toString();
+    for (size_t i=0 ; i<paramCount-1 ; ++i) {
+      parameters[i]->toString(out);
+      appendString(out, ", ");
+    }
+    parameters[paramCount-1]->toString(out);
   }
-  stream << ")";
-  return stream.str();
+  out.push_back(')');
 }
 
 static bool equal(const TypeVector& l, const TypeVector& r) {
@@ -59,29 +68,42 @@ bool FunctionDescriptor::operator == (const FunctionDescriptor& that) const {
   return equal(parameters, that.parameters);
 }
 
-bool FunctionDescriptor::operator < (const FunctionDescriptor& that) const {
-  int strCmp = name.compare(that.name);
-  if (strCmp)
-    return (strCmp < 0);
+int FunctionDescriptor::compare(const FunctionDescriptor& that) const {
+  if (this == &that)
+    return 0;
+  if (int strCmp = name.compare(that.name))
+    return strCmp;
   size_t len = parameters.size(), thatLen = that.parameters.size();
   if (len != thatLen)
-    return len < thatLen;
+    return (len < thatLen) ? -1 : 1;
   TypeVector::const_iterator it = parameters.begin(),
   e = parameters.end(), thatit = that.parameters.begin();
   while (it != e) {
-    int cmp = (*it)->toString().compare((*thatit)->toString());
-    if (cmp)
-      return (cmp < 0);
+    if (int cmp = (*it)->compare(*thatit))
+      return cmp;
     ++thatit;
     ++it;
   }
-  return false;
+  return 0;
+}
+
+bool FunctionDescriptor::operator < (const FunctionDescriptor& that) const {
+  return compare(that) < 0;
 }
 
 bool FunctionDescriptor::isNull() const {
   return (name.empty() && parameters.empty());
 }
 
+llvm::hash_code hash_value(const FunctionDescriptor& fd) {
+  size_t hash = llvm::hash_value(fd.name);
+  TypeVector::const_iterator it = fd.parameters.begin(),
+  e = fd.parameters.end();
+  for (; it != e; ++it)
+    hash = combineHash(hash, (*it)->getHash());
+  return hash;
+}
+
 FunctionDescriptor FunctionDescriptor::null() {
   FunctionDescriptor fd;
   fd.name = "";
@@ -10,18 +10,71 @@
 
 #include "ParameterType.h"
 #include "Refcount.h"
+#include "llvm/ADT/DenseMapInfo.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/SmallVector.h"
+#include <functional>
 #include <string>
-#include <vector>
+#include <utility>
 
 namespace SPIR {
-typedef std::vector<RefCount<ParamType> > TypeVector;
+/// No OpenCL built-in takes more than five parameters, so the parameter list
+/// of a descriptor never needs a heap allocation of its own.
+typedef llvm::SmallVector<RefCount<ParamType>, 5> TypeVector;
 
 struct FunctionDescriptor {
+  FunctionDescriptor() {
+  }
+
+  /// @brief Constructor.
+  /// @param std::string name of the function (stripped).
+  /// @param TypeVector parameter list of the function.
+  explicit FunctionDescriptor(std::string n, TypeVector params = TypeVector()):
+    name(std::move(n)) {
+    parameters.swap(params);
+  }
+
+  FunctionDescriptor(const FunctionDescriptor&) = default;
+  FunctionDescriptor& operator=(const FunctionDescriptor&) = default;
+
+  /// @brief Move constructor. The SmallVector of LLVM 3.2 has no move
+  ///        constructor, so the parameters are swapped rather than copied
+  ///        (which would touch the reference count of each).
+  FunctionDescriptor(FunctionDescriptor&& other):
+    name(std::move(other.name)) {
+    parameters.swap(other.parameters);
+  }
+
+  /// @brief Move assignment, swapping the parameters like the move
+  ///        constructor. The moved from descriptor is left without any.
+  FunctionDescriptor& operator=(FunctionDescriptor&& other) {
+    name = std::move(other.name);
+    parameters.clear();
+    parameters.swap(other.parameters);
+    return *this;
+  }
+
+  /// @brief Appends a parameter of type T, constructed in place from the given
+  ///        arguments.
+  /// @return the new parameter.
+  template <typename T, typename... Args>
+  T* emplaceParameter(Args&&... args) {
+    T* type = new T(std::forward<Args>(args)...);
+    RefCount<ParamType> ref(type);
+    parameters.push_back(std::move(ref));
+    return type;
+  }
+
   /// @brief Returns a human readable string representation of the function's
   ///        prototype.
   /// @returns std::string representing the function's prototype.
   std::string toString() const;
 
+  /// @brief Appends a human readable string representation of the function's
+  ///        prototype to the given buffer.
+  /// @param llvm::SmallVectorImpl<char> buffer to append to.
+  void toString(llvm::SmallVectorImpl<char>&) const;
+
   /// The name of the function (stripped).
   std::string name;
   /// Parameter list of the function.
@@ -29,6 +82,12 @@ struct FunctionDescriptor {
 
   bool operator == (const FunctionDescriptor&) const;
 
+  /// @brief Structural three-way comparison, consistent with operator==.
+  ///        Orders by name, then number of parameters, then parameters.
+  /// @return a negative number, zero or a positive number if this descriptor
+  ///         is ordered before, equal to or after the given one.
+  int compare(const FunctionDescriptor&) const;
+
   /// @brief Enables function descriptors to serve as keys in stl maps.
   bool operator < (const FunctionDescriptor&) const;
   bool isNull() const;
@@ -44,6 +103,47 @@ std::ostream& operator<< (T& o, const SPIR::FunctionDescriptor& fd) {
   o << fd.toString();
   return o;
 }
+
+/// @brief Structural hash of a function descriptor, for use with
+///        llvm::hash_combine.
+llvm::hash_code hash_value(const FunctionDescriptor&);
 } // End SPIR namespace
 
+namespace std {
+  template <>
+  struct hash<SPIR::FunctionDescriptor> {
+    size_t operator()(const SPIR::FunctionDescriptor& fd) const {
+      return SPIR::hash_value(fd);
+    }
+  };
+} // End std namespace
+
+namespace llvm {
+  template <>
+  struct DenseMapInfo<SPIR::FunctionDescriptor> {
+    // DenseMap asks for the special keys on every probe, so they are built
+    // once. Their names start with a NUL byte, which no identifier or
+    // mangled name holds, so no real descriptor is equal to them.
+    static const SPIR::FunctionDescriptor& getEmptyKey() {
+      static const SPIR::FunctionDescriptor key(std::string("\0empty", 6));
+      return key;
+    }
+
+    static const SPIR::FunctionDescriptor& getTombstoneKey() {
+      static const SPIR::FunctionDescriptor key(
+        std::string("\0tombstone", 10));
+      return key;
+    }
+
+    static unsigned getHashValue(const SPIR::FunctionDescriptor& fd) {
+      return SPIR::hash_value(fd);
+    }
+
+    static bool isEqual(const SPIR::FunctionDescriptor& l,
+                        const SPIR::FunctionDescriptor& r) {
+      return l == r;
+    }
+  };
+} // End llvm namespace
+
 #endif //__FUNCTION_DESCRIPTOR_H__
@@ -0,0 +1,359 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "GentypeFamily.h"
+#include "BuiltinTable.h"
+#include "NameMangleAPI.h"
+#include "llvm/ADT/StringMap.h"
+#include <cassert>
+#include <map>
+#include <utility>
+
+namespace SPIR {
+
+  static bool isArithmetic(TypePrimitiveEnum primitive) {
+    return primitive <= PRIMITIVE_DOUBLE;
+  }
+
+  static unsigned countBits(uint32_t mask) {
+    unsigned n = 0;
+    for (; mask; mask &= mask - 1)
+      ++n;
+    return n;
+  }
+
+  /// @brief Returns the position of the n-th set bit of the mask.
+  static unsigned getSetBit(uint32_t mask, unsigned n) {
+    for (unsigned bit = 0; bit < 32; ++bit) {
+      if (!(mask & (1U << bit)))
+        continue;
+      if (n-- == 0)
+        return bit;
+    }
+    assert(false && "not enough set bits");
+    return 0;
+  }
+
+  PackedType TemplateType::instantiate(TypePrimitiveEnum element,
+                                       unsigned length) const {
+    if (!flags)
+      return type;
+    TypePrimitiveEnum primitive =
+      (flags & ELEMENT) ? element : type.getPrimitive();
+    unsigned len = (flags & LENGTH) ? length : type.getLength();
+    PackedType t = len ? PackedType::getVector(primitive, len) :
+                         PackedType::getPrimitive(primitive);
+    if (type.isPointer())
+      t = t.getPointer(type.getAddressSpace(), type.getQualifiers());
+    return t;
+  }
+
+  //
+  // GentypeFamily
+  //
+
+  llvm::StringRef GentypeFamily::getName() const {
+    const GentypeFamilySet::Family& f = m_set->m_families[m_index];
+    return llvm::StringRef(m_set->m_names.data() + f.nameOffset,
+                           f.nameLength);
+  }
+
+  unsigned GentypeFamily::getAttributes() const {
+    return m_set->m_families[m_index].attributes;
+  }
+
+  unsigned GentypeFamily::size() const {
+    const GentypeFamilySet::Family& f = m_set->m_families[m_index];
+    return countBits(f.elements) * countBits(f.lengths);
+  }
+
+  unsigned GentypeFamily::getNumParameters() const {
+    return m_set->m_families[m_index].numParameters;
+  }
+
+  llvm::ArrayRef<TemplateType> GentypeFamily::getSignature() const {
+    const GentypeFamilySet::Family& f = m_set->m_families[m_index];
+    return llvm::ArrayRef<TemplateType>(&m_set->m_types[f.signature],
+                                        f.numParameters + 1);
+  }
+
+  TypePrimitiveEnum GentypeFamily::getElement(unsigned i) const {
+    assert(i < size() && "overload out of range");
+    const GentypeFamilySet::Family& f = m_set->m_families[m_index];
+    return (TypePrimitiveEnum)getSetBit(f.elements, i / countBits(f.lengths));
+  }
+
+  unsigned GentypeFamily::getLength(unsigned i) const {
+    assert(i < size() && "overload out of range");
+    const GentypeFamilySet::Family& f = m_set->m_families[m_index];
+    return getSetBit(f.lengths, i % countBits(f.lengths));
+  }
+
+  PackedType GentypeFamily::getReturnType(unsigned i) const {
+    return getSignature()[0].instantiate(getElement(i), getLength(i));
+  }
+
+  PackedType GentypeFamily::getParameter(unsigned i, unsigned param) const {
+    assert(param < getNumParameters() && "parameter out of range");
+    return getSignature()[param + 1].instantiate(getElement(i), getLength(i));
+  }
+
+  FunctionDescriptor GentypeFamily::getDescriptor(unsigned i) const {
+    FunctionDescriptor fd(getName().str());
+    llvm::ArrayRef<TemplateType> signature = getSignature();
+    TypePrimitiveEnum element = getElement(i);
+    unsigned length = getLength(i);
+    fd.parameters.reserve(signature.size() - 1);
+    for (unsigned p = 1; p < signature.size(); ++p)
+      fd.parameters.push_back(
+        signature[p].instantiate(element, length).toParamType());
+    return fd;
+  }
+
+  void GentypeFamily::mangle(unsigned i,
+                             llvm::SmallVectorImpl<char>& out) const {
+    llvm::ArrayRef<TemplateType> signature = getSignature();
+    TypePrimitiveEnum element = getElement(i);
+    unsigned length = getLength(i);
+    llvm::SmallVector<PackedType, 8> parameters;
+    for (unsigned p = 1; p < signature.size(); ++p)
+      parameters.push_back(signature[p].instantiate(element, length));
+    SPIR::mangle(getName(), parameters, out);
+  }
+
+  //
+  // GentypeFamilySet
+  //
+
+  /// @brief A declaration, packed.
+  struct PackedDeclaration {
+    const std::string* name;
+    unsigned attributes;
+    /// The return type, then the parameters.
+    llvm::SmallVector<PackedType, 8> types;
+  };
+
+  /// @brief Overloads of a name with the same signature, up to the element
+  ///        type and length they take.
+  struct GentypeGroup {
+    GentypeGroup() : name(NULL), attributes(0) {
+      for (unsigned i = 0; i < PRIMITIVE_NUM; ++i)
+        lengths[i] = 0;
+    }
+
+    /// @brief Returns the number of families of the group, one per distinct
+    ///        set of lengths of its element types.
+    unsigned getNumFamilies() const {
+      unsigned n = 0;
+      for (unsigned e = 0; e < PRIMITIVE_NUM; ++e) {
+        bool found = !lengths[e];
+        for (unsigned other = 0; other < e && !found; ++other)
+          found = lengths[other] == lengths[e];
+        n += !found;
+      }
+      return n;
+    }
+
+    const std::string* name;
+    unsigned attributes;
+    llvm::SmallVector<TemplateType, 8> signature;
+    /// The lengths of each element type.
+    uint32_t lengths[PRIMITIVE_NUM];
+  };
+
+  /// @brief Groups overloads of the same name and shape, taking the element
+  ///        type and length of each overload from one of its types: any
+  ///        other type takes them too if it does in all the overloads,
+  ///        otherwise it is fixed and the overloads are grouped by its
+  ///        value.
+  /// @param unsigned the type the overloads are for, ~0U for none.
+  /// @return the number of families of the new groups.
+  static unsigned groupShape(const std::vector<PackedDeclaration>& packed,
+                             const std::vector<unsigned>& overloads,
+                             unsigned gentype,
+                             std::vector<GentypeGroup>& groups) {
+    const PackedDeclaration& first = packed[overloads[0]];
+    llvm::SmallVector<unsigned, 8> flags(first.types.size(), 0);
+    for (unsigned i = 0; gentype != ~0U && i < first.types.size(); ++i) {
+      if (!isArithmetic(first.types[i].getPrimitive()))
+        continue;
+      flags[i] = TemplateType::ELEMENT | TemplateType::LENGTH;
+      for (unsigned o = 0; o < overloads.size(); ++o) {
+        const PackedDeclaration& p = packed[overloads[o]];
+        if (p.types[i].getPrimitive() != p.types[gentype].getPrimitive())
+          flags[i] &= ~TemplateType::ELEMENT;
+        if (p.types[i].getLength() != p.types[gentype].getLength())
+          flags[i] &= ~TemplateType::LENGTH;
+      }
+    }
+
+    unsigned firstGroup = groups.size();
+    std::map<std::vector<uint32_t>, unsigned> groupIndices;
+    for (unsigned o = 0; o < overloads.size(); ++o) {
+      const PackedDeclaration& p = packed[overloads[o]];
+      std::vector<uint32_t> key;
+      llvm::SmallVector<TemplateType, 8> signature;
+      for (unsigned i = 0; i < p.types.size(); ++i) {
+        TemplateType t;
+        t.type = p.types[i];
+        t.flags = flags[i];
+        signature.push_back(t);
+        key.push_back(t.instantiate(PRIMITIVE_BOOL, 0).getBits());
+      }
+      std::map<std::vector<uint32_t>, unsigned>::iterator it =
+        groupIndices.find(key);
+      if (it == groupIndices.end()) {
+        it = groupIndices.insert(std::make_pair(key, groups.size())).first;
+        groups.push_back(GentypeGroup());
+        groups.back().name = p.name;
+        groups.back().attributes = p.attributes;
+        groups.back().signature = signature;
+      }
+      // Overloads without a gentype are alone in their group, use bool as
+      // their (unused) element type.
+      TypePrimitiveEnum element = PRIMITIVE_BOOL;
+      unsigned length = 0;
+      if (gentype != ~0U) {
+        element = p.types[gentype].getPrimitive();
+        length = p.types[gentype].getLength();
+      }
+      assert(length < 32 && "vector too long");
+      groups[it->second].lengths[element] |= 1U << length;
+    }
+
+    unsigned numFamilies = 0;
+    for (unsigned g = firstGroup; g < groups.size(); ++g)
+      numFamilies += groups[g].getNumFamilies();
+    return numFamilies;
+  }
+
+  typedef std::pair<std::string, std::vector<uint32_t> > ShapeKey;
+
+  unsigned GentypeFamilySet::build(const BuiltinDeclarationList& decls) {
+    m_names.clear();
+    m_families.clear();
+    m_types.clear();
+    m_numOverloads = 0;
+
+    // Gather the overloads of each name and shape (the signature with the
+    // primitive and length of arithmetic types left out), in order of
+    // appearance.
+    std::vector<PackedDeclaration> packed;
+    std::vector<std::vector<unsigned> > shapes;
+    std::map<ShapeKey, unsigned> shapeIndices;
+    llvm::StringMap<bool> seen;
+    unsigned failures = 0;
+    for (unsigned d = 0; d < decls.size(); ++d) {
+      const BuiltinDeclaration& decl = decls[d];
+      PackedDeclaration p;
+      p.name = &decl.descriptor.name;
+      p.attributes = (decl.isConst ? BUILTIN_CONST : 0) |
+                     (decl.isReadOnly ? BUILTIN_READ_ONLY : 0);
+      p.types.push_back(PackedType::get(decl.returnType));
+      for (unsigned i = 0; i < decl.descriptor.parameters.size(); ++i)
+        p.types.push_back(PackedType::get(decl.descriptor.parameters[i]));
+      bool valid = true;
+      for (unsigned i = 0; i < p.types.size(); ++i)
+        valid = valid && p.types[i].isValid();
+      if (!valid) {
+        ++failures;
+        continue;
+      }
+      if (!seen.insert(std::make_pair(mangle(decl.descriptor), true)).second)
+        continue;
+
+      ShapeKey key(decl.descriptor.name, std::vector<uint32_t>());
+      key.second.push_back(p.attributes);
+      for (unsigned i = 0; i < p.types.size(); ++i) {
+        TemplateType t;
+        t.type = p.types[i];
+        t.flags = isArithmetic(t.type.getPrimitive()) ?
+          TemplateType::ELEMENT | TemplateType::LENGTH : 0;
+        key.second.push_back(t.instantiate(PRIMITIVE_BOOL, 0).getBits());
+      }
+      std::map<ShapeKey, unsigned>::iterator it = shapeIndices.find(key);
+      if (it == shapeIndices.end()) {
+        it = shapeIndices.insert(std::make_pair(key, shapes.size())).first;
+        shapes.push_back(std::vector<unsigned>());
+      }
+      shapes[it->second].push_back(packed.size());
+      packed.push_back(p);
+    }
+
+    // Group the overloads of each shape by the type that gives the fewest
+    // families (e.g. the pointers of async_work_group_copy, not its size_t
+    // parameter).
+    std::vector<GentypeGroup> groups;
+    for (unsigned s = 0; s < shapes.size(); ++s) {
+      const PackedDeclaration& first = packed[shapes[s][0]];
+      unsigned best = ~0U, bestFamilies = ~0U;
+      for (unsigned i = 0; i < first.types.size(); ++i) {
+        if (!isArithmetic(first.types[i].getPrimitive()))
+          continue;
+        std::vector<GentypeGroup> trial;
+        unsigned n = groupShape(packed, shapes[s], i, trial);
+        if (n < bestFamilies) {
+          best = i;
+          bestFamilies = n;
+        }
+      }
+      groupShape(packed, shapes[s], best, groups);
+    }
+
+    // A group is a family per distinct set of lengths of its element types,
+    // so the overloads of a family are exactly the product of its element
+    // types and lengths.
+    llvm::StringMap<unsigned> nameOffsets;
+    for (unsigned g = 0; g < groups.size(); ++g) {
+      const GentypeGroup& group = groups[g];
+      const std::string& name = *group.name;
+      assert(group.signature.size() <= 256 && "too many parameters");
+      assert(name.size() <= 0xffff && "name too long");
+      llvm::StringMap<unsigned>::iterator it = nameOffsets.find(name);
+      unsigned nameOffset;
+      if (it != nameOffsets.end()) {
+        nameOffset = it->second;
+      } else {
+        nameOffset = m_names.size();
+        nameOffsets.insert(std::make_pair(name, nameOffset));
+        m_names += name;
+      }
+
+      uint32_t done = 0;
+      for (unsigned e = 0; e < PRIMITIVE_NUM; ++e) {
+        uint32_t lengths = group.lengths[e];
+        if (!lengths || (done & (1U << e)))
+          continue;
+        Family f;
+        f.nameOffset = nameOffset;
+        f.nameLength = name.size();
+        f.numParameters = group.signature.size() - 1;
+        f.attributes = group.attributes;
+        f.signature = m_types.size();
+        f.elements = 0;
+        f.lengths = lengths;
+        for (unsigned other = e; other < PRIMITIVE_NUM; ++other) {
+          if (group.lengths[other] == lengths)
+            f.elements |= 1U << other;
+        }
+        done |= f.elements;
+        m_types.insert(m_types.end(), group.signature.begin(),
+                       group.signature.end());
+        m_families.push_back(f);
+        m_numOverloads += countBits(f.elements) * countBits(f.lengths);
+      }
+    }
+    return failures;
+  }
+
+  size_t GentypeFamilySet::getMemorySize() const {
+    return sizeof(*this) + m_names.capacity() +
+      m_families.capacity() * sizeof(Family) +
+      m_types.capacity() * sizeof(TemplateType);
+  }
+
+} // End SPIR namespace
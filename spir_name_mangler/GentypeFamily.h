@@ -0,0 +1,151 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __GENTYPE_FAMILY_H__
+#define __GENTYPE_FAMILY_H__
+
+#include "BuiltinParser.h"
+#include "FunctionDescriptor.h"
+#include "PackedType.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/DataTypes.h"
+#include <string>
+#include <vector>
+
+namespace SPIR {
+
+  class GentypeFamilySet;
+
+  /// @brief A type of the signature of a gentype family, which may take the
+  ///        element type and/or the vector length of the overload.
+  struct TemplateType {
+    enum {
+      /// The primitive (or pointee primitive) is the element type.
+      ELEMENT = 1,
+      /// The vector length (or pointee length) is the overload's.
+      LENGTH = 2
+    };
+
+    /// The type of the overload the family was built from.
+    PackedType type;
+    /// ELEMENT and LENGTH bits.
+    unsigned flags;
+
+    /// @brief Returns the type for the given element type and length.
+    PackedType instantiate(TypePrimitiveEnum element, unsigned length) const;
+  };
+
+  /// @brief Overloads of a built-in which differ only by their element type
+  ///        and/or vector length (gentype), e.g. the 12 overloads of
+  ///        native_cos. The overloads are the product of a set of element
+  ///        types and a set of lengths, in increasing order of element type,
+  ///        then length. A family is a view of a GentypeFamilySet.
+  class GentypeFamily {
+  public:
+    /// @brief Returns the name of the built-in.
+    llvm::StringRef getName() const;
+
+    /// @brief Returns the BuiltinAttribute mask of the overloads.
+    unsigned getAttributes() const;
+
+    /// @brief Returns the number of overloads.
+    unsigned size() const;
+
+    /// @brief Returns the number of parameters of each overload.
+    unsigned getNumParameters() const;
+
+    /// @brief Returns the signature, the return type first.
+    llvm::ArrayRef<TemplateType> getSignature() const;
+
+    /// @brief Returns the element type of an overload.
+    TypePrimitiveEnum getElement(unsigned i) const;
+
+    /// @brief Returns the vector length of an overload (0 for scalars).
+    unsigned getLength(unsigned i) const;
+
+    PackedType getReturnType(unsigned i) const;
+
+    PackedType getParameter(unsigned i, unsigned param) const;
+
+    /// @brief Builds the function descriptor of an overload.
+    FunctionDescriptor getDescriptor(unsigned i) const;
+
+    /// @brief Appends the mangled name of an overload to the buffer.
+    void mangle(unsigned i, llvm::SmallVectorImpl<char>&) const;
+
+  private:
+    friend class GentypeFamilySet;
+
+    GentypeFamily(const GentypeFamilySet* set, unsigned index)
+      : m_set(set), m_index(index) {
+    }
+
+    const GentypeFamilySet* m_set;
+    unsigned m_index;
+  };
+
+  /// @brief The built-ins of a declaration list, grouped in gentype families
+  ///        and held in a few flat arrays. Built-ins which are not part of a
+  ///        larger family are families of a single overload.
+  class GentypeFamilySet {
+  public:
+    GentypeFamilySet() : m_numOverloads(0) {
+    }
+
+    /// @brief Groups the given declarations. Repeated declarations are
+    ///        kept once.
+    /// @param BuiltinDeclarationList the declarations (of one pointer size).
+    /// @return the number of declarations left out, because a type does not
+    ///         fit PackedType.
+    unsigned build(const BuiltinDeclarationList&);
+
+    /// @brief Returns the number of families.
+    unsigned size() const {
+      return m_families.size();
+    }
+
+    GentypeFamily operator[](unsigned i) const {
+      return GentypeFamily(this, i);
+    }
+
+    /// @brief Returns the number of overloads of all families.
+    size_t getNumOverloads() const {
+      return m_numOverloads;
+    }
+
+    /// @brief Returns the number of bytes the set holds.
+    size_t getMemorySize() const;
+
+  private:
+    friend class GentypeFamily;
+
+    struct Family {
+      /// The name, in m_names.
+      uint32_t nameOffset;
+      uint16_t nameLength;
+      uint8_t numParameters;
+      uint8_t attributes;
+      /// The signature, in m_types.
+      uint32_t signature;
+      /// A bit per element type (TypePrimitiveEnum).
+      uint32_t elements;
+      /// A bit per vector length, see getLengthIndex().
+      uint32_t lengths;
+    };
+
+    /// Names, back to back.
+    std::string m_names;
+    std::vector<Family> m_families;
+    /// The signatures of the families, back to back.
+    std::vector<TemplateType> m_types;
+    size_t m_numOverloads;
+  };
+
+} // End SPIR namespace
+
+#endif //__GENTYPE_FAMILY_H__
@@ -0,0 +1,103 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "MangleBatch.h"
+#include "ManglingUtils.h"
+#include "NameMangleAPI.h"
+#include "llvm/ADT/SmallString.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace SPIR {
+
+  /// Batches are not split into chunks smaller than this, starting a thread
+  /// would cost more than it saves.
+  static const size_t MinChunkSize = 512;
+
+  /// @brief The names of a range of descriptors, mangled by one thread.
+  struct MangledChunk {
+    size_t begin;
+    size_t end;
+    /// The names, back to back.
+    llvm::SmallString<256> names;
+    /// Start of each name in names.
+    std::vector<size_t> offsets;
+  };
+
+  static void mangleChunk(llvm::ArrayRef<FunctionDescriptor> fds,
+                          MangledChunk& chunk) {
+    llvm::SmallVectorImpl<char>& out = chunk.names;
+    chunk.offsets.reserve(chunk.end - chunk.begin);
+    // The previous descriptor, and where its "_Z<length><name>" prefix is.
+    const FunctionDescriptor* prev = NULL;
+    size_t prefixStart = 0, prefixLength = 0;
+    for (size_t i = chunk.begin; i < chunk.end; ++i) {
+      const FunctionDescriptor& fd = fds[i];
+      size_t start = out.size();
+      chunk.offsets.push_back(start);
+      if (fd.isNull()) {
+        appendString(out, FunctionDescriptor::nullString());
+        prev = NULL;
+        continue;
+      }
+      if (prev && prev->name == fd.name) {
+        // Reserve first, so copying within the buffer stays valid.
+        out.reserve(start + prefixLength);
+        out.append(out.begin() + prefixStart,
+                   out.begin() + prefixStart + prefixLength);
+      } else {
+        out.push_back('_');
+        out.push_back('Z');
+        appendNumber(out, fd.name.size());
+        appendString(out, fd.name);
+        prefixLength = out.size() - start;
+      }
+      prefixStart = start;
+      prev = &fd;
+      mangleParameters(fd, out);
+    }
+  }
+
+  void mangleBatch(llvm::ArrayRef<FunctionDescriptor> fds,
+                   MangledNameTable& table, unsigned numThreads) {
+    table.clear();
+    if (!numThreads)
+      numThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    size_t numChunks = std::min<size_t>(numThreads,
+      (fds.size() + MinChunkSize - 1) / MinChunkSize);
+    numChunks = std::max<size_t>(numChunks, 1);
+
+    std::vector<MangledChunk> chunks(numChunks);
+    for (size_t c = 0; c < numChunks; ++c) {
+      chunks[c].begin = fds.size() * c / numChunks;
+      chunks[c].end = fds.size() * (c + 1) / numChunks;
+    }
+    // The calling thread mangles the first chunk itself.
+    std::vector<std::thread> threads;
+    for (size_t c = 1; c < numChunks; ++c)
+      threads.push_back(std::thread(mangleChunk, fds, std::ref(chunks[c])));
+    mangleChunk(fds, chunks[0]);
+    for (size_t t = 0; t < threads.size(); ++t)
+      threads[t].join();
+
+    size_t poolSize = 0;
+    for (size_t c = 0; c < numChunks; ++c)
+      poolSize += chunks[c].names.size();
+    table.m_pool.reserve(poolSize);
+    table.m_offsets.reserve(fds.size() + 1);
+    for (size_t c = 0; c < numChunks; ++c) {
+      const MangledChunk& chunk = chunks[c];
+      size_t base = table.m_pool.size();
+      table.m_pool.append(chunk.names.data(), chunk.names.size());
+      for (size_t i = 0; i < chunk.offsets.size(); ++i)
+        table.m_offsets.push_back(base + chunk.offsets[i]);
+    }
+    table.m_offsets.push_back(table.m_pool.size());
+  }
+
+} // End SPIR namespace
@@ -0,0 +1,74 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __MANGLE_BATCH_H__
+#define __MANGLE_BATCH_H__
+
+#include "FunctionDescriptor.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace SPIR {
+
+  /// @brief The mangled names of a batch of function descriptors, stored
+  ///        back to back in a single string pool.
+  class MangledNameTable {
+  public:
+    /// @brief Returns the number of names.
+    size_t size() const {
+      return m_offsets.empty() ? 0 : m_offsets.size() - 1;
+    }
+
+    /// @brief Returns the i-th name, valid until the table changes.
+    llvm::StringRef operator[](size_t i) const {
+      return llvm::StringRef(m_pool.data() + m_offsets[i],
+                             m_offsets[i + 1] - m_offsets[i]);
+    }
+
+    /// @brief Returns the offset of the i-th name in the pool. The offset of
+    ///        name size() is the size of the pool.
+    size_t getOffset(size_t i) const {
+      return m_offsets[i];
+    }
+
+    /// @brief Returns all names, concatenated (without separators).
+    llvm::StringRef getPool() const {
+      return m_pool;
+    }
+
+    void clear() {
+      m_pool.clear();
+      m_offsets.clear();
+    }
+
+  private:
+    friend void mangleBatch(llvm::ArrayRef<FunctionDescriptor>,
+                            MangledNameTable&, unsigned);
+
+    /// The names.
+    std::string m_pool;
+    /// Start of each name in the pool, followed by the size of the pool.
+    std::vector<size_t> m_offsets;
+  };
+
+  /// @brief Mangles all given function descriptors, as mangle() does, in
+  ///        parallel. Consecutive descriptors with the same name (overloads)
+  ///        share the mangling of the "_Z<length><name>" prefix.
+  /// @param llvm::ArrayRef<FunctionDescriptor> functions to be mangled.
+  /// @param MangledNameTable receives the names, in the order of the
+  ///        descriptors (its previous contents are discarded).
+  /// @param unsigned maximal number of threads to use, 0 for one per
+  ///        hardware thread.
+  void mangleBatch(llvm::ArrayRef<FunctionDescriptor>, MangledNameTable&,
+                   unsigned numThreads = 0);
+
+} // End SPIR namespace
+
+#endif //__MANGLE_BATCH_H__
@@ -0,0 +1,110 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "MangleCache.h"
+#include "NameMangleAPI.h"
+#include "llvm/ADT/SmallString.h"
+#include <assert.h>
+#include <new>
+#include <string.h>
+
+namespace SPIR {
+
+  // Returns a heap allocated copy of a type (and of its sub types). The
+  // caller's types may be modified, or freed along with their TypeArena,
+  // while the cache lives.
+  static RefParamType copyType(const ParamType* type) {
+    if (const PrimitiveType* p = dyn_cast<PrimitiveType>(type))
+      return new PrimitiveType(p->getPrimitive());
+    if (const VectorType* v = dyn_cast<VectorType>(type))
+      return new VectorType(copyType(v->getScalarType()), v->getLength());
+    if (const PointerType* p = dyn_cast<PointerType>(type)) {
+      PointerType* copy = new PointerType(copyType(p->getPointee()));
+      copy->setAddressSpace(p->getAddressSpace());
+      for (unsigned i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
+        TypeAttributeEnum qual = (TypeAttributeEnum)i;
+        copy->setQualifier(qual, p->hasQualifier(qual));
+      }
+      return copy;
+    }
+    const UserDefinedType* u = dyn_cast<UserDefinedType>(type);
+    assert(u && "unknown type");
+    return new UserDefinedType(u->getName());
+  }
+
+  MangleCache::Shard::~Shard() {
+    for (NameMap::iterator it = names.begin(), e = names.end(); it != e; ++it)
+      it->first->~Entry();
+  }
+
+  MangleCache::MangleCache(unsigned maxEntries) : m_maxEntries(maxEntries),
+    m_entries(0) {
+  }
+
+  llvm::StringRef MangleCache::get(const FunctionDescriptor& fd) {
+    LookupKey lookup = { &fd, (unsigned)hash_value(fd) };
+    // The low bits of the hash select the bucket within the shard.
+    Shard& shard = m_shards[(lookup.hash >> 24) % NumShards];
+    {
+      llvm::sys::ScopedLock lock(shard.lock);
+      NameMap::const_iterator it = shard.names.find_as(lookup);
+      if (it != shard.names.end()) {
+        shard.hits.fetch_add(1, std::memory_order_relaxed);
+        return it->second;
+      }
+    }
+    if (m_entries.load(std::memory_order_relaxed) >= m_maxEntries) {
+      shard.rejected.fetch_add(1, std::memory_order_relaxed);
+      return llvm::StringRef();
+    }
+
+    // Mangle outside of the lock, other threads may add the same name
+    // meanwhile.
+    llvm::SmallString<128> mangled;
+    mangle(fd, mangled);
+
+    llvm::sys::ScopedLock lock(shard.lock);
+    NameMap::const_iterator it = shard.names.find_as(lookup);
+    if (it != shard.names.end()) {
+      shard.hits.fetch_add(1, std::memory_order_relaxed);
+      return it->second;
+    }
+    if (m_entries.fetch_add(1, std::memory_order_relaxed) >= m_maxEntries) {
+      m_entries.fetch_sub(1, std::memory_order_relaxed);
+      shard.rejected.fetch_add(1, std::memory_order_relaxed);
+      return llvm::StringRef();
+    }
+    char* storage =
+      static_cast<char*>(shard.allocator.Allocate(mangled.size(), 1));
+    memcpy(storage, mangled.data(), mangled.size());
+    llvm::StringRef name(storage, mangled.size());
+    Entry* entry = new (shard.allocator.Allocate<Entry>()) Entry();
+    entry->fd.name = fd.name;
+    for (unsigned i = 0; i < fd.parameters.size(); ++i)
+      entry->fd.parameters.push_back(copyType(fd.parameters[i]));
+    entry->hash = lookup.hash;
+    shard.names.insert(std::make_pair(entry, name));
+    shard.bytes += name.size();
+    shard.misses.fetch_add(1, std::memory_order_relaxed);
+    return name;
+  }
+
+  MangleCache::Statistics MangleCache::getStatistics() const {
+    Statistics stats = { 0, 0, 0, 0, 0 };
+    for (unsigned i = 0; i < NumShards; ++i) {
+      const Shard& shard = m_shards[i];
+      stats.hits += shard.hits.load(std::memory_order_relaxed);
+      stats.misses += shard.misses.load(std::memory_order_relaxed);
+      stats.rejected += shard.rejected.load(std::memory_order_relaxed);
+      llvm::sys::ScopedLock lock(shard.lock);
+      stats.entries += shard.names.size();
+      stats.bytes += shard.bytes;
+    }
+    return stats;
+  }
+
+} // End SPIR namespace
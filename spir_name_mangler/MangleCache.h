@@ -0,0 +1,131 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __MANGLE_CACHE_H__
+#define __MANGLE_CACHE_H__
+
+#include "FunctionDescriptor.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/Mutex.h"
+#include <atomic>
+#include <stddef.h>
+
+namespace SPIR {
+
+  /// @brief Memoizes mangle() for frequently mangled function descriptors.
+  ///        Descriptors are matched structurally. The cache holds at most a
+  ///        fixed number of names, which stay valid (and unchanged) for the
+  ///        lifetime of the cache. All methods may be called concurrently.
+  class MangleCache {
+  public:
+    /// @brief Hit/miss counters of a cache.
+    struct Statistics {
+      /// Lookups answered from the cache.
+      size_t hits;
+      /// Lookups which mangled and added a new name.
+      size_t misses;
+      /// Lookups of new names which did not fit into the cache anymore.
+      size_t rejected;
+      /// Number of cached names.
+      unsigned entries;
+      /// Total length of the cached names.
+      size_t bytes;
+    };
+
+    /// @brief Constructor.
+    /// @param unsigned maximal number of cached names.
+    explicit MangleCache(unsigned maxEntries = 4096);
+
+    /// @brief Returns the mangled name of the given function descriptor.
+    /// @param FunctionDescriptor function to be mangled.
+    /// @return the mangled name, valid for the lifetime of the cache, or an
+    ///         empty string if the name is not cached and the cache is full
+    ///         (mangle() should be used instead in that case).
+    llvm::StringRef get(const FunctionDescriptor&);
+
+    /// @brief Returns the current counters.
+    Statistics getStatistics() const;
+
+  private:
+    MangleCache(const MangleCache&);
+    MangleCache& operator=(const MangleCache&);
+
+    /// @brief A cached descriptor, along with its hash. The descriptor owns
+    ///        copies of the looked up parameter types.
+    struct Entry {
+      FunctionDescriptor fd;
+      unsigned hash;
+    };
+
+    /// @brief A descriptor being looked up, along with its hash.
+    struct LookupKey {
+      const FunctionDescriptor* fd;
+      unsigned hash;
+    };
+
+    struct EntryInfo {
+      static const Entry* getEmptyKey() {
+        return llvm::DenseMapInfo<const Entry*>::getEmptyKey();
+      }
+      static const Entry* getTombstoneKey() {
+        return llvm::DenseMapInfo<const Entry*>::getTombstoneKey();
+      }
+      static unsigned getHashValue(const Entry* e) {
+        return e->hash;
+      }
+      static unsigned getHashValue(const LookupKey& k) {
+        return k.hash;
+      }
+      static bool isEqual(const Entry* l, const Entry* r) {
+        return l == r;
+      }
+      static bool isEqual(const LookupKey& l, const Entry* r) {
+        if (r == getEmptyKey() || r == getTombstoneKey())
+          return false;
+        return l.hash == r->hash && *l.fd == r->fd;
+      }
+    };
+
+    /// Maps the entries (owned by the shard's allocator) to their names.
+    typedef llvm::DenseMap<const Entry*, llvm::StringRef, EntryInfo> NameMap;
+
+    /// @brief Names are spread over several independently locked shards, so
+    ///        concurrent lookups rarely contend.
+    struct Shard {
+      Shard() : hits(0), misses(0), rejected(0), bytes(0) {
+      }
+
+      ~Shard();
+
+      /// The cached names.
+      NameMap names;
+      /// Storage of the entries and cached strings.
+      llvm::BumpPtrAllocator allocator;
+      std::atomic<size_t> hits;
+      std::atomic<size_t> misses;
+      std::atomic<size_t> rejected;
+      /// Total length of the cached strings.
+      size_t bytes;
+      /// Guards names, allocator and bytes. Lookups are short, so a plain
+      /// mutex is cheaper than a reader/writer lock here.
+      mutable llvm::sys::Mutex lock;
+    };
+
+    static const unsigned NumShards = 16;
+
+    /// Maximal number of cached names.
+    const unsigned m_maxEntries;
+    /// Number of cached names, in all shards.
+    std::atomic<unsigned> m_entries;
+    Shard m_shards[NumShards];
+  };
+
+} // End SPIR namespace
+
+#endif //__MANGLE_CACHE_H__
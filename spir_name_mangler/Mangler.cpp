@@ -6,17 +6,109 @@
 //
 
 #include "FunctionDescriptor.h"
+#include "NameMangleAPI.h"
 #include "ParameterType.h"
 #include "ManglingUtils.h"
+#include "llvm/ADT/SmallString.h"
 #include <string>
-#include <sstream>
 
 namespace SPIR {
 
+/// @brief Sink that appends the mangled name to a buffer.
+class BufferSink {
+public:
+
+  BufferSink(llvm::SmallVectorImpl<char>& out): m_out(out) {
+  }
+
+  void append(llvm::StringRef s) {
+    appendString(m_out, s);
+  }
+
+  void appendNumber(unsigned n) {
+    SPIR::appendNumber(m_out, n);
+  }
+
+private:
+  llvm::SmallVectorImpl<char>& m_out;
+};
+
+/// @brief Sink that only counts the characters of the mangled name.
+class LengthSink {
+public:
+
+  LengthSink(): m_length(0) {
+  }
+
+  void append(llvm::StringRef s) {
+    m_length += s.size();
+  }
+
+  void appendNumber(unsigned n) {
+    m_length += getNumberLength(n);
+  }
+
+  size_t getLength() const {
+    return m_length;
+  }
+
+private:
+  size_t m_length;
+};
+
+/// @brief The substitution candidates of a name mangled so far, in the
+///        order their mangling completed (see the Itanium ABI, 5.1.8).
+class Substitutions {
+public:
+
+  /// @brief Returns the index of the candidate equal to the given one, or -1.
+  /// @param ParamType the type, or the pointer whose pointee it is.
+  /// @param bool true for the (qualified) pointee of the given pointer.
+  int find(const ParamType* t, bool pointee) const {
+    for (unsigned i = 0; i < m_candidates.size(); ++i) {
+      const Candidate& c = m_candidates[i];
+      // Two qualified pointees are equal exactly when their pointers are.
+      if (c.pointee == pointee && c.type->equals(t))
+        return i;
+    }
+    return -1;
+  }
+
+  void add(const ParamType* t, bool pointee) {
+    Candidate c = { t, pointee };
+    m_candidates.push_back(c);
+  }
+
+private:
+
+  struct Candidate {
+    const ParamType* type;
+    bool pointee;
+  };
+
+  llvm::SmallVector<Candidate, 16> m_candidates;
+};
+
+/// @brief Returns true for the pointers whose pointee is mangled with
+///        qualifiers or an address space.
+static bool hasQualifiedPointee(const PointerType* p) {
+  for (unsigned int i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
+    if (p->hasQualifier((TypeAttributeEnum)i))
+      return true;
+  }
+  return p->getAddressSpace() != ATTR_PRIVATE;
+}
+
+template <typename Sink>
 class MangleVisitor: public TypeVisitor {
 public:
 
-  MangleVisitor(std::stringstream& s): m_stream(s) {
+  /// @brief Constructor.
+  /// @param Sink receives the mangled string.
+  /// @param Substitutions candidates for substitution, or NULL to mangle
+  ///        every type in full.
+  MangleVisitor(Sink& s, Substitutions* subs = NULL): m_sink(s),
+    m_subs(subs) {
   }
 
   void operator() (const ParamType* t) {
@@ -27,48 +119,150 @@ public:
 // Visit methods
 //
   void visit(const PrimitiveType* t) {
-    m_stream << mangledPrimitiveString(t->getPrimitive());
+    TypePrimitiveEnum primitive = t->getPrimitive();
+    // Opaque OpenCL types are substitutable, builtin types are not.
+    bool substitutable = primitive >= PRIMITIVE_STRUCT_FIRST &&
+      primitive <= PRIMITIVE_LAST;
+    if (substitutable && substitute(t, false))
+      return;
+    m_sink.append(mangledPrimitiveString(primitive));
+    if (substitutable)
+      addCandidate(t, false);
   }
 
   void visit(const PointerType* p) {
-    m_stream << "P";
-    for (unsigned int i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
-      TypeAttributeEnum qualifier = (TypeAttributeEnum)i;
-      if (p->hasQualifier(qualifier)) {
-        m_stream << getMangledAttribute(qualifier);
+    if (substitute(p, false))
+      return;
+    m_sink.append("P");
+    if (!hasQualifiedPointee(p)) {
+      p->getPointee()->accept(this);
+    } else if (!substitute(p, true)) {
+      for (unsigned int i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
+        TypeAttributeEnum qualifier = (TypeAttributeEnum)i;
+        if (p->hasQualifier(qualifier)) {
+          m_sink.append(getMangledAttribute(qualifier));
+        }
       }
+      m_sink.append(getMangledAttribute((p->getAddressSpace())));
+      p->getPointee()->accept(this);
+      addCandidate(p, true);
     }
-    m_stream << getMangledAttribute((p->getAddressSpace()));
-    p->getPointee()->accept(this);
+    addCandidate(p, false);
   }
 
   void visit(const VectorType* v) {
-    m_stream << "Dv" << v->getLength() << "_";
+    if (substitute(v, false))
+      return;
+    m_sink.append("Dv");
+    m_sink.appendNumber(v->getLength());
+    m_sink.append("_");
     v->getScalarType()->accept(this);
+    addCandidate(v, false);
   }
 
 
   void visit(const UserDefinedType* pTy) {
-    std::string name = pTy->toString();
-    m_stream << name.size() << name;
+    if (substitute(pTy, false))
+      return;
+    const std::string& name = pTy->getName();
+    m_sink.appendNumber(name.size());
+    m_sink.append(name);
+    addCandidate(pTy, false);
   }
 
 private:
 
-  // Holds the mangled string representing the prototype of the function.
-  std::stringstream& m_stream;
+  // Emits a substitution for the given candidate, if it was seen before.
+  bool substitute(const ParamType* t, bool pointee) {
+    if (!m_subs)
+      return false;
+    int index = m_subs->find(t, pointee);
+    if (index < 0)
+      return false;
+    // S_, then S0_ to S9_, SA_ to SZ_, S10_ and so on.
+    char id[16];
+    char* end = id + sizeof(id);
+    char* begin = end;
+    *--begin = '_';
+    if (index > 0) {
+      unsigned n = index - 1;
+      do {
+        unsigned digit = n % 36;
+        *--begin = digit < 10 ? '0' + digit : 'A' + digit - 10;
+        n /= 36;
+      } while (n);
+    }
+    *--begin = 'S';
+    m_sink.append(llvm::StringRef(begin, end - begin));
+    return true;
+  }
+
+  void addCandidate(const ParamType* t, bool pointee) {
+    if (m_subs)
+      m_subs->add(t, pointee);
+  }
+
+  // Receives the mangled string representing the prototype of the function.
+  Sink& m_sink;
+  // The substitution candidates, NULL if substitutions are not used.
+  Substitutions* m_subs;
 };
 
-std::string mangle(const FunctionDescriptor& fd) {
-  if (fd.isNull())
-    return FunctionDescriptor::nullString();
-  std::stringstream ret;
-  ret << "_Z" << fd.name.length() << fd.name;
-  MangleVisitor visitor(ret);
+template <typename Sink>
+static void mangleTo(const FunctionDescriptor& fd, ManglingMode mode,
+                     Sink& sink) {
+  if (fd.isNull()) {
+    sink.append(FunctionDescriptor::nullString());
+    return;
+  }
+  sink.append("_Z");
+  sink.appendNumber(fd.name.length());
+  sink.append(fd.name);
+  Substitutions subs;
+  MangleVisitor<Sink> visitor(sink,
+    mode == MANGLING_SUBSTITUTIONS ? &subs : NULL);
+  for (unsigned int i=0; i < fd.parameters.size(); ++i) {
+    fd.parameters[i]->accept(&visitor);
+  }
+}
+
+void mangle(const FunctionDescriptor& fd, llvm::SmallVectorImpl<char>& out) {
+  mangle(fd, MANGLING_DEFAULT, out);
+}
+
+void mangle(const FunctionDescriptor& fd, ManglingMode mode,
+            llvm::SmallVectorImpl<char>& out) {
+  BufferSink sink(out);
+  mangleTo(fd, mode, sink);
+}
+
+void mangleParameters(const FunctionDescriptor& fd,
+                      llvm::SmallVectorImpl<char>& out) {
+  BufferSink sink(out);
+  MangleVisitor<BufferSink> visitor(sink);
   for (unsigned int i=0; i < fd.parameters.size(); ++i) {
     fd.parameters[i]->accept(&visitor);
   }
-  return ret.str();
+}
+
+size_t mangledLength(const FunctionDescriptor& fd) {
+  return mangledLength(fd, MANGLING_DEFAULT);
+}
+
+size_t mangledLength(const FunctionDescriptor& fd, ManglingMode mode) {
+  LengthSink sink;
+  mangleTo(fd, mode, sink);
+  return sink.getLength();
+}
+
+std::string mangle(const FunctionDescriptor& fd) {
+  return mangle(fd, MANGLING_DEFAULT);
+}
+
+std::string mangle(const FunctionDescriptor& fd, ManglingMode mode) {
+  llvm::SmallString<128> ret;
+  mangle(fd, mode, ret);
+  return ret.str().str();
 }
 
 } // End SPIR namespace
\ No newline at end of file
@@ -6,6 +6,7 @@
 //
 
 #include "ManglingUtils.h"
+#include "StaticTables.h"
 
 namespace SPIR {
 
@@ -35,31 +36,6 @@ namespace SPIR {
     "sampler_t"
   };
 
-  const char* mangledTypes[PRIMITIVE_NUM] = {
-    "b",  //BOOL
-    "h",  //UCHAR
-    "c",  //CHAR
-    "t",  //USHORT
-    "s",  //SHORT
-    "j",  //UINT
-    "i",  //INT
-    "m",  //ULONG
-    "l",  //LONG
-    "Dh", //HALF
-    "f",  //FLOAT
-    "d",  //DOUBLE
-    "v",  //VOID
-    "z",  //VarArg
-    "11ocl_image1d",            //PRIMITIVE_IMAGE_1D_T
-    "11ocl_image2d",            //PRIMITIVE_IMAGE_2D_T
-    "11ocl_image3d",            //PRIMITIVE_IMAGE_3D_T
-    "17ocl_image1dbuffer",      //PRIMITIVE_IMAGE_1D_BUFFER_T
-    "16ocl_image1darray",       //PRIMITIVE_IMAGE_1D_ARRAY_T
-    "16ocl_image2darray",       //PRIMITIVE_IMAGE_2D_ARRAY_T
-    "9ocl_event",               //PRIMITIVE_EVENT_T
-    "11ocl_sampler"             //PRIMITIVE_SAMPLER_T
-  };
-
   const char* readableAttribute[ATTR_NUM] = {
     "restrict",
     "volatile",
@@ -81,7 +57,7 @@ namespace SPIR {
   };
 
   const char* mangledPrimitiveString(TypePrimitiveEnum t) {
-    return mangledTypes[t];
+    return MangledPrimitives[t];
   }
 
   const char* readablePrimitiveString(TypePrimitiveEnum t) {
@@ -96,4 +72,24 @@ namespace SPIR {
     return readableAttribute[attribute];
   }
 
+  void appendNumber(llvm::SmallVectorImpl<char>& out, unsigned n) {
+    char digits[10];
+    char* end = digits + sizeof(digits);
+    char* p = end;
+    do {
+      *--p = '0' + n % 10;
+      n /= 10;
+    } while (n);
+    out.append(p, end);
+  }
+
+  unsigned getNumberLength(unsigned n) {
+    unsigned len = 1;
+    while (n >= 10) {
+      n /= 10;
+      ++len;
+    }
+    return len;
+  }
+
 } // End SPIR namespace
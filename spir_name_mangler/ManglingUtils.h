@@ -9,6 +9,8 @@
 #define __MANGLING_UTILS_H__
 
 #include "ParameterType.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
 
 namespace SPIR {
 
@@ -18,6 +20,25 @@ namespace SPIR {
   const char* getMangledAttribute(TypeAttributeEnum attribute);
   const char* getReadableAttribute(TypeAttributeEnum attribute);
 
+  /// @brief Appends the given string to the buffer.
+  inline void appendString(llvm::SmallVectorImpl<char>& out,
+                           llvm::StringRef s) {
+    out.append(s.begin(), s.end());
+  }
+
+  /// @brief Appends the decimal representation of the given number to the
+  ///        buffer, without going through a (locale aware) stream.
+  void appendNumber(llvm::SmallVectorImpl<char>& out, unsigned n);
+
+  /// @brief Returns the number of characters appendNumber() writes for n.
+  unsigned getNumberLength(unsigned n);
+
+  /// @brief Mixes a value into a hash. Much cheaper than llvm::hash_combine,
+  ///        which matters as type hashes are computed node by node.
+  inline size_t combineHash(size_t seed, size_t value) {
+    return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+  }
+
 } // End SPIR namespace
 
 #endif //__MANGLING_UTILS_H__
@@ -5,11 +5,28 @@
 // License. See LICENSE.TXT for details.
 //
 
+#ifndef __NAME_MANGLE_API_H__
+#define __NAME_MANGLE_API_H__
+
 #include "FunctionDescriptor.h"
+#include "DemangledName.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include <stddef.h>
 #include <string>
 
 namespace SPIR {
 
+/// @brief How types that occur more than once in a name are mangled.
+enum ManglingMode {
+  /// Every type is mangled in full, as the SPIR 1.2 specification does.
+  MANGLING_DEFAULT,
+  /// Types seen before in the name are replaced by Itanium substitutions
+  /// (S_, S0_, S1_, ...), like clang does. Opaque OpenCL types, vectors,
+  /// pointers, qualified pointees and user defined types are candidates.
+  MANGLING_SUBSTITUTIONS
+};
+
 /// @brief Converts the given function descriptor to string that represents
 ///        the function's prototype.
 ///        The mangling algorithm is based on Itanium mangling algorithm
@@ -19,4 +36,61 @@ namespace SPIR {
 /// @return std::string representing the mangled name.
 std::string mangle(const FunctionDescriptor&);
 
-} // End SPIR namespace
\ No newline at end of file
+/// @brief Appends the mangled name of the given function descriptor to the
+///        buffer. Once the buffer is large enough this does not allocate.
+/// @param FunctionDescriptor function to be mangled.
+/// @param llvm::SmallVectorImpl<char> buffer to append to.
+void mangle(const FunctionDescriptor&, llvm::SmallVectorImpl<char>&);
+
+/// @brief Converts the given function descriptor to a mangled name, in the
+///        given mode.
+/// @param FunctionDescriptor function to be mangled.
+/// @param ManglingMode whether to use substitutions.
+/// @return std::string representing the mangled name.
+std::string mangle(const FunctionDescriptor&, ManglingMode);
+
+/// @brief Appends the mangled name of the given function descriptor, in the
+///        given mode, to the buffer.
+/// @param FunctionDescriptor function to be mangled.
+/// @param ManglingMode whether to use substitutions.
+/// @param llvm::SmallVectorImpl<char> buffer to append to.
+void mangle(const FunctionDescriptor&, ManglingMode,
+            llvm::SmallVectorImpl<char>&);
+
+/// @brief Appends the mangled parameter list of the given function descriptor
+///        (what mangle() emits after the function name) to the buffer.
+/// @param FunctionDescriptor function to be mangled, not null.
+/// @param llvm::SmallVectorImpl<char> buffer to append to.
+void mangleParameters(const FunctionDescriptor&, llvm::SmallVectorImpl<char>&);
+
+/// @brief Returns the exact length of the mangled name of the given function
+///        descriptor, without building it.
+/// @param FunctionDescriptor function to be mangled.
+/// @return number of characters mangle() produces.
+size_t mangledLength(const FunctionDescriptor&);
+
+/// @brief Returns the exact length of the mangled name of the given function
+///        descriptor in the given mode, without building it.
+/// @param FunctionDescriptor function to be mangled.
+/// @param ManglingMode whether to use substitutions.
+/// @return number of characters mangle() produces in that mode.
+size_t mangledLength(const FunctionDescriptor&, ManglingMode);
+
+/// @brief Parses a name produced by mangle() back into a function descriptor.
+///        Names with substitutions are accepted as well.
+/// @param llvm::StringRef mangled name.
+/// @return the function descriptor, or FunctionDescriptor::null() if the
+///         given string is not a well formed mangled name.
+FunctionDescriptor demangle(llvm::StringRef);
+
+/// @brief Parses a name produced by mangle() into a borrowed view, without
+///        allocating memory. The view refers to the given string.
+/// @param llvm::StringRef mangled name.
+/// @param DemangledName the view to fill.
+/// @return true on success, false if the given string is not a well formed
+///         mangled name or does not fit into the view.
+bool demangle(llvm::StringRef, DemangledName&);
+
+} // End SPIR namespace
+
+#endif //__NAME_MANGLE_API_H__
@@ -0,0 +1,391 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "NameRecognizer.h"
+
+namespace SPIR {
+
+  namespace {
+
+  /// @brief Classes of input characters, the columns of the state table.
+  enum CharClass {
+    C_OTHER,
+    C_UNDERSCORE,
+    C_Z,
+    C_D,
+    C_P,
+    C_U,
+    C_A,
+    C_S,
+    C_r,
+    C_V,
+    C_K,
+    C_v,
+    C_h,
+    C_UPPER,     // Other upper case letters (base 36 digits).
+    C_PRIMITIVE, // Other single letter primitives.
+    C_0,
+    C_12,
+    C_3,
+    C_DIGIT,     // 4-9.
+    C_END,       // End of input.
+    NUM_CLASSES
+  };
+
+  /// @brief States, the rows of the state table.
+  enum State {
+    S_ERROR,
+    S_HEAD,                // Expecting "_Z".
+    S_HEAD_Z,
+    S_NAME_LENGTH_FIRST,   // Length of the function name.
+    S_NAME_LENGTH,
+    S_PARAM,               // Start of a parameter, or end of input.
+    S_TYPE,                // Start of a pointee or vector element type.
+    S_TYPE_LENGTH,         // Length of a user defined (or ocl_*) type name.
+    S_D,                   // "Dh" or "Dv".
+    S_VECTOR_LENGTH_FIRST,
+    S_VECTOR_LENGTH,
+    S_POINTER,             // After "P", qualifiers in r, V, K order.
+    S_POINTER_R,
+    S_POINTER_V,
+    S_POINTER_K,
+    S_AS_U,                // Address space, "U3AS<n>".
+    S_AS_3,
+    S_AS_A,
+    S_AS_S,
+    S_SUBST,               // Substitution, "S_" or "S<base 36 number>_".
+    S_SUBST_ID,
+    S_POINTER_SUBST,       // Substitution right after "P", which may stand
+    S_POINTER_SUBST_ID,    // for a qualified pointee.
+    S_ACCEPT,
+    NUM_STATES
+  };
+
+  /// @brief Actions taken on a transition.
+  enum Action {
+    /// Moves to the next character. Without it the character is handed to
+    /// the next state.
+    A_CONSUME = 1,
+    /// Starts a new parameter.
+    A_BOUNDARY = 2,
+    /// Starts a new number with the current digit.
+    A_FIRST_DIGIT = 4,
+    /// Appends the current digit to the number.
+    A_DIGIT = 8,
+    /// Skips as many characters as the number says (a source name).
+    A_SKIP = 16,
+    /// The skipped characters are the function name.
+    A_NAME = 32,
+    /// Appends the current base 36 digit to the number.
+    A_SEQ_DIGIT = 64,
+    /// Ends a substitution, which refers to the candidate the number (if
+    /// the previous state has one) stands for.
+    A_SUBST = 128
+  };
+
+  struct Transition {
+    unsigned char next;
+    unsigned char actions;
+  };
+
+  struct RecognizerTable {
+    unsigned char classes[256];
+    Transition transitions[NUM_STATES][NUM_CLASSES];
+  };
+
+  } // End anonymous namespace
+
+  /// Lengths are bounded like in the demangler, so malformed names cannot
+  /// overflow them.
+  static const unsigned MAX_NUMBER = 0xFFFFFF;
+  /// Bounded like in the demangler, which has at most two candidates per type
+  /// node.
+  static const unsigned MAX_CANDIDATES = 2 * DemangledName::MAX_TYPES;
+
+  static void setAll(RecognizerTable& t, State from, State to,
+                     unsigned actions) {
+    for (unsigned c = 0; c < NUM_CLASSES; ++c) {
+      t.transitions[from][c].next = to;
+      t.transitions[from][c].actions = actions;
+    }
+  }
+
+  static void set(RecognizerTable& t, State from, CharClass c, State to,
+                  unsigned actions = A_CONSUME) {
+    t.transitions[from][c].next = to;
+    t.transitions[from][c].actions = actions;
+  }
+
+  static void setNonZeroDigits(RecognizerTable& t, State from, State to,
+                               unsigned actions) {
+    set(t, from, C_12, to, actions);
+    set(t, from, C_3, to, actions);
+    set(t, from, C_DIGIT, to, actions);
+  }
+
+  static void setDigits(RecognizerTable& t, State from, State to,
+                        unsigned actions) {
+    setNonZeroDigits(t, from, to, actions);
+    set(t, from, C_0, to, actions);
+  }
+
+  static void setBase36Digits(RecognizerTable& t, State from, State to,
+                              unsigned actions) {
+    static const CharClass letters[] = {
+      C_Z, C_D, C_P, C_U, C_A, C_S, C_V, C_K, C_UPPER
+    };
+    setDigits(t, from, to, actions);
+    for (unsigned i = 0; i < sizeof(letters) / sizeof(letters[0]); ++i)
+      set(t, from, letters[i], to, actions);
+  }
+
+  // Sets the transitions of "_" or "<base 36 number>_" after an 'S'.
+  static void setSubstitution(RecognizerTable& t, State from, State id) {
+    set(t, from, C_UNDERSCORE, S_PARAM, A_CONSUME | A_SUBST);
+    setBase36Digits(t, from, id, A_CONSUME | A_FIRST_DIGIT | A_SEQ_DIGIT);
+    setBase36Digits(t, id, id, A_CONSUME | A_SEQ_DIGIT);
+    set(t, id, C_UNDERSCORE, S_PARAM, A_CONSUME | A_SUBST);
+  }
+
+  // Sets the transitions starting a type, from S_PARAM or S_TYPE. Any
+  // complete type completes the parameter, as pointers and vectors end with
+  // their element type.
+  static void setTypeStart(RecognizerTable& t, State from, unsigned actions) {
+    actions |= A_CONSUME;
+    set(t, from, C_PRIMITIVE, S_PARAM, actions);
+    set(t, from, C_h, S_PARAM, actions);
+    set(t, from, C_v, S_PARAM, actions);
+    set(t, from, C_D, S_D, actions);
+    set(t, from, C_P, S_POINTER, actions);
+    set(t, from, C_S, S_SUBST, actions);
+    // Leading zeros are not emitted by the mangler.
+    setNonZeroDigits(t, from, S_TYPE_LENGTH, actions | A_FIRST_DIGIT);
+  }
+
+  static RecognizerTable buildTable() {
+    RecognizerTable t;
+    for (unsigned i = 0; i < 256; ++i)
+      t.classes[i] = C_OTHER;
+    const char* primitives = "bctsjimlfdz";
+    for (const char* p = primitives; *p; ++p)
+      t.classes[(unsigned char)*p] = C_PRIMITIVE;
+    t.classes['_'] = C_UNDERSCORE;
+    t.classes['Z'] = C_Z;
+    t.classes['D'] = C_D;
+    t.classes['P'] = C_P;
+    t.classes['U'] = C_U;
+    t.classes['A'] = C_A;
+    t.classes['S'] = C_S;
+    t.classes['r'] = C_r;
+    t.classes['V'] = C_V;
+    t.classes['K'] = C_K;
+    t.classes['v'] = C_v;
+    t.classes['h'] = C_h;
+    t.classes['0'] = C_0;
+    t.classes['1'] = C_12;
+    t.classes['2'] = C_12;
+    t.classes['3'] = C_3;
+    for (char c = '4'; c <= '9'; ++c)
+      t.classes[(unsigned char)c] = C_DIGIT;
+    for (char c = 'A'; c <= 'Z'; ++c)
+      if (t.classes[(unsigned char)c] == C_OTHER)
+        t.classes[(unsigned char)c] = C_UPPER;
+
+    for (unsigned s = 0; s < NUM_STATES; ++s)
+      setAll(t, (State)s, S_ERROR, 0);
+
+    // "_Z<length><name>"
+    set(t, S_HEAD, C_UNDERSCORE, S_HEAD_Z);
+    set(t, S_HEAD_Z, C_Z, S_NAME_LENGTH_FIRST);
+    setNonZeroDigits(t, S_NAME_LENGTH_FIRST, S_NAME_LENGTH,
+                     A_CONSUME | A_FIRST_DIGIT);
+    setAll(t, S_NAME_LENGTH, S_PARAM, A_SKIP | A_NAME);
+    setDigits(t, S_NAME_LENGTH, S_NAME_LENGTH, A_CONSUME | A_DIGIT);
+
+    // Parameters.
+    setTypeStart(t, S_PARAM, A_BOUNDARY);
+    set(t, S_PARAM, C_END, S_ACCEPT, 0);
+    setTypeStart(t, S_TYPE, 0);
+
+    // "<length><name>" user defined and ocl_* opaque types.
+    setAll(t, S_TYPE_LENGTH, S_PARAM, A_SKIP);
+    setDigits(t, S_TYPE_LENGTH, S_TYPE_LENGTH, A_CONSUME | A_DIGIT);
+
+    // "Dh" and "Dv<length>_<element>"
+    set(t, S_D, C_h, S_PARAM);
+    set(t, S_D, C_v, S_VECTOR_LENGTH_FIRST);
+    setNonZeroDigits(t, S_VECTOR_LENGTH_FIRST, S_VECTOR_LENGTH,
+                     A_CONSUME | A_FIRST_DIGIT);
+    setDigits(t, S_VECTOR_LENGTH, S_VECTOR_LENGTH, A_CONSUME | A_DIGIT);
+    set(t, S_VECTOR_LENGTH, C_UNDERSCORE, S_TYPE);
+
+    // "P[r][V][K][U3AS<1-3>]<pointee>"
+    setAll(t, S_POINTER, S_TYPE, 0);
+    set(t, S_POINTER, C_r, S_POINTER_R);
+    set(t, S_POINTER, C_V, S_POINTER_V);
+    set(t, S_POINTER, C_K, S_POINTER_K);
+    set(t, S_POINTER, C_U, S_AS_U);
+    set(t, S_POINTER, C_S, S_POINTER_SUBST);
+    setAll(t, S_POINTER_R, S_TYPE, 0);
+    set(t, S_POINTER_R, C_V, S_POINTER_V);
+    set(t, S_POINTER_R, C_K, S_POINTER_K);
+    set(t, S_POINTER_R, C_U, S_AS_U);
+    setAll(t, S_POINTER_V, S_TYPE, 0);
+    set(t, S_POINTER_V, C_K, S_POINTER_K);
+    set(t, S_POINTER_V, C_U, S_AS_U);
+    setAll(t, S_POINTER_K, S_TYPE, 0);
+    set(t, S_POINTER_K, C_U, S_AS_U);
+    set(t, S_AS_U, C_3, S_AS_3);
+    set(t, S_AS_3, C_A, S_AS_A);
+    set(t, S_AS_A, C_S, S_AS_S);
+    set(t, S_AS_S, C_12, S_TYPE);
+    set(t, S_AS_S, C_3, S_TYPE);
+
+    // "S_" and "S<id>_" substitutions.
+    setSubstitution(t, S_SUBST, S_SUBST_ID);
+    setSubstitution(t, S_POINTER_SUBST, S_POINTER_SUBST_ID);
+    return t;
+  }
+
+  static const RecognizerTable& getTable() {
+    static const RecognizerTable table = buildTable();
+    return table;
+  }
+
+  namespace {
+
+  /// @brief The substitution candidates of the parameters recognized so
+  ///        far, found only once a name turns out to use substitutions.
+  struct Candidates {
+    Candidates() : numCandidates(0), numParameters(0) {
+    }
+
+    /// Whether each candidate is a qualified pointee, in the order the
+    /// candidates complete.
+    bool pointee[MAX_CANDIDATES];
+    unsigned numCandidates;
+    /// Number of parameters whose candidates are known.
+    unsigned numParameters;
+  };
+
+  } // End anonymous namespace
+
+  // Appends the candidates of a well formed parameter. Its types are nested
+  // in a chain, so they all complete at its end, innermost first.
+  static bool addCandidates(llvm::StringRef param, Candidates& c) {
+    bool pending[MAX_CANDIDATES];
+    unsigned numPending = 0;
+    const char* cur = param.begin();
+    const char* end = param.end();
+    while (cur != end) {
+      if (c.numCandidates + numPending == MAX_CANDIDATES)
+        return false;
+      if (*cur == 'P') {
+        pending[numPending++] = false;
+        ++cur;
+        if (cur == end || (*cur != 'r' && *cur != 'V' && *cur != 'K' &&
+            *cur != 'U'))
+          continue;
+        if (c.numCandidates + numPending == MAX_CANDIDATES)
+          return false;
+        pending[numPending++] = true;
+        while (*cur == 'r' || *cur == 'V' || *cur == 'K')
+          ++cur;
+        if (*cur == 'U')
+          cur += 5; // "U3AS<n>"
+        continue;
+      }
+      if (*cur == 'D' && cur[1] == 'v') {
+        pending[numPending++] = false;
+        while (*cur != '_')
+          ++cur;
+        ++cur;
+        continue;
+      }
+      // Source names are candidates, builtin types and substitutions not.
+      if (*cur >= '1' && *cur <= '9')
+        pending[numPending++] = false;
+      break;
+    }
+    while (numPending)
+      c.pointee[c.numCandidates++] = pending[--numPending];
+    return true;
+  }
+
+  bool recognize(llvm::StringRef s, RecognizedName& result) {
+    const RecognizerTable& table = getTable();
+    result.mangled = s;
+    result.name = llvm::StringRef();
+    result.numParameters = 0;
+    const char* const begin = s.begin();
+    const char* const end = s.end();
+    const char* cur = begin;
+    unsigned number = 0;
+    unsigned state = S_HEAD;
+    Candidates candidates;
+    while (true) {
+      unsigned c = cur != end ? table.classes[(unsigned char)*cur]
+                              : (unsigned)C_END;
+      const Transition t = table.transitions[state][c];
+      const unsigned prev = state;
+      state = t.next;
+      // Most transitions just move on.
+      if (t.actions == A_CONSUME) {
+        ++cur;
+        continue;
+      }
+      if (state == S_ERROR)
+        return false;
+      if (state == S_ACCEPT)
+        break;
+      if (t.actions & A_BOUNDARY) {
+        if (result.numParameters == RecognizedName::MAX_PARAMETERS)
+          return false;
+        result.boundaries[result.numParameters++] = cur - begin;
+      }
+      if (t.actions & (A_FIRST_DIGIT | A_DIGIT | A_SEQ_DIGIT)) {
+        unsigned base = (t.actions & A_SEQ_DIGIT) ? 36 : 10;
+        if (t.actions & A_FIRST_DIGIT)
+          number = 0;
+        else if (number > MAX_NUMBER / base)
+          return false;
+        number = number * base +
+          (*cur <= '9' ? *cur - '0' : *cur - 'A' + 10);
+      }
+      if (t.actions & A_SUBST) {
+        // The candidates of the previous parameters.
+        for (; candidates.numParameters + 1 < result.numParameters;
+             ++candidates.numParameters) {
+          unsigned i = candidates.numParameters;
+          llvm::StringRef param = s.slice(result.boundaries[i],
+                                          result.boundaries[i + 1]);
+          if (!addCandidates(param, candidates))
+            return false;
+        }
+        bool numbered = prev == S_SUBST_ID || prev == S_POINTER_SUBST_ID;
+        unsigned id = numbered ? number + 1 : 0;
+        // Only the pointee of a 'P' may be a qualified pointee.
+        bool any = prev == S_POINTER_SUBST || prev == S_POINTER_SUBST_ID;
+        if (id >= candidates.numCandidates ||
+            (candidates.pointee[id] && !any))
+          return false;
+      }
+      if (t.actions & A_SKIP) {
+        if ((size_t)(end - cur) < number)
+          return false;
+        if (t.actions & A_NAME)
+          result.name = llvm::StringRef(cur, number);
+        cur += number;
+      }
+      if (t.actions & A_CONSUME)
+        ++cur;
+    }
+    result.boundaries[result.numParameters] = s.size();
+    return true;
+  }
+
+} // End SPIR namespace
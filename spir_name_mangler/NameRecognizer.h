@@ -0,0 +1,54 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __NAME_RECOGNIZER_H__
+#define __NAME_RECOGNIZER_H__
+
+#include "DemangledName.h"
+#include "llvm/ADT/StringRef.h"
+#include <assert.h>
+
+namespace SPIR {
+
+  /// @brief The structure of a mangled name, as found by recognize(): the
+  ///        function name and the extent of each parameter. Both point into
+  ///        the mangled string.
+  struct RecognizedName {
+    /// Maximal number of parameters (the same as for DemangledName).
+    static const unsigned MAX_PARAMETERS = DemangledName::MAX_PARAMETERS;
+
+    /// The whole mangled name.
+    llvm::StringRef mangled;
+    /// The name of the function (stripped).
+    llvm::StringRef name;
+    /// Number of parameters of the function.
+    unsigned numParameters;
+    /// Offset of each parameter in the mangled name, followed by the size of
+    /// the mangled name.
+    unsigned boundaries[MAX_PARAMETERS + 1];
+
+    /// @brief Returns the mangling of the given parameter, e.g. "PU3AS1Dv4_f".
+    llvm::StringRef getParameter(unsigned i) const {
+      assert(i < numParameters && "parameter index out of range");
+      return mangled.slice(boundaries[i], boundaries[i + 1]);
+    }
+  };
+
+  /// @brief Checks whether the given string is a well formed mangled name,
+  ///        as produced by mangle(), in a single pass driven by a state
+  ///        table. Performs no allocation. Accepts the names demangle()
+  ///        accepts (without its bound on the total number of type nodes),
+  ///        including substitutions.
+  /// @param llvm::StringRef the string to check.
+  /// @param RecognizedName receives the structure of the name.
+  /// @return true if the string is a well formed mangled name, false
+  ///         otherwise (or if it has too many parameters).
+  bool recognize(llvm::StringRef, RecognizedName&);
+
+} // End SPIR namespace
+
+#endif //__NAME_RECOGNIZER_H__
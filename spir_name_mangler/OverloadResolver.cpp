@@ -0,0 +1,245 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "OverloadResolver.h"
+#include "llvm/ADT/SmallVector.h"
+#include <algorithm>
+
+namespace SPIR {
+
+  /// @brief Ranks of the conversion of an argument to a parameter type, from
+  ///        best to worst.
+  enum ConversionRank {
+    /// The same type, or a pointer gaining qualifiers.
+    RANK_EXACT,
+    /// A scalar promotion (to int, half to float, float to double).
+    RANK_PROMOTION,
+    /// Any other scalar conversion.
+    RANK_CONVERSION,
+    /// Not convertible.
+    RANK_NONE
+  };
+
+  /// The shape of all arithmetic scalars, which convert to each other (not
+  /// the bits of a PackedType).
+  static const uint32_t ScalarShape = 0xfffffffe;
+
+  static bool isArithmetic(TypePrimitiveEnum primitive) {
+    return primitive <= PRIMITIVE_DOUBLE;
+  }
+
+  /// @brief Returns the part of a type an argument and a parameter must
+  ///        agree on: anything but the qualifiers of a pointer, and the type
+  ///        of an arithmetic scalar.
+  static uint32_t getShape(PackedType type) {
+    TypePrimitiveEnum primitive = type.getPrimitive();
+    if (type.isPointer()) {
+      PackedType pointee = type.isVector() ?
+        PackedType::getVector(primitive, type.getLength()) :
+        PackedType::getPrimitive(primitive);
+      return pointee.getPointer(type.getAddressSpace()).getBits();
+    }
+    if (!type.isVector() && isArithmetic(primitive))
+      return ScalarShape;
+    return type.getBits();
+  }
+
+  static bool isPromotion(TypePrimitiveEnum from, TypePrimitiveEnum to) {
+    switch (to) {
+    case PRIMITIVE_INT:
+      return from < PRIMITIVE_UINT;
+    case PRIMITIVE_FLOAT:
+      return from == PRIMITIVE_HALF;
+    case PRIMITIVE_DOUBLE:
+      return from == PRIMITIVE_FLOAT;
+    default:
+      return false;
+    }
+  }
+
+  static ConversionRank getRank(PackedType arg, PackedType param) {
+    if (arg == param)
+      return RANK_EXACT;
+    uint32_t shape = getShape(arg);
+    if (shape != getShape(param))
+      return RANK_NONE;
+    if (shape == ScalarShape)
+      return isPromotion(arg.getPrimitive(), param.getPrimitive()) ?
+        RANK_PROMOTION : RANK_CONVERSION;
+    // Pointers to the same type, the parameter may add qualifiers.
+    if (arg.getQualifiers() & ~param.getQualifiers())
+      return RANK_NONE;
+    return RANK_EXACT;
+  }
+
+  /// @brief Returns true if all conversions of a are as good as those of b,
+  ///        and one of them is better.
+  static bool isBetter(const unsigned char* a, const unsigned char* b,
+                       unsigned n) {
+    bool better = false;
+    for (unsigned i = 0; i < n; ++i) {
+      if (a[i] > b[i])
+        return false;
+      better |= a[i] < b[i];
+    }
+    return better;
+  }
+
+  namespace {
+    /// @brief An overload, as sorted by the index.
+    struct IndexEntry {
+      unsigned family;
+      unsigned arity;
+      uint32_t shape;
+      BuiltinID id;
+
+      bool operator<(const IndexEntry& e) const {
+        if (family != e.family)
+          return family < e.family;
+        if (arity != e.arity)
+          return arity < e.arity;
+        if (shape != e.shape)
+          return shape < e.shape;
+        return id < e.id;
+      }
+    };
+  }
+
+  OverloadResolver::OverloadResolver(bool is64Bit) : m_is64Bit(is64Bit) {
+    std::vector<IndexEntry> entries(BI_NUM_BUILTINS);
+    for (unsigned i = 0; i < BI_NUM_BUILTINS; ++i) {
+      BuiltinID id = static_cast<BuiltinID>(i);
+      IndexEntry& e = entries[i];
+      e.family = getBuiltinFamily(id);
+      e.arity = getBuiltinNumParameters(id);
+      // Built-ins without parameters have a single 'void' one.
+      PackedType first = getBuiltinParameter(id, 0, is64Bit);
+      if (first == PackedType::getPrimitive(PRIMITIVE_VOID))
+        e.arity = 0;
+      e.shape = e.arity ? getShape(first) : 0;
+      e.id = id;
+    }
+    std::sort(entries.begin(), entries.end());
+
+    m_familyGroups.assign(BF_NUM_FAMILIES + 1, 0);
+    m_ids.reserve(entries.size());
+    for (unsigned i = 0; i < entries.size(); ++i) {
+      const IndexEntry& e = entries[i];
+      if (i == 0 || e.family != entries[i - 1].family ||
+          e.arity != entries[i - 1].arity ||
+          e.shape != entries[i - 1].shape) {
+        if (!m_groups.empty())
+          m_groups.back().end = m_ids.size();
+        Group group;
+        group.arity = e.arity;
+        group.shape = e.shape;
+        group.begin = m_ids.size();
+        group.end = m_ids.size();
+        group.parameters = m_parameters.size();
+        m_groups.push_back(group);
+      }
+      m_ids.push_back(e.id);
+      for (unsigned p = 0; p < e.arity; ++p)
+        m_parameters.push_back(getBuiltinParameter(e.id, p, is64Bit));
+      // Families are sorted, the next one starts after this group at least.
+      m_familyGroups[e.family + 1] = m_groups.size();
+    }
+    if (!m_groups.empty())
+      m_groups.back().end = m_ids.size();
+    // Families without built-ins (none, in practice) have no groups.
+    for (unsigned f = 1; f <= BF_NUM_FAMILIES; ++f)
+      m_familyGroups[f] = std::max(m_familyGroups[f], m_familyGroups[f - 1]);
+
+    for (unsigned f = 0; f < BF_NUM_FAMILIES; ++f)
+      m_families[getBuiltinFamilyName(static_cast<BuiltinFamily>(f))] = f;
+  }
+
+  OverloadResult OverloadResolver::resolve(
+    llvm::StringRef name, llvm::ArrayRef<PackedType> args) const {
+    OverloadResult result;
+    result.status = OVERLOAD_NO_MATCH;
+    result.id = BI_NUM_BUILTINS;
+    result.is64Bit = m_is64Bit;
+    llvm::StringMap<unsigned>::const_iterator family = m_families.find(name);
+    if (family == m_families.end())
+      return result;
+
+    unsigned arity = args.size();
+    uint32_t shape = arity ? getShape(args[0]) : 0;
+    const Group* group = NULL;
+    for (unsigned g = m_familyGroups[family->second];
+         g < m_familyGroups[family->second + 1]; ++g) {
+      if (m_groups[g].arity == arity && m_groups[g].shape == shape) {
+        group = &m_groups[g];
+        break;
+      }
+    }
+    if (!group)
+      return result;
+
+    // The ranks of the conversions to each viable overload.
+    llvm::SmallVector<unsigned char, 64> ranks;
+    llvm::SmallVector<unsigned, 16> viable;
+    const PackedType* params = &m_parameters[group->parameters];
+    for (unsigned c = group->begin; c < group->end; ++c, params += arity) {
+      // Overloads differ, one with the types of the arguments is the best.
+      if (std::equal(args.begin(), args.end(), params)) {
+        result.status = OVERLOAD_FOUND;
+        result.id = m_ids[c];
+        return result;
+      }
+      size_t start = ranks.size();
+      unsigned i = 0;
+      for (; i < arity; ++i) {
+        ConversionRank rank = getRank(args[i], params[i]);
+        if (rank == RANK_NONE)
+          break;
+        ranks.push_back(rank);
+      }
+      if (i < arity) {
+        ranks.resize(start);
+        continue;
+      }
+      viable.push_back(c);
+    }
+    if (viable.empty())
+      return result;
+
+    // Find the best candidate, then check it is better than all others.
+    unsigned best = 0;
+    for (unsigned v = 1; v < viable.size(); ++v)
+      if (isBetter(&ranks[v * arity], &ranks[best * arity], arity))
+        best = v;
+    for (unsigned v = 0; v < viable.size(); ++v) {
+      if (v != best &&
+          !isBetter(&ranks[best * arity], &ranks[v * arity], arity)) {
+        result.status = OVERLOAD_AMBIGUOUS;
+        return result;
+      }
+    }
+    result.status = OVERLOAD_FOUND;
+    result.id = m_ids[viable[best]];
+    return result;
+  }
+
+  OverloadResult OverloadResolver::resolve(
+    llvm::StringRef name, llvm::ArrayRef<RefParamType> args) const {
+    llvm::SmallVector<PackedType, 8> packed;
+    for (unsigned i = 0; i < args.size(); ++i) {
+      packed.push_back(PackedType::get(args[i]));
+      if (!packed.back().isValid()) {
+        OverloadResult result;
+        result.status = OVERLOAD_NO_MATCH;
+        result.id = BI_NUM_BUILTINS;
+        result.is64Bit = m_is64Bit;
+        return result;
+      }
+    }
+    return resolve(name, packed);
+  }
+
+} // End SPIR namespace
@@ -0,0 +1,122 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __OVERLOAD_RESOLVER_H__
+#define __OVERLOAD_RESOLVER_H__
+
+#include "BuiltinTable.h"
+#include "FunctionDescriptor.h"
+#include "PackedType.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/DataTypes.h"
+#include <vector>
+
+namespace SPIR {
+
+  /// @brief The outcome of an overload resolution.
+  enum OverloadStatus {
+    /// A single best overload was found.
+    OVERLOAD_FOUND,
+    /// No overload accepts the arguments.
+    OVERLOAD_NO_MATCH,
+    /// Several overloads accept the arguments, none of them is better than
+    /// all others.
+    OVERLOAD_AMBIGUOUS
+  };
+
+  /// @brief The overload chosen by OverloadResolver::resolve().
+  struct OverloadResult {
+    OverloadStatus status;
+    /// The overload, BI_NUM_BUILTINS unless found.
+    BuiltinID id;
+    bool is64Bit;
+
+    bool isFound() const {
+      return status == OVERLOAD_FOUND;
+    }
+
+    /// @brief Returns the mangled name of the overload.
+    llvm::StringRef getMangledName() const {
+      return getBuiltinMangledName(id, is64Bit);
+    }
+
+    /// @brief Builds the function descriptor of the overload.
+    FunctionDescriptor getDescriptor() const {
+      return getBuiltinDescriptor(id, is64Bit);
+    }
+  };
+
+  /// @brief Finds the built-in overload called by a call to a built-in with
+  ///        arguments of the given types, with the rules of the front end:
+  ///        an argument may be converted to the parameter type when both are
+  ///        scalars (a promotion is better than other conversions), and a
+  ///        pointer argument may gain qualifiers. Vectors, pointees, address
+  ///        spaces and opaque types must match exactly. The best overload is
+  ///        the one whose conversions are all as good as those of any other
+  ///        overload, and one of them better.
+  ///
+  ///        The overloads are indexed by name, then number of parameters,
+  ///        then the shape of the first parameter, so a resolution only
+  ///        ranks the few overloads which can possibly match.
+  class OverloadResolver {
+  public:
+    /// @brief Indexes the built-ins of BuiltinTable.h.
+    /// @param bool true for SPIR64.
+    explicit OverloadResolver(bool is64Bit);
+
+    /// @brief Finds the overload of a built-in called with the given
+    ///        arguments.
+    /// @param llvm::StringRef the name of the built-in (not mangled).
+    /// @param llvm::ArrayRef<PackedType> the types of the arguments (none
+    ///        for a call without arguments).
+    OverloadResult resolve(llvm::StringRef name,
+                           llvm::ArrayRef<PackedType> args) const;
+
+    /// @brief Same as above, for arguments described by ParamTypes. An
+    ///        argument of a type PackedType cannot represent matches no
+    ///        overload.
+    OverloadResult resolve(llvm::StringRef name,
+                           llvm::ArrayRef<RefParamType> args) const;
+
+    bool is64Bit() const {
+      return m_is64Bit;
+    }
+
+  private:
+    OverloadResolver(const OverloadResolver&);
+    OverloadResolver& operator=(const OverloadResolver&);
+
+    /// @brief The overloads of a name with the same number of parameters and
+    ///        first parameter shape.
+    struct Group {
+      unsigned arity;
+      uint32_t shape;
+      /// The overloads, in m_ids.
+      unsigned begin;
+      unsigned end;
+      /// The parameters of the first overload, in m_parameters.
+      unsigned parameters;
+    };
+
+    bool m_is64Bit;
+    /// The family of each built-in name.
+    llvm::StringMap<unsigned> m_families;
+    /// First group of each family, followed by the number of groups.
+    std::vector<unsigned> m_familyGroups;
+    std::vector<Group> m_groups;
+    /// The overloads of each group, back to back.
+    std::vector<BuiltinID> m_ids;
+    /// The parameters of each overload of m_ids, back to back (without the
+    /// 'void' of built-ins without parameters).
+    std::vector<PackedType> m_parameters;
+  };
+
+} // End SPIR namespace
+
+#endif //__OVERLOAD_RESOLVER_H__
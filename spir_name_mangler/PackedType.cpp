@@ -0,0 +1,188 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "PackedType.h"
+#include "ManglingUtils.h"
+#include "StaticTables.h"
+#include <assert.h>
+
+namespace SPIR {
+
+  /// @brief A string with its length, so the tables below are
+  ///        initialized statically.
+  struct TableString {
+    const char* str;
+    unsigned len;
+  };
+
+#define TABLE_STRING(s) { s, sizeof(s) - 1 }
+
+  // The mangled primitives (see MangledPrimitives) with their lengths.
+#define PACKED_PRIMITIVE(p) \
+    { MangledPrimitives[p], (unsigned)staticLength(MangledPrimitives[p]) }
+
+  static const TableString PackedPrimitives[PRIMITIVE_NUM] = {
+    PACKED_PRIMITIVE(PRIMITIVE_BOOL),
+    PACKED_PRIMITIVE(PRIMITIVE_UCHAR),
+    PACKED_PRIMITIVE(PRIMITIVE_CHAR),
+    PACKED_PRIMITIVE(PRIMITIVE_USHORT),
+    PACKED_PRIMITIVE(PRIMITIVE_SHORT),
+    PACKED_PRIMITIVE(PRIMITIVE_UINT),
+    PACKED_PRIMITIVE(PRIMITIVE_INT),
+    PACKED_PRIMITIVE(PRIMITIVE_ULONG),
+    PACKED_PRIMITIVE(PRIMITIVE_LONG),
+    PACKED_PRIMITIVE(PRIMITIVE_HALF),
+    PACKED_PRIMITIVE(PRIMITIVE_FLOAT),
+    PACKED_PRIMITIVE(PRIMITIVE_DOUBLE),
+    PACKED_PRIMITIVE(PRIMITIVE_VOID),
+    PACKED_PRIMITIVE(PRIMITIVE_VAR_ARG),
+    PACKED_PRIMITIVE(PRIMITIVE_IMAGE_1D_T),
+    PACKED_PRIMITIVE(PRIMITIVE_IMAGE_2D_T),
+    PACKED_PRIMITIVE(PRIMITIVE_IMAGE_3D_T),
+    PACKED_PRIMITIVE(PRIMITIVE_IMAGE_1D_BUFFER_T),
+    PACKED_PRIMITIVE(PRIMITIVE_IMAGE_1D_ARRAY_T),
+    PACKED_PRIMITIVE(PRIMITIVE_IMAGE_2D_ARRAY_T),
+    PACKED_PRIMITIVE(PRIMITIVE_EVENT_T),
+    PACKED_PRIMITIVE(PRIMITIVE_SAMPLER_T)
+  };
+
+#undef PACKED_PRIMITIVE
+
+  // Pointer prefixes, indexed by the qualifiers mask. Qualifiers are mangled
+  // in TypeAttributeEnum order.
+  static const TableString PackedQualifiers[8] = {
+    TABLE_STRING("P"),
+    TABLE_STRING("Pr"),
+    TABLE_STRING("PV"),
+    TABLE_STRING("PrV"),
+    TABLE_STRING("PK"),
+    TABLE_STRING("PrK"),
+    TABLE_STRING("PVK"),
+    TABLE_STRING("PrVK")
+  };
+
+  // Indexed by the address space, relative to ATTR_ADDR_SPACE_FIRST.
+  static const TableString PackedAddressSpaces[4] = {
+    TABLE_STRING(""),
+    TABLE_STRING("U3AS1"),
+    TABLE_STRING("U3AS2"),
+    TABLE_STRING("U3AS3")
+  };
+
+#undef TABLE_STRING
+
+  static void append(llvm::SmallVectorImpl<char>& out, const TableString& s) {
+    out.append(s.str, s.str + s.len);
+  }
+
+  PackedType PackedType::getPrimitive(TypePrimitiveEnum primitive) {
+    assert(primitive >= PRIMITIVE_FIRST && primitive <= PRIMITIVE_LAST &&
+           "invalid primitive type");
+    return fromBits(primitive);
+  }
+
+  PackedType PackedType::getVector(TypePrimitiveEnum scalar, unsigned len) {
+    assert(scalar >= PRIMITIVE_FIRST && scalar <= PRIMITIVE_LAST &&
+           "invalid primitive type");
+    if (len == 0 || len > LENGTH_MASK)
+      return PackedType();
+    return fromBits(scalar | (len << LENGTH_SHIFT));
+  }
+
+  PackedType PackedType::getPointer(TypeAttributeEnum addressSpace,
+                                    unsigned qualifiers) const {
+    assert(addressSpace >= ATTR_ADDR_SPACE_FIRST &&
+           addressSpace <= ATTR_ADDR_SPACE_LAST && "invalid address space");
+    assert(qualifiers <= QUALIFIERS_MASK && "invalid qualifiers");
+    if (!isValid() || isPointer())
+      return PackedType();
+    return fromBits(m_bits | POINTER_BIT |
+      ((addressSpace - ATTR_ADDR_SPACE_FIRST) << ADDR_SPACE_SHIFT) |
+      (qualifiers << QUALIFIERS_SHIFT));
+  }
+
+  // Encodes a primitive or vector type, the only possible pointees.
+  static PackedType getValue(const ParamType* type) {
+    if (const PrimitiveType* p = dyn_cast<PrimitiveType>(type))
+      return PackedType::getPrimitive(p->getPrimitive());
+    if (const VectorType* v = dyn_cast<VectorType>(type)) {
+      const PrimitiveType* scalar =
+        dyn_cast<PrimitiveType>(v->getScalarType());
+      if (scalar && v->getLength() > 0)
+        return PackedType::getVector(scalar->getPrimitive(), v->getLength());
+    }
+    return PackedType();
+  }
+
+  PackedType PackedType::get(const ParamType* type) {
+    assert(type && "packing a NULL type");
+    const PointerType* p = dyn_cast<PointerType>(type);
+    if (!p)
+      return getValue(type);
+    unsigned qualifiers = 0;
+    for (unsigned i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
+      if (p->hasQualifier((TypeAttributeEnum)i))
+        qualifiers |= 1U << (i - ATTR_QUALIFIER_FIRST);
+    }
+    return getValue(p->getPointee()).getPointer(p->getAddressSpace(),
+                                                qualifiers);
+  }
+
+  RefParamType PackedType::toParamType() const {
+    assert(isValid() && "converting an invalid type");
+    RefParamType type(new PrimitiveType(getPrimitive()));
+    if (isVector())
+      type = RefParamType(new VectorType(type, getLength()));
+    if (!isPointer())
+      return type;
+    PointerType* p = new PointerType(type);
+    p->setAddressSpace(getAddressSpace());
+    for (unsigned i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
+      TypeAttributeEnum qual = (TypeAttributeEnum)i;
+      p->setQualifier(qual, hasQualifier(qual));
+    }
+    return RefParamType(p);
+  }
+
+  void PackedType::mangle(llvm::SmallVectorImpl<char>& out) const {
+    assert(isValid() && "mangling an invalid type");
+    if (isPointer()) {
+      append(out, PackedQualifiers[getQualifiers()]);
+      append(out, PackedAddressSpaces[getAddressSpace() -
+                                      ATTR_ADDR_SPACE_FIRST]);
+    }
+    if (unsigned len = getLength()) {
+      out.push_back('D');
+      out.push_back('v');
+      appendNumber(out, len);
+      out.push_back('_');
+    }
+    append(out, PackedPrimitives[getPrimitive()]);
+  }
+
+  size_t PackedType::mangledLength() const {
+    assert(isValid() && "mangling an invalid type");
+    size_t len = PackedPrimitives[getPrimitive()].len;
+    if (isPointer())
+      len += PackedQualifiers[getQualifiers()].len +
+        PackedAddressSpaces[getAddressSpace() - ATTR_ADDR_SPACE_FIRST].len;
+    if (unsigned vlen = getLength())
+      len += 3 + getNumberLength(vlen);
+    return len;
+  }
+
+  void mangle(llvm::StringRef name, llvm::ArrayRef<PackedType> parameters,
+              llvm::SmallVectorImpl<char>& out) {
+    out.push_back('_');
+    out.push_back('Z');
+    appendNumber(out, name.size());
+    appendString(out, name);
+    for (size_t i = 0, e = parameters.size(); i < e; ++i)
+      parameters[i].mangle(out);
+  }
+
+} // End SPIR namespace
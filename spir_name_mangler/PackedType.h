@@ -0,0 +1,154 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __PACKED_TYPE_H__
+#define __PACKED_TYPE_H__
+
+#include "ParameterType.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/DataTypes.h"
+#include <stddef.h>
+
+namespace SPIR {
+
+  /// @brief A parameter type of one of the shapes almost all built-ins use,
+  ///        encoded in a single 32 bit value:
+  ///        a primitive, a vector of a primitive, or a pointer to one of those.
+  ///        Unlike ParamType, it is a plain value: it needs no allocation, and
+  ///        comparing or mangling it involves no virtual calls.
+  ///
+  ///        Bits  0-4:   TypePrimitiveEnum.
+  ///        Bits  5-9:   vector length (0 for scalars).
+  ///        Bit   10:    set for pointers.
+  ///        Bits 11-12:  address space (relative to ATTR_ADDR_SPACE_FIRST).
+  ///        Bits 13-15:  qualifiers, a bit per TypeAttributeEnum qualifier
+  ///                     (relative to ATTR_QUALIFIER_FIRST).
+  class PackedType {
+  public:
+    /// @brief Creates an invalid type.
+    PackedType() : m_bits(INVALID) {
+    }
+
+    /// @brief Returns the packed primitive type.
+    static PackedType getPrimitive(TypePrimitiveEnum primitive);
+
+    /// @brief Returns the packed vector type, or an invalid type if the length
+    ///        does not fit.
+    static PackedType getVector(TypePrimitiveEnum scalar, unsigned len);
+
+    /// @brief Returns a pointer to this type, or an invalid type if this is
+    ///        already a pointer.
+    /// @param TypeAttributeEnum address space of the pointer.
+    /// @param unsigned qualifiers, a mask with a bit
+    ///        (1 << (qual - ATTR_QUALIFIER_FIRST)) set per enabled qualifier.
+    PackedType getPointer(TypeAttributeEnum addressSpace = ATTR_PRIVATE,
+                          unsigned qualifiers = 0) const;
+
+    /// @brief Encodes the given type.
+    /// @return the packed type, or an invalid type if the given one does not
+    ///         have one of the supported shapes.
+    static PackedType get(const ParamType*);
+
+    /// @brief Returns a (heap allocated) ParamType equal to this type.
+    RefParamType toParamType() const;
+
+    /// @brief Rebuilds a packed type from the value of getBits().
+    static PackedType fromBits(uint32_t bits) {
+      PackedType t;
+      t.m_bits = bits;
+      return t;
+    }
+
+    uint32_t getBits() const {
+      return m_bits;
+    }
+
+    bool isValid() const {
+      return m_bits != INVALID;
+    }
+
+    bool isPointer() const {
+      return m_bits & POINTER_BIT;
+    }
+
+    bool isVector() const {
+      return getLength() != 0;
+    }
+
+    /// @brief Returns the primitive type, or the scalar type of the vector
+    ///        (pointee).
+    TypePrimitiveEnum getPrimitive() const {
+      return (TypePrimitiveEnum)(m_bits & PRIMITIVE_MASK);
+    }
+
+    /// @brief Returns the length of the vector (pointee), 0 for scalars.
+    unsigned getLength() const {
+      return (m_bits >> LENGTH_SHIFT) & LENGTH_MASK;
+    }
+
+    /// @brief Returns the address space of a pointer.
+    TypeAttributeEnum getAddressSpace() const {
+      return (TypeAttributeEnum)(ATTR_ADDR_SPACE_FIRST +
+        ((m_bits >> ADDR_SPACE_SHIFT) & ADDR_SPACE_MASK));
+    }
+
+    /// @brief Returns the qualifiers mask of a pointer.
+    unsigned getQualifiers() const {
+      return (m_bits >> QUALIFIERS_SHIFT) & QUALIFIERS_MASK;
+    }
+
+    bool hasQualifier(TypeAttributeEnum qual) const {
+      return getQualifiers() & (1U << (qual - ATTR_QUALIFIER_FIRST));
+    }
+
+    /// @brief Appends the mangled type to the buffer.
+    void mangle(llvm::SmallVectorImpl<char>&) const;
+
+    /// @brief Returns the length of the mangled type.
+    size_t mangledLength() const;
+
+    bool operator==(PackedType t) const {
+      return m_bits == t.m_bits;
+    }
+
+    bool operator!=(PackedType t) const {
+      return m_bits != t.m_bits;
+    }
+
+    bool operator<(PackedType t) const {
+      return m_bits < t.m_bits;
+    }
+
+  private:
+    enum {
+      PRIMITIVE_MASK = 0x1f,
+      LENGTH_SHIFT = 5,
+      LENGTH_MASK = 0x1f,
+      POINTER_BIT = 1 << 10,
+      ADDR_SPACE_SHIFT = 11,
+      ADDR_SPACE_MASK = 0x3,
+      QUALIFIERS_SHIFT = 13,
+      QUALIFIERS_MASK = 0x7,
+      INVALID = 0xffffffff
+    };
+
+    uint32_t m_bits;
+  };
+
+  /// @brief Appends the mangled name of a function with packed parameter
+  ///        types to the buffer.
+  /// @param llvm::StringRef function name.
+  /// @param llvm::ArrayRef<PackedType> parameters, all valid.
+  /// @param llvm::SmallVectorImpl<char> buffer to append to.
+  void mangle(llvm::StringRef name, llvm::ArrayRef<PackedType> parameters,
+              llvm::SmallVectorImpl<char>& out);
+
+} // End SPIR namespace
+
+#endif //__PACKED_TYPE_H__
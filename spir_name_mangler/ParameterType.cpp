@@ -7,11 +7,87 @@
 
 #include "ParameterType.h"
 #include "ManglingUtils.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/SmallString.h"
 #include <assert.h>
 #include <cctype>
-#include <sstream>
 
 namespace SPIR {
+  //
+  // Param Type
+  //
+
+  size_t ParamType::getHash() const {
+    if (m_context)
+      return m_hash;
+    // Mix the fields of the node with the hash of its sub type.
+    switch (m_typeId) {
+    case TYPE_ID_PRIMITIVE:
+      return combineHash(m_typeId,
+        static_cast<const PrimitiveType*>(this)->getPrimitive());
+    case TYPE_ID_VECTOR: {
+      const VectorType* v = static_cast<const VectorType*>(this);
+      return combineHash(combineHash(m_typeId, v->getLength()),
+                         v->getScalarType()->getHash());
+    }
+    case TYPE_ID_POINTER: {
+      const PointerType* p = static_cast<const PointerType*>(this);
+      unsigned attributes = p->getAddressSpace();
+      for (unsigned i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
+        if (p->hasQualifier((TypeAttributeEnum)i))
+          attributes |= 1U << (ATTR_NUM + i);
+      }
+      return combineHash(combineHash(m_typeId, attributes),
+                         p->getPointee()->getHash());
+    }
+    case TYPE_ID_STRUCTURE:
+      return combineHash(m_typeId, llvm::hash_value(
+        static_cast<const UserDefinedType*>(this)->getName()));
+    }
+    assert(false && "unknown type id");
+    return 0;
+  }
+
+  static int compareInts(int l, int r) {
+    return (l < r) ? -1 : (l > r);
+  }
+
+  int ParamType::compare(const ParamType* type) const {
+    if (this == type)
+      return 0;
+    if (m_typeId != type->m_typeId)
+      return compareInts(m_typeId, type->m_typeId);
+    switch (m_typeId) {
+    case TYPE_ID_PRIMITIVE:
+      return compareInts(static_cast<const PrimitiveType*>(this)->getPrimitive(),
+        static_cast<const PrimitiveType*>(type)->getPrimitive());
+    case TYPE_ID_VECTOR: {
+      const VectorType* l = static_cast<const VectorType*>(this);
+      const VectorType* r = static_cast<const VectorType*>(type);
+      if (int cmp = compareInts(l->getLength(), r->getLength()))
+        return cmp;
+      return l->getScalarType()->compare(r->getScalarType());
+    }
+    case TYPE_ID_POINTER: {
+      const PointerType* l = static_cast<const PointerType*>(this);
+      const PointerType* r = static_cast<const PointerType*>(type);
+      if (int cmp = compareInts(l->getAddressSpace(), r->getAddressSpace()))
+        return cmp;
+      for (unsigned i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
+        TypeAttributeEnum qual = (TypeAttributeEnum)i;
+        if (int cmp = compareInts(l->hasQualifier(qual), r->hasQualifier(qual)))
+          return cmp;
+      }
+      return l->getPointee()->compare(r->getPointee());
+    }
+    case TYPE_ID_STRUCTURE:
+      return static_cast<const UserDefinedType*>(this)->getName().compare(
+        static_cast<const UserDefinedType*>(type)->getName());
+    }
+    assert(false && "unknown type id");
+    return 0;
+  }
+
   //
   // Primitive Type
   //
@@ -27,12 +103,20 @@ namespace SPIR {
   std::string PrimitiveType::toString() const {
     assert( (m_primitive >= PRIMITIVE_FIRST
       && m_primitive <= PRIMITIVE_LAST) && "illegal primitive");
-    std::stringstream myName;
-    myName << readablePrimitiveString(m_primitive);
-    return myName.str();
+    return readablePrimitiveString(m_primitive);
+  }
+
+  void PrimitiveType::toString(llvm::SmallVectorImpl<char>& out) const {
+    assert( (m_primitive >= PRIMITIVE_FIRST
+      && m_primitive <= PRIMITIVE_LAST) && "illegal primitive");
+    appendString(out, readablePrimitiveString(m_primitive));
   }
 
   bool PrimitiveType::equals(const ParamType* type) const {
+    if (this == type)
+      return true;
+    if (isUniquedWith(type))
+      return false;
     const PrimitiveType* p = SPIR::dyn_cast<PrimitiveType>(type);
     return p && (m_primitive == p->m_primitive);
   }
@@ -55,6 +139,7 @@ namespace SPIR {
   }
 
   void PointerType::setAddressSpace(TypeAttributeEnum attr) {
+    assert(!m_context && "modifying a type owned by a TypeContext");
     if (attr < ATTR_ADDR_SPACE_FIRST || attr > ATTR_ADDR_SPACE_LAST) {
       return;
     }
@@ -66,6 +151,7 @@ namespace SPIR {
   }
 
   void PointerType::setQualifier(TypeAttributeEnum qual, bool enabled) {
+    assert(!m_context && "modifying a type owned by a TypeContext");
     if (qual < ATTR_QUALIFIER_FIRST || qual > ATTR_QUALIFIER_LAST) {
       return;
     }
@@ -80,19 +166,30 @@ namespace SPIR {
   }
 
   std::string PointerType::toString() const {
-    std::stringstream myName;
+    llvm::SmallString<64> myName;
+    toString(myName);
+    return myName.str().str();
+  }
+
+  void PointerType::toString(llvm::SmallVectorImpl<char>& out) const {
     for (unsigned int i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
       TypeAttributeEnum qual = (TypeAttributeEnum)i;
       if (hasQualifier(qual)) {
-        myName << getReadableAttribute(qual) << " ";
+        appendString(out, getReadableAttribute(qual));
+        out.push_back(' ');
       }
     }
-    myName << getReadableAttribute(TypeAttributeEnum(m_address_space)) << " ";
-    myName << getPointee()->toString() << " *";
-    return myName.str();
+    appendString(out, getReadableAttribute(TypeAttributeEnum(m_address_space)));
+    out.push_back(' ');
+    getPointee()->toString(out);
+    appendString(out, " *");
   }
 
   bool PointerType::equals(const ParamType* type) const {
+    if (this == type)
+      return true;
+    if (isUniquedWith(type))
+      return false;
     const PointerType* p = SPIR::dyn_cast<PointerType>(type);
     if (!p) {
       return false;
@@ -122,13 +219,21 @@ namespace SPIR {
   }
 
   std::string VectorType::toString() const {
-    std::stringstream myName;
-    myName << getScalarType()->toString();
-    myName << m_len;
-    return myName.str();
+    llvm::SmallString<16> myName;
+    toString(myName);
+    return myName.str().str();
+  }
+
+  void VectorType::toString(llvm::SmallVectorImpl<char>& out) const {
+    getScalarType()->toString(out);
+    appendNumber(out, m_len);
   }
 
   bool VectorType::equals(const ParamType* type) const {
+    if (this == type)
+      return true;
+    if (isUniquedWith(type))
+      return false;
     const VectorType* pVec = SPIR::dyn_cast<VectorType>(type);
     return pVec && (m_len == pVec->m_len) &&
       (*getScalarType()).equals(&*(pVec->getScalarType()));
@@ -146,12 +251,18 @@ namespace SPIR {
   }
 
   std::string UserDefinedType::toString() const {
-    std::stringstream myName;
-    myName << m_name;
-    return myName.str();
+    return m_name;
+  }
+
+  void UserDefinedType::toString(llvm::SmallVectorImpl<char>& out) const {
+    appendString(out, m_name);
   }
 
   bool UserDefinedType::equals(const ParamType* pType) const {
+    if (this == pType)
+      return true;
+    if (isUniquedWith(pType))
+      return false;
     const UserDefinedType* pTy = SPIR::dyn_cast<UserDefinedType>(pType);
     return pTy && (m_name == pTy->m_name);
   }
@@ -166,3 +277,13 @@ namespace SPIR {
   const TypeEnum UserDefinedType::enumTy  = TYPE_ID_STRUCTURE;
 
 } // End SPIR namespace
+
+namespace llvm {
+
+  SPIR::ParamType* DenseMapInfo<SPIR::RefParamType>::getTombstone() {
+    static SPIR::RefParamType tombstone(
+      new SPIR::UserDefinedType("<tombstone>"));
+    return tombstone;
+  }
+
+} // End llvm namespace
@@ -9,6 +9,11 @@
 #define __PARAMETER_TYPE_H__
 
 #include "Refcount.h"
+#include "llvm/ADT/DenseMapInfo.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/SmallVector.h"
+#include <functional>
+#include <stddef.h>
 #include <string>
 #include <vector>
 
@@ -79,10 +84,14 @@ namespace SPIR {
   // Forward declaration for abstract structure.
   struct TypeVisitor;
 
-  struct ParamType {
+  class TypeArena;
+  class TypeContext;
+
+  struct ParamType : public RefCounted {
     /// @brief Constructor.
     /// @param TypeEnum type id.
-    ParamType(TypeEnum typeId) : m_typeId(typeId) {};
+    ParamType(TypeEnum typeId) : m_typeId(typeId), m_arena(NULL),
+      m_context(NULL), m_hash(0) {};
 
     /// @brief Destructor.
     virtual ~ParamType() {};
@@ -99,6 +108,11 @@ namespace SPIR {
     /// @return type as string.
     virtual std::string toString() const = 0;
 
+    /// @brief Appends a string representation of the underlying type to the
+    ///        given buffer.
+    /// @param llvm::SmallVectorImpl<char> buffer to append to.
+    virtual void toString(llvm::SmallVectorImpl<char>&) const = 0;
+
     /// @brief Returns true if given param type is equal to this type.
     /// @param ParamType given param type.
     /// @return true if given param type is equal to this type and false otherwise.
@@ -112,13 +126,53 @@ namespace SPIR {
       return m_typeId;
     }
 
+    /// @brief Returns the arena this type was allocated in, if any.
+    /// @return owning arena, or NULL for a heap allocated type.
+    const TypeArena* getArena() const {
+      return m_arena;
+    }
+
+    /// @brief Returns the context which owns this type, if any. Types owned by
+    ///        a TypeContext are unique within it and must not be modified.
+    /// @return owning context, or NULL for a free standing type.
+    const TypeContext* getContext() const {
+      return m_context;
+    }
+
+    /// @brief Returns a hash of the structure of this type. Structurally
+    ///        equal types have equal hashes.
+    ///        The hash is precomputed for types owned by a TypeContext.
+    /// @return structural hash.
+    size_t getHash() const;
+
+    /// @brief Structural three-way comparison, consistent with equals().
+    /// @param ParamType given param type.
+    /// @return a negative number, zero or a positive number if this type is
+    ///         ordered before, equal to or after the given type.
+    int compare(const ParamType*) const;
+
   private:
     // @brief Default Constructor.
     ParamType();
 
+    friend class TypeArena;
+    friend class TypeContext;
+
   protected:
+    /// @brief Returns true if both types are owned by the same context. Two
+    ///        distinct such types are never equal.
+    bool isUniquedWith(const ParamType* type) const {
+      return m_context && m_context == type->m_context;
+    }
+
     /// An enumeration to identify the type id of this instance.
     TypeEnum m_typeId;
+    /// The arena this type was allocated in (NULL if none).
+    const TypeArena* m_arena;
+    /// The context owning this type (NULL if none).
+    const TypeContext* m_context;
+    /// Structural hash, valid only if m_context is set.
+    size_t m_hash;
   };
 
 
@@ -142,6 +196,11 @@ namespace SPIR {
     /// @return type as string.
     std::string toString() const;
 
+    /// @brief Appends a string representation of the underlying type to the
+    ///        given buffer.
+    /// @param llvm::SmallVectorImpl<char> buffer to append to.
+    void toString(llvm::SmallVectorImpl<char>&) const;
+
     /// @brief Returns true if given param type is equal to this type.
     /// @param ParamType given param type.
     /// @return true if given param type is equal to this type and false otherwise.
@@ -180,6 +239,11 @@ namespace SPIR {
     /// @return type as string.
     std::string toString() const;
 
+    /// @brief Appends a string representation of the underlying type to the
+    ///        given buffer.
+    /// @param llvm::SmallVectorImpl<char> buffer to append to.
+    void toString(llvm::SmallVectorImpl<char>&) const;
+
     /// @brief Returns true if given param type is equal to this type.
     /// @param ParamType given param type.
     /// @return true if given param type is equal to this type and false otherwise.
@@ -242,6 +306,11 @@ namespace SPIR {
     /// @return type as string.
     std::string toString() const;
 
+    /// @brief Appends a string representation of the underlying type to the
+    ///        given buffer.
+    /// @param llvm::SmallVectorImpl<char> buffer to append to.
+    void toString(llvm::SmallVectorImpl<char>&) const;
+
     /// @brief Returns true if given param type is equal to this type.
     /// @param ParamType given param type.
     /// @return true if given param type is equal to this type and false otherwise.
@@ -288,11 +357,24 @@ namespace SPIR {
     /// @return type as string.
     std::string toString() const;
 
+    /// @brief Appends a string representation of the underlying type to the
+    ///        given buffer.
+    /// @param llvm::SmallVectorImpl<char> buffer to append to.
+    void toString(llvm::SmallVectorImpl<char>&) const;
+
     /// @brief Returns true if given param type is equal to this type.
     /// @param ParamType given param type.
     /// @return true if given param type is equal to this type and false otherwise.
     bool equals(const ParamType*) const;
 
+    /// Non-Common Methods ///
+
+    /// @brief Returns the name of the type.
+    /// @return type name.
+    const std::string& getName() const {
+      return m_name;
+    }
+
   protected:
     /// The name of the user defined type.
     std::string m_name;
@@ -329,5 +411,66 @@ namespace SPIR {
     return (T::enumTy == pType->getTypeId()) ? (const T*)pType : NULL;
   }
 
+  /// @brief Structural hash of a type, for use with llvm::hash_combine.
+  inline llvm::hash_code hash_value(const ParamType& type) {
+    return type.getHash();
+  }
+
+  /// @brief Structural equality of types, for hash containers which should
+  ///        find equal types built separately (handles compare the nodes'
+  ///        addresses), e.g.
+  ///        std::unordered_set<RefParamType, std::hash<RefParamType>,
+  ///        ParamTypeEqual>.
+  struct ParamTypeEqual {
+    bool operator()(const RefParamType& l, const RefParamType& r) const {
+      if (l.isNull() || r.isNull())
+        return l.isNull() == r.isNull();
+      return l->equals(r);
+    }
+  };
+
 } // End SPIR namespace
+
+// Structural hash, consistent with both ParamTypeEqual and the handles'
+// address comparison.
+namespace std {
+  template <>
+  struct hash<SPIR::RefParamType> {
+    size_t operator()(const SPIR::RefParamType& type) const {
+      return type.isNull() ? 0 : type->getHash();
+    }
+  };
+} // End std namespace
+
+namespace llvm {
+  template <>
+  struct DenseMapInfo<SPIR::RefParamType> {
+    static SPIR::RefParamType getEmptyKey() {
+      return SPIR::RefParamType();
+    }
+
+    static SPIR::RefParamType getTombstoneKey() {
+      return getTombstone();
+    }
+
+    static unsigned getHashValue(const SPIR::RefParamType& type) {
+      return std::hash<SPIR::RefParamType>()(type);
+    }
+
+    static bool isEqual(const SPIR::RefParamType& l,
+                        const SPIR::RefParamType& r) {
+      const SPIR::ParamType* lp = l;
+      const SPIR::ParamType* rp = r;
+      // The special keys only equal themselves.
+      const SPIR::ParamType* tombstone = getTombstone();
+      if (!lp || !rp || lp == tombstone || rp == tombstone)
+        return lp == rp;
+      return lp->equals(rp);
+    }
+
+  private:
+    /// A sentinel type, which is never handed out otherwise.
+    static SPIR::ParamType* getTombstone();
+  };
+} // End llvm namespace
 #endif //__PARAMETER_TYPE_H__
@@ -9,42 +9,107 @@
 #define __REF_COUNT_H__
 
 #include <assert.h>
+#include <atomic>
 
 namespace SPIR {
 
+/// @brief Base class of the objects managed by RefCount. The reference counter
+///        lives in the object itself, and is updated atomically, so objects
+///        may be shared between threads.
+class RefCounted {
+public:
+  RefCounted(): m_refCount(0) {
+  }
+
+  /// @brief Copies of an object start with no references.
+  RefCounted(const RefCounted&): m_refCount(0) {
+  }
+
+  RefCounted& operator=(const RefCounted&) {
+    return *this;
+  }
+
+  /// @brief Returns the number of references to this object.
+  unsigned getRefCount() const {
+    return m_refCount.load(std::memory_order_relaxed);
+  }
+
+  void retain() const {
+    m_refCount.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// @brief Drops a reference.
+  /// @return true if it was the last one.
+  bool release() const {
+    return m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1;
+  }
+
+protected:
+  ~RefCounted() {
+  }
+
+private:
+  mutable std::atomic<unsigned> m_refCount;
+};
+
+/// @brief Smart pointer to an object derived from RefCounted.
 template <typename T>
 class RefCount{
 public:
-  RefCount(): m_refCount(0), m_ptr(0) {
+  RefCount(): m_ptr(0) {
   }
 
   RefCount(T* ptr): m_ptr(ptr) {
-    m_refCount = new int(1);
+    if (m_ptr)
+      m_ptr->retain();
+  }
+
+  RefCount(const RefCount<T>& other): m_ptr(other.m_ptr) {
+    if (m_ptr)
+      m_ptr->retain();
   }
 
-  RefCount(const RefCount<T>& other) {
-    cpy(other);
+  RefCount(RefCount<T>&& other) noexcept: m_ptr(other.m_ptr) {
+    other.m_ptr = 0;
   }
 
   ~RefCount() {
-    if (m_refCount)
+    if (m_ptr)
       dispose();
   }
 
   RefCount& operator=(const RefCount<T>& other) {
-    if(this == &other)
+    if (m_ptr == other.m_ptr)
+      return *this;
+    if (other.m_ptr)
+      other.m_ptr->retain();
+    if (m_ptr)
+      dispose();
+    m_ptr = other.m_ptr;
+    return *this;
+  }
+
+  RefCount& operator=(RefCount<T>&& other) noexcept {
+    if (this == &other)
       return *this;
-    if (m_refCount)
+    if (m_ptr)
       dispose();
-    cpy(other);
+    m_ptr = other.m_ptr;
+    other.m_ptr = 0;
     return *this;
   }
 
   void init(T* ptr) {
     assert(!m_ptr && "overrunning non NULL pointer");
-    assert(!m_refCount && "overrunning non NULL pointer");
-    m_refCount = new int(1);
     m_ptr = ptr;
+    if (m_ptr)
+      m_ptr->retain();
+  }
+
+  void swap(RefCount<T>& other) noexcept {
+    T* ptr = m_ptr;
+    m_ptr = other.m_ptr;
+    other.m_ptr = ptr;
   }
 
   bool isNull() const {
@@ -80,27 +145,16 @@ public:
 private:
   void sanity() const{
     assert(m_ptr && "NULL pointer");
-    assert(m_refCount && "NULL ref counter");
-    assert(*m_refCount && "zero ref counter");
-  }
-
-  void cpy(const RefCount<T>& other) {
-    m_refCount = other.m_refCount;
-    m_ptr = other.m_ptr;
-    if (m_refCount) ++*m_refCount;
+    assert(m_ptr->getRefCount() && "zero ref counter");
   }
 
   void dispose() {
     sanity();
-    if (0 == --*m_refCount) {
-      delete m_refCount;
+    if (m_ptr->release())
       delete m_ptr;
-      m_ptr = 0;
-      m_refCount = 0;
-    }
+    m_ptr = 0;
   }
 
-  int* m_refCount;
   T* m_ptr;
 };// End RefCount
 
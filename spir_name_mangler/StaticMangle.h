@@ -0,0 +1,324 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __STATIC_MANGLE_H__
+#define __STATIC_MANGLE_H__
+
+#include "FunctionDescriptor.h"
+#include "ParameterType.h"
+#include "StaticTables.h"
+#include "llvm/ADT/StringRef.h"
+#include <stddef.h>
+#include <string>
+
+// Mangling of signatures known at compile time, e.g.
+//
+//   // vload4(size_t, const __global float*) on SPIR
+//   typedef StaticSignature<StaticUInt,
+//     StaticPointer<StaticFloat, ATTR_GLOBAL, qualifierBit(ATTR_CONST)> >
+//     VLoad4;
+//   constexpr auto name = VLoad4::mangle("vload4");  // "_Z6vload4jPKU3AS1f"
+//
+// The result is the string mangle() returns for the equivalent descriptor,
+// computed by the compiler.
+
+namespace SPIR {
+
+  /// @brief Returns the bit of the given qualifier in a qualifiers mask.
+  constexpr unsigned qualifierBit(TypeAttributeEnum qual) {
+    return 1U << (qual - ATTR_QUALIFIER_FIRST);
+  }
+
+  //
+  // Compile time string helpers.
+  //
+
+  constexpr size_t staticNumberLength(size_t n) {
+    return n < 10 ? 1 : 1 + staticNumberLength(n / 10);
+  }
+
+  constexpr size_t staticPower10(size_t n) {
+    return n ? 10 * staticPower10(n - 1) : 1;
+  }
+
+  /// @brief Returns the i-th character of the decimal representation of n.
+  constexpr char staticDigit(size_t n, size_t i) {
+    return '0' + (n / staticPower10(staticNumberLength(n) - 1 - i)) % 10;
+  }
+
+  /// @brief Same as mangledPrimitiveString(), at compile time.
+  constexpr const char* staticPrimitiveString(TypePrimitiveEnum t) {
+    return MangledPrimitives[t];
+  }
+
+  /// @brief Returns the mangled qualifiers of a qualifiers mask, in
+  ///        TypeAttributeEnum order.
+  constexpr const char* staticQualifiersString(unsigned mask) {
+    return mask == 0 ? "" : mask == 1 ? "r" : mask == 2 ? "V" :
+      mask == 3 ? "rV" : mask == 4 ? "K" : mask == 5 ? "rK" :
+      mask == 6 ? "VK" : "rVK";
+  }
+
+  /// @brief Same as getMangledAttribute() for address spaces, at compile
+  ///        time.
+  constexpr const char* staticAddressSpaceString(TypeAttributeEnum attr) {
+    return attr == ATTR_GLOBAL ? "U3AS1" : attr == ATTR_CONSTANT ? "U3AS2" :
+      attr == ATTR_LOCAL ? "U3AS3" : "";
+  }
+
+  //
+  // Types. Each provides the length of its mangling, the character at a
+  // given position of it, and the equivalent ParamType.
+  //
+
+  template <TypePrimitiveEnum Primitive>
+  struct StaticPrimitive {
+    static constexpr size_t length() {
+      return staticLength(staticPrimitiveString(Primitive));
+    }
+
+    static constexpr char at(size_t i) {
+      return staticPrimitiveString(Primitive)[i];
+    }
+
+    static RefParamType create() {
+      return RefParamType(new PrimitiveType(Primitive));
+    }
+  };
+
+  template <typename Scalar, unsigned Length>
+  struct StaticVector {
+    static constexpr size_t length() {
+      return 3 + staticNumberLength(Length) + Scalar::length();
+    }
+
+    static constexpr char at(size_t i) {
+      return i < 2 ? "Dv"[i] :
+        i < 2 + staticNumberLength(Length) ? staticDigit(Length, i - 2) :
+        i == 2 + staticNumberLength(Length) ? '_' :
+        Scalar::at(i - 3 - staticNumberLength(Length));
+    }
+
+    static RefParamType create() {
+      return RefParamType(new VectorType(Scalar::create(), Length));
+    }
+  };
+
+  /// @param Qualifiers a mask of qualifierBit() values.
+  template <typename Pointee, TypeAttributeEnum AddressSpace = ATTR_PRIVATE,
+            unsigned Qualifiers = 0>
+  struct StaticPointer {
+    static constexpr size_t qualifiersLength() {
+      return staticLength(staticQualifiersString(Qualifiers));
+    }
+
+    static constexpr size_t prefixLength() {
+      return 1 + qualifiersLength() +
+        staticLength(staticAddressSpaceString(AddressSpace));
+    }
+
+    static constexpr size_t length() {
+      return prefixLength() + Pointee::length();
+    }
+
+    static constexpr char at(size_t i) {
+      return i == 0 ? 'P' :
+        i < 1 + qualifiersLength() ? staticQualifiersString(Qualifiers)[i - 1] :
+        i < prefixLength() ?
+          staticAddressSpaceString(AddressSpace)[i - 1 - qualifiersLength()] :
+        Pointee::at(i - prefixLength());
+    }
+
+    static RefParamType create() {
+      PointerType* p = new PointerType(Pointee::create());
+      p->setAddressSpace(AddressSpace);
+      for (unsigned i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
+        TypeAttributeEnum qual = (TypeAttributeEnum)i;
+        p->setQualifier(qual, Qualifiers & qualifierBit(qual));
+      }
+      return RefParamType(p);
+    }
+  };
+
+  /// @param Name a class with a constexpr static method name() returning the
+  ///        name of the type.
+  template <typename Name>
+  struct StaticUserDefined {
+    static constexpr size_t nameLength() {
+      return staticLength(Name::name());
+    }
+
+    static constexpr size_t length() {
+      return staticNumberLength(nameLength()) + nameLength();
+    }
+
+    static constexpr char at(size_t i) {
+      return i < staticNumberLength(nameLength()) ?
+        staticDigit(nameLength(), i) :
+        Name::name()[i - staticNumberLength(nameLength())];
+    }
+
+    static RefParamType create() {
+      return RefParamType(new UserDefinedType(Name::name()));
+    }
+  };
+
+  typedef StaticPrimitive<PRIMITIVE_BOOL> StaticBool;
+  typedef StaticPrimitive<PRIMITIVE_UCHAR> StaticUChar;
+  typedef StaticPrimitive<PRIMITIVE_CHAR> StaticChar;
+  typedef StaticPrimitive<PRIMITIVE_USHORT> StaticUShort;
+  typedef StaticPrimitive<PRIMITIVE_SHORT> StaticShort;
+  typedef StaticPrimitive<PRIMITIVE_UINT> StaticUInt;
+  typedef StaticPrimitive<PRIMITIVE_INT> StaticInt;
+  typedef StaticPrimitive<PRIMITIVE_ULONG> StaticULong;
+  typedef StaticPrimitive<PRIMITIVE_LONG> StaticLong;
+  typedef StaticPrimitive<PRIMITIVE_HALF> StaticHalf;
+  typedef StaticPrimitive<PRIMITIVE_FLOAT> StaticFloat;
+  typedef StaticPrimitive<PRIMITIVE_DOUBLE> StaticDouble;
+  typedef StaticPrimitive<PRIMITIVE_VOID> StaticVoid;
+  typedef StaticPrimitive<PRIMITIVE_IMAGE_1D_T> StaticImage1D;
+  typedef StaticPrimitive<PRIMITIVE_IMAGE_2D_T> StaticImage2D;
+  typedef StaticPrimitive<PRIMITIVE_IMAGE_3D_T> StaticImage3D;
+  typedef StaticPrimitive<PRIMITIVE_IMAGE_1D_BUFFER_T> StaticImage1DBuffer;
+  typedef StaticPrimitive<PRIMITIVE_IMAGE_1D_ARRAY_T> StaticImage1DArray;
+  typedef StaticPrimitive<PRIMITIVE_IMAGE_2D_ARRAY_T> StaticImage2DArray;
+  typedef StaticPrimitive<PRIMITIVE_EVENT_T> StaticEvent;
+  typedef StaticPrimitive<PRIMITIVE_SAMPLER_T> StaticSampler;
+
+  //
+  // Signatures.
+  //
+
+  /// @brief The parameter list of a signature.
+  template <typename... Params>
+  struct StaticParams;
+
+  template <>
+  struct StaticParams<> {
+    static constexpr size_t length() {
+      return 0;
+    }
+
+    static constexpr char at(size_t) {
+      return '\0';
+    }
+
+    static void append(TypeVector&) {
+    }
+  };
+
+  template <typename Param, typename... Rest>
+  struct StaticParams<Param, Rest...> {
+    static constexpr size_t length() {
+      return Param::length() + StaticParams<Rest...>::length();
+    }
+
+    static constexpr char at(size_t i) {
+      return i < Param::length() ? Param::at(i) :
+        StaticParams<Rest...>::at(i - Param::length());
+    }
+
+    static void append(TypeVector& params) {
+      params.push_back(Param::create());
+      StaticParams<Rest...>::append(params);
+    }
+  };
+
+  template <size_t... I>
+  struct StaticIndices {
+  };
+
+  template <size_t N, size_t... I>
+  struct MakeStaticIndices : MakeStaticIndices<N - 1, N - 1, I...> {
+  };
+
+  template <size_t... I>
+  struct MakeStaticIndices<0, I...> {
+    typedef StaticIndices<I...> type;
+  };
+
+  /// @brief A null terminated string of length N, computed at compile time.
+  template <size_t N>
+  class StaticString {
+  public:
+    /// @brief Constructor.
+    /// @param Generator a function object returning the i-th character.
+    template <typename Generator, size_t... I>
+    constexpr StaticString(const Generator& g, StaticIndices<I...>) :
+      m_data{ g(I)..., '\0' } {
+    }
+
+    constexpr size_t size() const {
+      return N;
+    }
+
+    constexpr char operator[](size_t i) const {
+      return m_data[i];
+    }
+
+    constexpr const char* c_str() const {
+      return m_data;
+    }
+
+    llvm::StringRef str() const {
+      return llvm::StringRef(m_data, N);
+    }
+
+  private:
+    char m_data[N + 1];
+  };
+
+  /// @brief Generates the characters of a mangled function name.
+  template <typename... Params>
+  struct StaticMangledName {
+    const char* name;
+    size_t nameLength;
+
+    constexpr size_t prefixLength() const {
+      return 2 + staticNumberLength(nameLength);
+    }
+
+    constexpr char operator()(size_t i) const {
+      return i < 2 ? "_Z"[i] :
+        i < prefixLength() ? staticDigit(nameLength, i - 2) :
+        i < prefixLength() + nameLength ? name[i - prefixLength()] :
+        StaticParams<Params...>::at(i - prefixLength() - nameLength);
+    }
+  };
+
+  /// @brief The parameter list of a function, as types.
+  template <typename... Params>
+  struct StaticSignature {
+    /// @brief Returns the length of the mangled name of a function with the
+    ///        given name length.
+    static constexpr size_t mangledLength(size_t nameLength) {
+      return 2 + staticNumberLength(nameLength) + nameLength +
+        StaticParams<Params...>::length();
+    }
+
+    /// @brief Returns the mangled name of the function with the given name
+    ///        and this signature, as mangle() does.
+    template <size_t N>
+    static constexpr StaticString<mangledLength(N - 1)>
+    mangle(const char (&name)[N]) {
+      return StaticString<mangledLength(N - 1)>(
+        StaticMangledName<Params...>{ name, N - 1 },
+        typename MakeStaticIndices<mangledLength(N - 1)>::type());
+    }
+
+    /// @brief Returns the (heap allocated) descriptor of the function with
+    ///        the given name and this signature.
+    static FunctionDescriptor descriptor(std::string name) {
+      FunctionDescriptor fd(std::move(name));
+      StaticParams<Params...>::append(fd.parameters);
+      return fd;
+    }
+  };
+
+} // End SPIR namespace
+
+#endif //__STATIC_MANGLE_H__
@@ -0,0 +1,55 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __STATIC_TABLES_H__
+#define __STATIC_TABLES_H__
+
+#include "ParameterType.h"
+#include <stddef.h>
+
+// Mangling tables usable in constant expressions, shared by the run time
+// mangler and the compile time one.
+
+namespace SPIR {
+
+  /// @brief Mangled names of the primitive types, indexed by
+  ///        TypePrimitiveEnum. The one copy of the table, read by
+  ///        mangledPrimitiveString(), PackedType and the compile time
+  ///        mangler (StaticMangle.h).
+  constexpr const char* MangledPrimitives[PRIMITIVE_NUM] = {
+    "b",  //BOOL
+    "h",  //UCHAR
+    "c",  //CHAR
+    "t",  //USHORT
+    "s",  //SHORT
+    "j",  //UINT
+    "i",  //INT
+    "m",  //ULONG
+    "l",  //LONG
+    "Dh", //HALF
+    "f",  //FLOAT
+    "d",  //DOUBLE
+    "v",  //VOID
+    "z",  //VarArg
+    "11ocl_image1d",            //PRIMITIVE_IMAGE_1D_T
+    "11ocl_image2d",            //PRIMITIVE_IMAGE_2D_T
+    "11ocl_image3d",            //PRIMITIVE_IMAGE_3D_T
+    "17ocl_image1dbuffer",      //PRIMITIVE_IMAGE_1D_BUFFER_T
+    "16ocl_image1darray",       //PRIMITIVE_IMAGE_1D_ARRAY_T
+    "16ocl_image2darray",       //PRIMITIVE_IMAGE_2D_ARRAY_T
+    "9ocl_event",               //PRIMITIVE_EVENT_T
+    "11ocl_sampler"             //PRIMITIVE_SAMPLER_T
+  };
+
+  /// @brief Returns the length of a string, at compile time.
+  constexpr size_t staticLength(const char* s) {
+    return *s ? 1 + staticLength(s + 1) : 0;
+  }
+
+} // End SPIR namespace
+
+#endif //__STATIC_TABLES_H__
@@ -0,0 +1,95 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "TypeArena.h"
+#include "llvm/ADT/DenseMap.h"
+#include <assert.h>
+
+namespace SPIR {
+
+  // Returns the type a vector or pointer type is built on, if any.
+  static const ParamType* getSubType(const ParamType* type) {
+    if (const VectorType* v = dyn_cast<VectorType>(type))
+      return v->getScalarType();
+    if (const PointerType* p = dyn_cast<PointerType>(type))
+      return p->getPointee();
+    return NULL;
+  }
+
+  TypeArena::TypeArena() : m_size(0) {
+  }
+
+  TypeArena::~TypeArena() {
+#ifndef NDEBUG
+    // A type is referenced by the arena and by the arena types built on it,
+    // any other reference outlives the arena.
+    llvm::DenseMap<const ParamType*, unsigned> references;
+    for (unsigned i = 0; i < m_types.size(); ++i) {
+      references[m_types[i]]++;
+      const ParamType* sub = getSubType(m_types[i]);
+      if (sub && sub->getArena() == this)
+        references[sub]++;
+    }
+    for (unsigned i = 0; i < m_types.size(); ++i)
+      assert(m_types[i]->getRefCount() == references[m_types[i]] &&
+             "a reference to an arena type outlives the arena");
+#endif
+    // Parents were created after their sub types, so are destroyed first.
+    std::vector<ParamType*>::reverse_iterator it = m_destroy.rbegin(),
+      e = m_destroy.rend();
+    for (; it != e; ++it)
+      (*it)->~ParamType();
+  }
+
+  void TypeArena::adopt(ParamType* type) {
+    // The arena holds a reference to each of its types, so reference
+    // counting never deletes them.
+    type->retain();
+    type->m_arena = this;
+    ++m_size;
+#ifndef NDEBUG
+    m_types.push_back(type);
+#endif
+
+    // Only user defined types (which hold a string) and types referring to
+    // heap allocated types have to be destroyed explicitly.
+    const ParamType* sub = getSubType(type);
+    if (dyn_cast<UserDefinedType>(type))
+      m_destroy.push_back(type);
+    else if (sub && sub->getArena() != this)
+      m_destroy.push_back(type);
+  }
+
+  RefParamType TypeArena::clone(const ParamType* type) {
+    assert(type && "cloning a NULL type");
+    if (type->getArena() == this)
+      return RefParamType(const_cast<ParamType*>(type));
+    if (const PrimitiveType* p = dyn_cast<PrimitiveType>(type))
+      return create<PrimitiveType>(p->getPrimitive());
+    if (const VectorType* v = dyn_cast<VectorType>(type))
+      return create<VectorType>(clone(v->getScalarType()), v->getLength());
+    if (const PointerType* p = dyn_cast<PointerType>(type)) {
+      PointerType* copy = create<PointerType>(clone(p->getPointee()));
+      copy->setAddressSpace(p->getAddressSpace());
+      for (unsigned i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
+        TypeAttributeEnum qual = (TypeAttributeEnum)i;
+        copy->setQualifier(qual, p->hasQualifier(qual));
+      }
+      return copy;
+    }
+    const UserDefinedType* u = dyn_cast<UserDefinedType>(type);
+    assert(u && "unknown type");
+    return create<UserDefinedType>(u->getName());
+  }
+
+  void TypeArena::clone(FunctionDescriptor& fd) {
+    TypeVector::iterator it = fd.parameters.begin(), e = fd.parameters.end();
+    for (; it != e; ++it)
+      *it = clone(*it);
+  }
+
+} // End SPIR namespace
@@ -0,0 +1,81 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __TYPE_ARENA_H__
+#define __TYPE_ARENA_H__
+
+#include "FunctionDescriptor.h"
+#include "ParameterType.h"
+#include "llvm/Support/Allocator.h"
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace SPIR {
+
+  /// @brief Bump allocator for parameter types.
+  ///        Types created by an arena are referenced through RefParamType as
+  ///        usual, but they are never deleted by their reference counts:
+  ///        they are all freed at once when the arena is destroyed, and must
+  ///        not be used afterwards. This includes releasing them: every
+  ///        RefParamType referring to an arena type (e.g. the parameters of a
+  ///        descriptor cloned into the arena) must be destroyed before the
+  ///        arena, which debug builds assert.
+  ///        An arena is not thread safe.
+  class TypeArena {
+  public:
+    TypeArena();
+    ~TypeArena();
+
+    /// @brief Creates a type of class T in the arena.
+    /// @param args arguments of the constructor of T.
+    /// @return the new type, which may still be modified by the caller.
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+      T* type = new (m_allocator.Allocate<T>()) T(std::forward<Args>(args)...);
+      adopt(type);
+      return type;
+    }
+
+    /// @brief Copies the given type (and its sub types) into the arena.
+    /// @param ParamType type to copy.
+    /// @return the copy.
+    RefParamType clone(const ParamType*);
+
+    /// @brief Replaces the parameters of the given descriptor with copies
+    ///        allocated in the arena. The descriptor must be destroyed (or
+    ///        its parameters cleared) before the arena.
+    void clone(FunctionDescriptor&);
+
+    /// @brief Returns the number of types created by the arena.
+    unsigned size() const {
+      return m_size;
+    }
+
+  private:
+    TypeArena(const TypeArena&);
+    TypeArena& operator=(const TypeArena&);
+
+    // Takes ownership of a newly created type.
+    void adopt(ParamType*);
+
+    /// Storage of the types.
+    llvm::BumpPtrAllocator m_allocator;
+    /// Types which own resources outside of the arena (their destructor has
+    /// to run), in order of creation.
+    std::vector<ParamType*> m_destroy;
+    /// Number of types created.
+    unsigned m_size;
+#ifndef NDEBUG
+    /// All types, to check that none is referenced when the arena dies.
+    std::vector<ParamType*> m_types;
+#endif
+  };
+
+} // End SPIR namespace
+
+#endif //__TYPE_ARENA_H__
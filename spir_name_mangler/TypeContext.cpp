@@ -0,0 +1,179 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "TypeContext.h"
+#include <assert.h>
+#include <new>
+
+namespace SPIR {
+
+  //
+  // Profiles
+  //
+
+  // Sub types are uniqued before their parents, so they are identified by
+  // their address.
+
+  static void profileVector(llvm::FoldingSetNodeID& id, const ParamType* scalar,
+                            int len) {
+    id.AddInteger(TYPE_ID_VECTOR);
+    id.AddPointer(scalar);
+    id.AddInteger(len);
+  }
+
+  static void profilePointer(llvm::FoldingSetNodeID& id,
+                             const ParamType* pointee,
+                             TypeAttributeEnum addressSpace,
+                             unsigned qualifiers) {
+    id.AddInteger(TYPE_ID_POINTER);
+    id.AddPointer(pointee);
+    id.AddInteger(addressSpace);
+    id.AddInteger(qualifiers);
+  }
+
+  static void profileUserDefined(llvm::FoldingSetNodeID& id,
+                                 const std::string& name) {
+    id.AddInteger(TYPE_ID_STRUCTURE);
+    id.AddString(name);
+  }
+
+  static unsigned getQualifiers(const PointerType* p) {
+    unsigned qualifiers = 0;
+    for (unsigned i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
+      if (p->hasQualifier((TypeAttributeEnum)i))
+        qualifiers |= 1U << (i - ATTR_QUALIFIER_FIRST);
+    }
+    return qualifiers;
+  }
+
+  struct TypeContext::Node : public llvm::FoldingSetNode {
+    Node(const RefParamType& t) : type(t) {
+    }
+
+    void Profile(llvm::FoldingSetNodeID& id) const {
+      if (const VectorType* v = dyn_cast<VectorType>(&*type)) {
+        profileVector(id, v->getScalarType(), v->getLength());
+      } else if (const PointerType* p = dyn_cast<PointerType>(&*type)) {
+        profilePointer(id, p->getPointee(), p->getAddressSpace(),
+                       getQualifiers(p));
+      } else if (const UserDefinedType* u =
+                 dyn_cast<UserDefinedType>(&*type)) {
+        profileUserDefined(id, u->getName());
+      } else {
+        assert(false && "unexpected type in TypeContext");
+      }
+    }
+
+    RefParamType type;
+  };
+
+  //
+  // TypeContext
+  //
+
+  TypeContext::TypeContext() {
+    for (unsigned i = PRIMITIVE_FIRST; i <= PRIMITIVE_LAST; i++) {
+      PrimitiveType* p = new PrimitiveType((TypePrimitiveEnum)i);
+      p->m_hash = p->getHash();
+      p->m_context = this;
+      m_primitives[i] = RefParamType(p);
+    }
+  }
+
+  TypeContext::~TypeContext() {
+    // Types may outlive the context; they then become free standing.
+    for (unsigned i = PRIMITIVE_FIRST; i <= PRIMITIVE_LAST; i++)
+      m_primitives[i]->m_context = NULL;
+    llvm::FoldingSet<Node>::iterator it = m_types.begin(), e = m_types.end();
+    while (it != e) {
+      Node* node = &*it++;
+      node->type->m_context = NULL;
+      node->~Node();
+    }
+  }
+
+  RefParamType TypeContext::insert(ParamType* type, void* insertPos) {
+    type->m_hash = type->getHash();
+    type->m_context = this;
+    Node* node = new (m_allocator.Allocate<Node>()) Node(RefParamType(type));
+    m_types.InsertNode(node, insertPos);
+    return node->type;
+  }
+
+  RefParamType TypeContext::getPrimitive(TypePrimitiveEnum primitive) {
+    assert(primitive >= PRIMITIVE_FIRST && primitive <= PRIMITIVE_LAST &&
+           "illegal primitive");
+    return m_primitives[primitive];
+  }
+
+  RefParamType TypeContext::getVector(const RefParamType& scalar, int len) {
+    RefParamType s = unique(scalar);
+    llvm::FoldingSetNodeID id;
+    profileVector(id, s, len);
+    llvm::sys::ScopedLock lock(m_lock);
+    void* insertPos;
+    if (Node* node = m_types.FindNodeOrInsertPos(id, insertPos))
+      return node->type;
+    return insert(new VectorType(s, len), insertPos);
+  }
+
+  RefParamType TypeContext::getPointer(const RefParamType& pointee,
+                                       TypeAttributeEnum addressSpace,
+                                       unsigned qualifiers) {
+    RefParamType p = unique(pointee);
+    llvm::FoldingSetNodeID id;
+    profilePointer(id, p, addressSpace, qualifiers);
+    llvm::sys::ScopedLock lock(m_lock);
+    void* insertPos;
+    if (Node* node = m_types.FindNodeOrInsertPos(id, insertPos))
+      return node->type;
+    PointerType* type = new PointerType(p);
+    type->setAddressSpace(addressSpace);
+    for (unsigned i = ATTR_QUALIFIER_FIRST; i <= ATTR_QUALIFIER_LAST; i++) {
+      TypeAttributeEnum qual = (TypeAttributeEnum)i;
+      type->setQualifier(qual, qualifiers & (1U << (i - ATTR_QUALIFIER_FIRST)));
+    }
+    return insert(type, insertPos);
+  }
+
+  RefParamType TypeContext::getUserDefined(const std::string& name) {
+    llvm::FoldingSetNodeID id;
+    profileUserDefined(id, name);
+    llvm::sys::ScopedLock lock(m_lock);
+    void* insertPos;
+    if (Node* node = m_types.FindNodeOrInsertPos(id, insertPos))
+      return node->type;
+    return insert(new UserDefinedType(name), insertPos);
+  }
+
+  RefParamType TypeContext::unique(const RefParamType& type) {
+    if (type.isNull() || type->getContext() == this)
+      return type;
+    if (const PrimitiveType* p = dyn_cast<PrimitiveType>(&*type))
+      return getPrimitive(p->getPrimitive());
+    if (const VectorType* v = dyn_cast<VectorType>(&*type))
+      return getVector(v->getScalarType(), v->getLength());
+    if (const PointerType* p = dyn_cast<PointerType>(&*type))
+      return getPointer(p->getPointee(), p->getAddressSpace(),
+                        getQualifiers(p));
+    const UserDefinedType* u = dyn_cast<UserDefinedType>(&*type);
+    assert(u && "unknown type");
+    return getUserDefined(u->getName());
+  }
+
+  void TypeContext::unique(FunctionDescriptor& fd) {
+    TypeVector::iterator it = fd.parameters.begin(), e = fd.parameters.end();
+    for (; it != e; ++it)
+      *it = unique(*it);
+  }
+
+  unsigned TypeContext::size() const {
+    llvm::sys::ScopedLock lock(m_lock);
+    return (PRIMITIVE_LAST - PRIMITIVE_FIRST + 1) + m_types.size();
+  }
+
+} // End SPIR namespace
@@ -0,0 +1,91 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __TYPE_CONTEXT_H__
+#define __TYPE_CONTEXT_H__
+
+#include "FunctionDescriptor.h"
+#include "ParameterType.h"
+#include "llvm/ADT/FoldingSet.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/Mutex.h"
+#include <string>
+
+namespace SPIR {
+
+  /// @brief Factory of uniqued (hash-consed) parameter types.
+  ///        Structurally identical types built through the same context share
+  ///        a single node, so comparing two of them is a pointer comparison
+  ///        and their structural hash is computed only once.
+  ///        The types owned by a context are immutable, and stay alive at least
+  ///        as long as the context. The methods may be called concurrently:
+  ///        insertions are serialized by the context's lock, and the handles
+  ///        it returns may be copied and released on any thread because
+  ///        RefCount is atomic.
+  class TypeContext {
+  public:
+    TypeContext();
+    ~TypeContext();
+
+    /// @brief Returns the unique primitive type.
+    /// @param TypePrimitiveEnum primitive id.
+    RefParamType getPrimitive(TypePrimitiveEnum primitive);
+
+    /// @brief Returns the unique vector type.
+    /// @param RefParamType scalar type (uniqued if it is not yet).
+    /// @param int vector length.
+    RefParamType getVector(const RefParamType& scalar, int len);
+
+    /// @brief Returns the unique pointer type.
+    /// @param RefParamType pointee type (uniqued if it is not yet).
+    /// @param TypeAttributeEnum address space of the pointer.
+    /// @param unsigned qualifiers, a mask with a bit
+    ///        (1 << (qual - ATTR_QUALIFIER_FIRST)) set per enabled qualifier.
+    RefParamType getPointer(const RefParamType& pointee,
+                            TypeAttributeEnum addressSpace = ATTR_PRIVATE,
+                            unsigned qualifiers = 0);
+
+    /// @brief Returns the unique user defined type.
+    /// @param std::string name of the type.
+    RefParamType getUserDefined(const std::string& name);
+
+    /// @brief Returns the type of this context that is structurally equal to
+    ///        the given (arbitrary) type.
+    /// @param RefParamType type to unique.
+    /// @return uniqued type, or a null type if the given type is null.
+    RefParamType unique(const RefParamType& type);
+
+    /// @brief Replaces the parameters of the given descriptor with the
+    ///        equivalent types of this context.
+    void unique(FunctionDescriptor& fd);
+
+    /// @brief Returns the number of distinct types owned by this context.
+    unsigned size() const;
+
+  private:
+    TypeContext(const TypeContext&);
+    TypeContext& operator=(const TypeContext&);
+
+    struct Node;
+
+    // Takes ownership of a newly created type, which must not exist yet.
+    // Called with m_lock held.
+    RefParamType insert(ParamType* type, void* insertPos);
+
+    /// Primitive types are preallocated, and served without locking.
+    RefParamType m_primitives[PRIMITIVE_NUM];
+    /// All non primitive types.
+    llvm::FoldingSet<Node> m_types;
+    /// Storage of the folding set nodes.
+    llvm::BumpPtrAllocator m_allocator;
+    /// Guards m_types and m_allocator.
+    mutable llvm::sys::Mutex m_lock;
+  };
+
+} // End SPIR namespace
+
+#endif //__TYPE_CONTEXT_H__
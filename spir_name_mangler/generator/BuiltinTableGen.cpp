@@ -0,0 +1,359 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+// Generates the built-in table of the name mangler from an OpenCL header
+// (opencl_spir.h): BuiltinIDs.inc, the list of built-in identifiers,
+// BuiltinFamilies.inc, the list of built-in names, and BuiltinTable.inc,
+// their packed signatures and mangled names for SPIR and SPIR64, and a
+// minimal perfect hash of the mangled names. See BuiltinTable.h. The same
+// tables are written to a built-in database, opencl_spir.bdb (see
+// BuiltinDatabase.h).
+
+#include "spir_name_mangler/BuiltinDatabase.h"
+#include "spir_name_mangler/BuiltinHash.h"
+#include "spir_name_mangler/BuiltinParser.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/PackedType.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using namespace SPIR;
+
+// The values of BuiltinAttribute (BuiltinTable.h needs the generated files).
+static const unsigned BuiltinConst = 1;
+static const unsigned BuiltinReadOnly = 2;
+
+/// @brief A string pool, emitted as a character array (string literals
+///        this long are not portable).
+class StringPool {
+public:
+  /// @brief Appends a string, followed by a NUL.
+  /// @return its offset in the pool.
+  unsigned add(llvm::StringRef s) {
+    unsigned offset = m_pool.size();
+    m_pool.append(s.begin(), s.end());
+    m_pool.push_back('\0');
+    return offset;
+  }
+
+  /// @brief Returns the offset of a string added before, adding it if not.
+  unsigned addUnique(llvm::StringRef s) {
+    llvm::StringMap<unsigned>::iterator it = m_offsets.find(s);
+    if (it != m_offsets.end())
+      return it->second;
+    unsigned offset = add(s);
+    m_offsets[s] = offset;
+    return offset;
+  }
+
+  /// @brief Returns the string at the given offset.
+  llvm::StringRef get(unsigned offset) const {
+    return llvm::StringRef(m_pool.c_str() + offset);
+  }
+
+  /// @brief Returns all strings, each followed by a NUL.
+  llvm::StringRef getData() const {
+    return m_pool;
+  }
+
+  /// @brief Returns the size of the pool, the offset of the next string.
+  unsigned size() const {
+    return m_pool.size();
+  }
+
+  void emit(llvm::raw_ostream& o, const char* name) const {
+    o << "static const char " << name << "[] = {";
+    for (size_t i = 0; i < m_pool.size(); ++i) {
+      if (i % 16 == 0)
+        o << "\n ";
+      o << ' ' << (unsigned)(unsigned char)m_pool[i] << ',';
+    }
+    o << "\n};\n\n";
+  }
+
+private:
+  std::string m_pool;
+  llvm::StringMap<unsigned> m_offsets;
+};
+
+/// @brief The packed signatures of all built-ins for one pointer size.
+struct Signatures {
+  /// Return type, first parameter and number of parameters of each built-in.
+  std::vector<uint32_t> returnTypes;
+  std::vector<unsigned> firstParameters;
+  std::vector<unsigned> numParameters;
+  /// All parameters, back to back.
+  std::vector<uint32_t> parameters;
+  /// Mangled names and their offsets, followed by the size of the pool.
+  StringPool names;
+  std::vector<unsigned> nameOffsets;
+};
+
+static bool addSignature(const BuiltinDeclaration& decl, Signatures& sigs) {
+  PackedType ret = PackedType::get(decl.returnType);
+  if (!ret.isValid())
+    return false;
+  unsigned first = sigs.parameters.size();
+  for (unsigned i = 0; i < decl.descriptor.parameters.size(); ++i) {
+    PackedType param = PackedType::get(decl.descriptor.parameters[i]);
+    if (!param.isValid()) {
+      sigs.parameters.resize(first);
+      return false;
+    }
+    sigs.parameters.push_back(param.getBits());
+  }
+  sigs.returnTypes.push_back(ret.getBits());
+  sigs.firstParameters.push_back(first);
+  sigs.numParameters.push_back(decl.descriptor.parameters.size());
+  sigs.nameOffsets.push_back(sigs.names.add(mangle(decl.descriptor)));
+  return true;
+}
+
+template <typename T>
+static void emitArray(llvm::raw_ostream& o, const char* type,
+                      const char* name, const std::vector<T>& values,
+                      bool hex = false) {
+  o << "static const " << type << ' ' << name << "[] = {";
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (i % 8 == 0)
+      o << "\n ";
+    o << ' ';
+    if (hex)
+      o << llvm::format("0x%08x", (unsigned)values[i]);
+    else
+      o << values[i];
+    o << ',';
+  }
+  // Arrays may not be empty.
+  if (values.empty())
+    o << " 0";
+  o << "\n};\n\n";
+}
+
+static void emitSignatures(llvm::raw_ostream& o, const Signatures& sigs,
+                           const char* suffix) {
+  std::string prefix = std::string("Builtin") + suffix;
+  emitArray(o, "uint32_t", (prefix + "ReturnTypes").c_str(),
+            sigs.returnTypes, true);
+  emitArray(o, "uint32_t", (prefix + "Parameters").c_str(),
+            sigs.parameters, true);
+  emitArray(o, "uint32_t", (prefix + "FirstParameters").c_str(),
+            sigs.firstParameters);
+  sigs.names.emit(o, (prefix + "MangledNames").c_str());
+  std::vector<unsigned> offsets = sigs.nameOffsets;
+  offsets.push_back(sigs.names.size());
+  emitArray(o, "uint32_t", (prefix + "MangledNameOffsets").c_str(), offsets);
+}
+
+/// @brief Builds a minimal perfect hash of the mangled names of both pointer
+///        sizes, a name valid for both has a single slot.
+static bool buildHash(const Signatures& sigs32, const Signatures& sigs64,
+                      BuiltinHashTable& hash) {
+  std::vector<llvm::StringRef> names;
+  std::vector<uint32_t> slots;
+  for (unsigned id = 0; id < sigs32.nameOffsets.size(); ++id) {
+    llvm::StringRef name32 = sigs32.names.get(sigs32.nameOffsets[id]);
+    llvm::StringRef name64 = sigs64.names.get(sigs64.nameOffsets[id]);
+    if (name32 == name64) {
+      names.push_back(name32);
+      slots.push_back(id | BUILTIN_SLOT_SPIR32 | BUILTIN_SLOT_SPIR64);
+    } else {
+      names.push_back(name32);
+      slots.push_back(id | BUILTIN_SLOT_SPIR32);
+      names.push_back(name64);
+      slots.push_back(id | BUILTIN_SLOT_SPIR64);
+    }
+  }
+  return buildBuiltinHash(names, slots, hash);
+}
+
+static void emitHash(llvm::raw_ostream& o, const BuiltinHashTable& hash) {
+  o << "static const uint64_t BuiltinHashSeed = "
+    << llvm::format("0x%016llx", (unsigned long long)hash.seed) << "ULL;\n";
+  o << "static const unsigned BuiltinHashNumBuckets = "
+    << hash.displacements.size() << ";\n";
+  o << "static const unsigned BuiltinHashNumSlots = " << hash.slots.size()
+    << ";\n\n";
+  emitArray(o, "uint16_t", "BuiltinHashDisplacements", hash.displacements);
+  emitArray(o, "uint32_t", "BuiltinHashSlots", hash.slots, true);
+}
+
+/// @brief Writes the tables to a built-in database.
+/// @param familyNameOffsets start of each family name, followed by the size
+///        of the pool.
+static void writeDatabase(llvm::raw_ostream& o, const StringPool& familyNames,
+                          const std::vector<unsigned>& familyNameOffsets,
+                          const std::vector<unsigned>& families,
+                          const std::vector<unsigned>& attributes,
+                          const Signatures& sigs32, const Signatures& sigs64,
+                          const BuiltinHashTable& hash) {
+  BuiltinDatabaseTables tables;
+  tables.familyNames = familyNames.getData();
+  tables.familyNameOffsets = familyNameOffsets;
+  tables.families = families;
+  tables.attributes = attributes;
+  tables.numParameters = sigs32.numParameters;
+  const Signatures* sigs[2] = { &sigs32, &sigs64 };
+  std::vector<unsigned> nameOffsets[2];
+  for (unsigned w = 0; w < 2; ++w) {
+    nameOffsets[w] = sigs[w]->nameOffsets;
+    nameOffsets[w].push_back(sigs[w]->names.size());
+    BuiltinDatabaseTables::Signatures& out = tables.signatures[w];
+    out.returnTypes = sigs[w]->returnTypes;
+    out.firstParameters = sigs[w]->firstParameters;
+    out.parameters = sigs[w]->parameters;
+    out.mangledNames = sigs[w]->names.getData();
+    out.mangledNameOffsets = nameOffsets[w];
+  }
+  tables.hashSeed = hash.seed;
+  tables.hashDisplacements = hash.displacements;
+  tables.hashSlots = hash.slots;
+  writeBuiltinDatabase(tables, o);
+}
+
+static bool readFile(const char* path, std::string& contents) {
+  FILE* f = fopen(path, "rb");
+  if (!f)
+    return false;
+  char buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+    contents.append(buffer, n);
+  fclose(f);
+  return true;
+}
+
+static bool writeFile(const std::string& path, llvm::StringRef contents) {
+  FILE* f = fopen(path.c_str(), "wb");
+  if (!f)
+    return false;
+  bool ok = fwrite(contents.data(), 1, contents.size(), f) == contents.size();
+  return fclose(f) == 0 && ok;
+}
+
+static const char* Banner =
+  "//===- Generated by spir-builtin-gen from opencl_spir.h, do not edit -===//"
+  "\n\n";
+
+int main(int argc, const char* argv[]) {
+  if (argc != 3) {
+    llvm::errs() << "usage: " << argv[0] << " <opencl header> <output dir>\n";
+    return 1;
+  }
+  std::string header;
+  if (!readFile(argv[1], header)) {
+    llvm::errs() << "cannot read " << argv[1] << "\n";
+    return 1;
+  }
+
+  BuiltinDeclarationList decls32, decls64;
+  parseBuiltinHeader(header, false, decls32);
+  parseBuiltinHeader(header, true, decls64);
+  if (decls32.size() != decls64.size()) {
+    llvm::errs() << "the SPIR and SPIR64 built-ins differ\n";
+    return 1;
+  }
+
+  // Built-ins are identified by their SPIR mangled name. Repeated and
+  // unpackable declarations are left out.
+  std::string ids, families, table;
+  llvm::raw_string_ostream idsOut(ids), familiesOut(families),
+    tableOut(table);
+  idsOut << Banner;
+  familiesOut << Banner;
+  // The families (names) of the built-ins, in order of appearance.
+  StringPool names;
+  std::vector<unsigned> nameOffsets, builtinFamilies, attributes;
+  llvm::StringMap<unsigned> familyIndices;
+  Signatures sigs32, sigs64;
+  llvm::StringMap<bool> seen;
+  unsigned skipped = 0;
+  for (unsigned i = 0; i < decls32.size(); ++i) {
+    std::string mangled = mangle(decls32[i].descriptor);
+    if (!seen.insert(std::make_pair(mangled, true)).second) {
+      ++skipped;
+      continue;
+    }
+    if (!addSignature(decls32[i], sigs32)) {
+      ++skipped;
+      continue;
+    }
+    if (!addSignature(decls64[i], sigs64)) {
+      llvm::errs() << "cannot pack the SPIR64 signature of " << mangled
+                   << "\n";
+      return 1;
+    }
+    // The mangled name without "_Z" is a valid identifier.
+    idsOut << "SPIR_BUILTIN(BI_" << llvm::StringRef(mangled).substr(2)
+           << ")\n";
+    const std::string& name = decls32[i].descriptor.name;
+    llvm::StringMap<unsigned>::iterator it = familyIndices.find(name);
+    unsigned family;
+    if (it != familyIndices.end()) {
+      family = it->second;
+    } else {
+      family = familyIndices.size();
+      familyIndices[name] = family;
+      familiesOut << "SPIR_BUILTIN_FAMILY(BF_" << name << ")\n";
+      nameOffsets.push_back(names.add(name));
+    }
+    builtinFamilies.push_back(family);
+    attributes.push_back((decls32[i].isConst ? BuiltinConst : 0) |
+                         (decls32[i].isReadOnly ? BuiltinReadOnly : 0));
+  }
+
+  // The hash slots hold the built-in ids next to the width flags.
+  if (builtinFamilies.size() > BUILTIN_SLOT_ID_MASK + 1) {
+    llvm::errs() << "too many built-ins (" << builtinFamilies.size()
+                 << ") for the hash slots\n";
+    return 1;
+  }
+
+  BuiltinHashTable hash;
+  if (!buildHash(sigs32, sigs64, hash)) {
+    llvm::errs() << "cannot build a perfect hash of the mangled names\n";
+    return 1;
+  }
+
+  tableOut << Banner;
+  names.emit(tableOut, "BuiltinFamilyNames");
+  nameOffsets.push_back(names.size());
+  emitArray(tableOut, "uint32_t", "BuiltinFamilyNameOffsets", nameOffsets);
+  emitArray(tableOut, "uint16_t", "BuiltinFamilies", builtinFamilies);
+  emitArray(tableOut, "uint8_t", "BuiltinAttributeMasks", attributes);
+  // The number of parameters is the same for both pointer sizes.
+  emitArray(tableOut, "uint8_t", "BuiltinNumParameters",
+            sigs32.numParameters);
+  emitSignatures(tableOut, sigs32, "32");
+  emitSignatures(tableOut, sigs64, "64");
+  emitHash(tableOut, hash);
+
+  std::string database;
+  llvm::raw_string_ostream databaseOut(database);
+  writeDatabase(databaseOut, names, nameOffsets, builtinFamilies, attributes,
+                sigs32, sigs64, hash);
+
+  std::string dir = argv[2];
+  if (!writeFile(dir + "/BuiltinIDs.inc", idsOut.str()) ||
+      !writeFile(dir + "/BuiltinFamilies.inc", familiesOut.str()) ||
+      !writeFile(dir + "/BuiltinTable.inc", tableOut.str()) ||
+      !writeFile(dir + "/opencl_spir.bdb", databaseOut.str())) {
+    llvm::errs() << "cannot write to " << dir << "\n";
+    return 1;
+  }
+  llvm::outs() << "spir-builtin-gen: " << builtinFamilies.size()
+               << " built-ins in " << familyIndices.size() << " families, "
+               << skipped << " declarations skipped\n";
+  return 0;
+}
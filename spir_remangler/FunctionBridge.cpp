@@ -0,0 +1,262 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "FunctionBridge.h"
+
+#include "spir_name_mangler/BuiltinParser.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+
+#include "llvm/Constants.h"
+#include "llvm/DerivedTypes.h"
+#include "llvm/Function.h"
+#include "llvm/Metadata.h"
+#include "llvm/Module.h"
+#include "llvm/ADT/StringRef.h"
+
+namespace SPIR {
+
+static const char *OPENCL_KERNELS_MD = "opencl.kernels";
+static const char *KERNEL_ARG_TYPE_MD = "kernel_arg_type";
+static const char *KERNEL_ARG_TYPE_QUAL_MD = "kernel_arg_type_qual";
+
+/// The opaque structures of the OpenCL types which are mangled as
+/// primitives, e.g. image2d_t is passed as %opencl.image2d_t addrspace(1)*.
+static const struct {
+  const char *Name;
+  TypePrimitiveEnum Primitive;
+} OpaqueTypes[] = {
+  { "opencl.image1d_t", PRIMITIVE_IMAGE_1D_T },
+  { "opencl.image1d_array_t", PRIMITIVE_IMAGE_1D_ARRAY_T },
+  { "opencl.image1d_buffer_t", PRIMITIVE_IMAGE_1D_BUFFER_T },
+  { "opencl.image2d_t", PRIMITIVE_IMAGE_2D_T },
+  { "opencl.image2d_array_t", PRIMITIVE_IMAGE_2D_ARRAY_T },
+  { "opencl.image3d_t", PRIMITIVE_IMAGE_3D_T },
+  { "opencl.event_t", PRIMITIVE_EVENT_T }
+};
+
+static TypePrimitiveEnum getOpaquePrimitive(const llvm::Type *Ty) {
+  const llvm::StructType *STy = llvm::dyn_cast<llvm::StructType>(Ty);
+  if (!STy || !STy->hasName())
+    return PRIMITIVE_NONE;
+  llvm::StringRef Name = STy->getName();
+  for (unsigned i = 0; i < sizeof(OpaqueTypes) / sizeof(OpaqueTypes[0]); ++i)
+    if (Name == OpaqueTypes[i].Name)
+      return OpaqueTypes[i].Primitive;
+  return PRIMITIVE_NONE;
+}
+
+static bool isUnsigned(TypePrimitiveEnum Primitive) {
+  return Primitive == PRIMITIVE_UCHAR || Primitive == PRIMITIVE_USHORT ||
+    Primitive == PRIMITIVE_UINT || Primitive == PRIMITIVE_ULONG;
+}
+
+static TypePrimitiveEnum getIntegerPrimitive(unsigned Width,
+                                             const ParamType *Hint) {
+  const PrimitiveType *PHint = Hint ? dyn_cast<PrimitiveType>(Hint) : NULL;
+  TypePrimitiveEnum HintPrimitive =
+    PHint ? PHint->getPrimitive() : PRIMITIVE_NONE;
+  // Samplers are 32 bit integers in SPIR 1.2.
+  if (Width == 32 && HintPrimitive == PRIMITIVE_SAMPLER_T)
+    return PRIMITIVE_SAMPLER_T;
+  if (Width == 8 && HintPrimitive == PRIMITIVE_BOOL)
+    return PRIMITIVE_BOOL;
+  bool Unsigned = isUnsigned(HintPrimitive);
+  switch (Width) {
+  case 1:
+    return PRIMITIVE_BOOL;
+  case 8:
+    return Unsigned ? PRIMITIVE_UCHAR : PRIMITIVE_CHAR;
+  case 16:
+    return Unsigned ? PRIMITIVE_USHORT : PRIMITIVE_SHORT;
+  case 32:
+    return Unsigned ? PRIMITIVE_UINT : PRIMITIVE_INT;
+  case 64:
+    return Unsigned ? PRIMITIVE_ULONG : PRIMITIVE_LONG;
+  default:
+    return PRIMITIVE_NONE;
+  }
+}
+
+static TypeAttributeEnum getAddressSpace(unsigned AddrSpace) {
+  switch (AddrSpace) {
+  case 0:
+    return ATTR_PRIVATE;
+  case 1:
+    return ATTR_GLOBAL;
+  case 2:
+    return ATTR_CONSTANT;
+  case 3:
+    return ATTR_LOCAL;
+  default:
+    return ATTR_NONE;
+  }
+}
+
+// Returns the name of a user defined type, without the "struct." or
+// "class." prefix clang adds.
+static std::string getUserTypeName(const llvm::StructType *STy) {
+  llvm::StringRef Name = STy->getName();
+  if (Name.startswith("struct."))
+    Name = Name.substr(7);
+  else if (Name.startswith("class."))
+    Name = Name.substr(6);
+  else if (Name.startswith("union."))
+    Name = Name.substr(6);
+  return Name.str();
+}
+
+RefParamType getParamType(const llvm::Type *Ty, const ParamType *Hint) {
+  if (const llvm::IntegerType *ITy = llvm::dyn_cast<llvm::IntegerType>(Ty)) {
+    TypePrimitiveEnum Primitive =
+      getIntegerPrimitive(ITy->getBitWidth(), Hint);
+    if (Primitive == PRIMITIVE_NONE)
+      return RefParamType();
+    return RefParamType(new PrimitiveType(Primitive));
+  }
+  if (Ty->isHalfTy())
+    return RefParamType(new PrimitiveType(PRIMITIVE_HALF));
+  if (Ty->isFloatTy())
+    return RefParamType(new PrimitiveType(PRIMITIVE_FLOAT));
+  if (Ty->isDoubleTy())
+    return RefParamType(new PrimitiveType(PRIMITIVE_DOUBLE));
+
+  if (const llvm::VectorType *VTy = llvm::dyn_cast<llvm::VectorType>(Ty)) {
+    const VectorType *VHint = Hint ? dyn_cast<VectorType>(Hint) : NULL;
+    RefParamType Scalar = getParamType(VTy->getElementType(),
+      VHint ? (const ParamType *)VHint->getScalarType() : NULL);
+    if (Scalar.isNull())
+      return RefParamType();
+    return RefParamType(new VectorType(Scalar, VTy->getNumElements()));
+  }
+
+  if (const llvm::PointerType *PTy = llvm::dyn_cast<llvm::PointerType>(Ty)) {
+    TypePrimitiveEnum Opaque = getOpaquePrimitive(PTy->getElementType());
+    if (Opaque != PRIMITIVE_NONE)
+      return RefParamType(new PrimitiveType(Opaque));
+    TypeAttributeEnum AddrSpace = getAddressSpace(PTy->getAddressSpace());
+    if (AddrSpace == ATTR_NONE)
+      return RefParamType();
+    const PointerType *PHint = Hint ? dyn_cast<PointerType>(Hint) : NULL;
+    RefParamType Pointee = getParamType(PTy->getElementType(),
+      PHint ? (const ParamType *)PHint->getPointee() : NULL);
+    if (Pointee.isNull())
+      return RefParamType();
+    PointerType *P = new PointerType(Pointee);
+    P->setAddressSpace(AddrSpace);
+    if (PHint)
+      for (unsigned q = ATTR_QUALIFIER_FIRST; q <= ATTR_QUALIFIER_LAST; q++)
+        P->setQualifier((TypeAttributeEnum)q,
+                        PHint->hasQualifier((TypeAttributeEnum)q));
+    return RefParamType(P);
+  }
+
+  if (const llvm::StructType *STy = llvm::dyn_cast<llvm::StructType>(Ty)) {
+    if (!STy->hasName())
+      return RefParamType();
+    const UserDefinedType *UHint =
+      Hint ? dyn_cast<UserDefinedType>(Hint) : NULL;
+    return RefParamType(
+      new UserDefinedType(UHint ? UHint->getName() : getUserTypeName(STy)));
+  }
+  return RefParamType();
+}
+
+// Returns the kernel_arg_* node of the given kernel, or NULL.
+static const llvm::MDNode *getKernelArgNode(const llvm::Function &F,
+                                            llvm::StringRef Kind) {
+  const llvm::Module *M = F.getParent();
+  const llvm::NamedMDNode *Kernels =
+    M ? M->getNamedMetadata(OPENCL_KERNELS_MD) : NULL;
+  if (!Kernels)
+    return NULL;
+  for (unsigned i = 0, e = Kernels->getNumOperands(); i != e; ++i) {
+    const llvm::MDNode *Kernel = Kernels->getOperand(i);
+    if (!Kernel || Kernel->getNumOperands() < 1 ||
+        Kernel->getOperand(0) != &F)
+      continue;
+    for (unsigned j = 1, je = Kernel->getNumOperands(); j != je; ++j) {
+      const llvm::MDNode *Node =
+        llvm::dyn_cast<llvm::MDNode>(Kernel->getOperand(j));
+      if (!Node || Node->getNumOperands() < 1)
+        continue;
+      const llvm::MDString *Name =
+        llvm::dyn_cast<llvm::MDString>(Node->getOperand(0));
+      if (Name && Name->getString() == Kind)
+        return Node;
+    }
+  }
+  return NULL;
+}
+
+// Returns the string operands of a kernel_arg_* node, one per argument.
+static llvm::StringRef getKernelArgString(const llvm::MDNode *Node,
+                                          unsigned ArgIndex) {
+  if (!Node || ArgIndex + 1 >= Node->getNumOperands())
+    return llvm::StringRef();
+  const llvm::MDString *S =
+    llvm::dyn_cast<llvm::MDString>(Node->getOperand(ArgIndex + 1));
+  return S ? S->getString() : llvm::StringRef();
+}
+
+bool getKernelArgTypes(const llvm::Function &F, FunctionDescriptor &FD) {
+  const llvm::MDNode *Types = getKernelArgNode(F, KERNEL_ARG_TYPE_MD);
+  if (!Types)
+    return false;
+  const llvm::MDNode *Quals = getKernelArgNode(F, KERNEL_ARG_TYPE_QUAL_MD);
+  // The integer types are sized by the LLVM signature, so the pointer size
+  // the metadata is parsed with does not matter.
+  const bool Is64Bit = false;
+  FD = FunctionDescriptor(F.getName().str());
+  for (unsigned i = 0, e = F.getFunctionType()->getNumParams(); i != e; ++i) {
+    RefParamType Type =
+      parseBuiltinType(getKernelArgString(Types, i), Is64Bit);
+    // The type qualifiers of pointer arguments apply to the pointee.
+    if (!Type.isNull()) {
+      if (PointerType *P = dyn_cast<PointerType>((ParamType *)Type)) {
+        llvm::StringRef Qual = getKernelArgString(Quals, i);
+        if (Qual.find("const") != llvm::StringRef::npos)
+          P->setQualifier(ATTR_CONST, true);
+        if (Qual.find("restrict") != llvm::StringRef::npos)
+          P->setQualifier(ATTR_RESTRICT, true);
+        if (Qual.find("volatile") != llvm::StringRef::npos)
+          P->setQualifier(ATTR_VOLATILE, true);
+      }
+    }
+    FD.parameters.push_back(Type);
+  }
+  return true;
+}
+
+FunctionDescriptor getFunctionDescriptor(const llvm::Function &F) {
+  FunctionDescriptor Hints = demangle(F.getName());
+  if (Hints.isNull() && !getKernelArgTypes(F, Hints))
+    Hints = FunctionDescriptor(F.getName().str());
+  return getFunctionDescriptor(F, Hints);
+}
+
+FunctionDescriptor getFunctionDescriptor(const llvm::Function &F,
+                                         const FunctionDescriptor &Hints) {
+  const llvm::FunctionType *FTy = F.getFunctionType();
+  FunctionDescriptor FD(Hints.name);
+  for (unsigned i = 0, e = FTy->getNumParams(); i != e; ++i) {
+    const ParamType *Hint = NULL;
+    if (i < Hints.parameters.size() && !Hints.parameters[i].isNull())
+      Hint = Hints.parameters[i];
+    RefParamType Type = getParamType(FTy->getParamType(i), Hint);
+    if (Type.isNull())
+      return FunctionDescriptor::null();
+    FD.parameters.push_back(std::move(Type));
+  }
+  // Like in the OpenCL headers, an empty parameter list is mangled as void.
+  if (!FTy->getNumParams() && !FTy->isVarArg())
+    FD.emplaceParameter<PrimitiveType>(PRIMITIVE_VOID);
+  if (FTy->isVarArg())
+    FD.emplaceParameter<PrimitiveType>(PRIMITIVE_VAR_ARG);
+  return FD;
+}
+
+} // End SPIR namespace
@@ -0,0 +1,60 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __FUNCTION_BRIDGE_H__
+#define __FUNCTION_BRIDGE_H__
+
+#include "spir_name_mangler/FunctionDescriptor.h"
+#include "spir_name_mangler/ParameterType.h"
+
+namespace llvm {
+  class Function;
+  class Type;
+}
+
+namespace SPIR {
+
+/// @brief Converts an LLVM type into the parameter type it is mangled as.
+///        LLVM types do not carry signedness, type qualifiers or the names of
+///        OpenCL types, those are taken from the hint when it has the same
+///        shape (integers are signed without one).
+/// @param llvm::Type the type of the parameter.
+/// @param ParamType the OpenCL type of the parameter, or NULL if unknown.
+/// @return the parameter type, or a null reference if the LLVM type has no
+///         mangling (e.g. arrays or an unknown address space).
+RefParamType getParamType(const llvm::Type*, const ParamType* hint);
+
+/// @brief Collects the OpenCL types of the parameters of a kernel from its
+///        kernel_arg_type and kernel_arg_type_qual metadata.
+/// @param llvm::Function the kernel.
+/// @param FunctionDescriptor receives the name of the kernel and its
+///        parameter types (a null reference for unknown ones).
+/// @return false if the function has no kernel_arg_type metadata.
+bool getKernelArgTypes(const llvm::Function&, FunctionDescriptor&);
+
+/// @brief Builds the function descriptor of an LLVM function from its
+///        signature. Hints for the parameter types come from the demangled
+///        name of the function, if it is mangled, or else from its kernel
+///        argument metadata.
+/// @param llvm::Function the function.
+/// @return the function descriptor, or FunctionDescriptor::null() if one of
+///         the parameters cannot be mangled.
+FunctionDescriptor getFunctionDescriptor(const llvm::Function&);
+
+/// @brief Builds the function descriptor of an LLVM function from its
+///        signature, with the given name and parameter hints.
+/// @param llvm::Function the function.
+/// @param FunctionDescriptor the name of the function and the OpenCL types
+///        of its parameters (missing or null ones are unknown).
+/// @return the function descriptor, or FunctionDescriptor::null() if one of
+///         the parameters cannot be mangled.
+FunctionDescriptor getFunctionDescriptor(const llvm::Function&,
+                                         const FunctionDescriptor& hints);
+
+} // End SPIR namespace
+
+#endif // __FUNCTION_BRIDGE_H__
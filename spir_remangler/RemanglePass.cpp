@@ -0,0 +1,95 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "RemanglePass.h"
+#include "FunctionBridge.h"
+
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/NameRecognizer.h"
+
+#include "llvm/Function.h"
+#include "llvm/Module.h"
+#include "llvm/ADT/SmallString.h"
+
+namespace SPIR {
+
+//
+// RemanglePass class public methods.
+//
+
+char RemanglePass::ID = 0;
+
+RemanglePass::RemanglePass() : ModulePass(ID), NumRenamed(0), NumFailed(0),
+  NumCacheHits(0) {
+}
+
+RemanglePass::~RemanglePass() {
+}
+
+const char *RemanglePass::getPassName() const {
+  return "Spir re-mangling";
+}
+
+bool RemanglePass::runOnModule(llvm::Module &M) {
+  NumRenamed = NumFailed = NumCacheHits = 0;
+  // Function types belong to the context of the module.
+  Cache.clear();
+  llvm::SmallString<128> NewName;
+  for (llvm::Module::iterator I = M.begin(), E = M.end(); I != E; ++I) {
+    llvm::Function &F = *I;
+    RecognizedName Name;
+    if (!F.isDeclaration() || !recognize(F.getName(), Name))
+      continue;
+    // The parameter list starts after the function name.
+    size_t ParamsStart = Name.name.end() - Name.mangled.begin();
+    llvm::StringRef OldParams = Name.mangled.substr(ParamsStart);
+    const std::string &NewParams = getParameters(F, OldParams);
+    if (NewParams.empty()) {
+      ++NumFailed;
+      continue;
+    }
+    if (NewParams == OldParams)
+      continue;
+    NewName.clear();
+    NewName.append(Name.mangled.begin(), Name.mangled.begin() + ParamsStart);
+    NewName.append(NewParams.begin(), NewParams.end());
+    // Another declaration already has the name. Merging them would need
+    // their users to be rewritten, so they are left alone.
+    if (M.getFunction(NewName)) {
+      ++NumFailed;
+      continue;
+    }
+    F.setName(NewName.str());
+    ++NumRenamed;
+  }
+  return NumRenamed != 0;
+}
+
+//
+// RemanglePass class private methods.
+//
+
+const std::string &RemanglePass::getParameters(const llvm::Function &F,
+                                               llvm::StringRef Params) {
+  CacheKey Key(F.getFunctionType(), Params.str());
+  std::map<CacheKey, std::string>::iterator It = Cache.lower_bound(Key);
+  if (It != Cache.end() && It->first == Key) {
+    ++NumCacheHits;
+    return It->second;
+  }
+  std::string &Result = Cache.insert(It, std::make_pair(Key, std::string()))
+    ->second;
+  FunctionDescriptor FD = getFunctionDescriptor(F);
+  if (FD.isNull())
+    return Result;
+  llvm::SmallString<64> Mangled;
+  mangleParameters(FD, Mangled);
+  Result.assign(Mangled.begin(), Mangled.end());
+  return Result;
+}
+
+} // End SPIR namespace
@@ -0,0 +1,89 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#ifndef __REMANGLE_PASS_H__
+#define __REMANGLE_PASS_H__
+
+#include "llvm/Pass.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <map>
+#include <string>
+#include <utility>
+
+namespace llvm {
+  class Function;
+  class FunctionType;
+}
+
+namespace SPIR {
+
+/// @brief Re-mangles the names of all mangled function declarations of a
+///        module from their LLVM signatures, so the names agree with the
+///        types the functions are called with. The mangled parameter list is
+///        computed once per distinct function type and original parameter
+///        mangling, and shared by all overloads using it.
+class RemanglePass : public llvm::ModulePass {
+public:
+
+  /// @brief Pass identification, replacement for typeid.
+  static char ID;
+
+  /// @brief Constructor.
+  RemanglePass();
+
+  /// @brief Destructor.
+  virtual ~RemanglePass();
+
+  /// @brief Provides name of pass.
+  virtual const char *getPassName() const;
+
+  /// @brief LLVM Module pass entry.
+  /// @param M Module to transform.
+  /// @returns true if changed.
+  bool runOnModule(llvm::Module&);
+
+  /// @brief Returns the number of declarations renamed by the last run.
+  unsigned getNumRenamed() const {
+    return NumRenamed;
+  }
+
+  /// @brief Returns the number of declarations of the last run whose
+  ///        signature could not be mangled, or whose new name was taken.
+  unsigned getNumFailed() const {
+    return NumFailed;
+  }
+
+  /// @brief Returns the number of mangled parameter lists of the last run
+  ///        which were found in the cache.
+  unsigned getNumCacheHits() const {
+    return NumCacheHits;
+  }
+
+private:
+
+  /// @brief Returns the new mangled parameter list of a declaration, or an
+  ///        empty string if its signature cannot be mangled.
+  /// @param F the declaration.
+  /// @param Params the mangled parameter list of its current name.
+  const std::string &getParameters(const llvm::Function &F,
+                                   llvm::StringRef Params);
+
+  typedef std::pair<const llvm::FunctionType *, std::string> CacheKey;
+
+  /// @brief Mangled parameter lists, by function type and original mangling
+  ///        (which provides what LLVM types lack, such as signedness).
+  std::map<CacheKey, std::string> Cache;
+
+  unsigned NumRenamed;
+  unsigned NumFailed;
+  unsigned NumCacheHits;
+};
+
+} // End SPIR namespace
+
+#endif // __REMANGLE_PASS_H__
@@ -5,64 +5,459 @@
 // License. See LICENSE.TXT for details.
 //
 
+#include "validation/SpirTables.h"
 #include "validation/SpirValidation.h"
 
 #include "llvm/LLVMContext.h"
+#include "llvm/Module.h"
 #include "llvm/ADT/OwningPtr.h"
 #include "llvm/Bitcode/ReaderWriter.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/system_error.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
 using namespace llvm;
 using namespace SPIR;
 
-static cl::opt<std::string>
-InputFilename(cl::Positional, cl::desc("<input bitcode file>"),
-    cl::init(""), cl::value_desc("filename"));
+static cl::list<std::string>
+InputFilenames(cl::Positional, cl::desc("<input bitcode files>"),
+    cl::ZeroOrMore, cl::value_desc("filename"));
 
-const char *HelpMessage = "SPIR Verifier expects argument <path to file name>...\n";
+static cl::opt<unsigned>
+NumThreads("threads",
+    cl::desc("Number of threads verifying functions (0 for one per core)"),
+    cl::init(1), cl::value_desc("N"));
 
-int main(int argc, const char *argv[]) {
-  cl::ParseCommandLineOptions(argc, argv, "SPIR verifier");
+static cl::opt<unsigned>
+NumJobs("j", cl::Prefix,
+    cl::desc("Number of files verified at a time (0 for one per core)"),
+    cl::init(1), cl::value_desc("N"));
 
-  if (InputFilename.empty()) {
-    errs() << HelpMessage;
-    return 1;
+static cl::opt<bool>
+ServerMode("server",
+    cl::desc("Verify the requests read from the standard input"),
+    cl::init(false));
+
+static cl::opt<unsigned>
+MaxRequestSize("max-request-size",
+    cl::desc("Largest bitcode request accepted by -server, in bytes"),
+    cl::init(256 << 20), cl::value_desc("N"));
+
+static cl::opt<bool>
+LazyMode("lazy",
+    cl::desc("Read the function bodies one at a time (bounds the memory used)"),
+    cl::init(false));
+
+static cl::opt<bool>
+TriageMode("triage",
+    cl::desc("Check only the triple, data layout, versions and kernels "
+             "metadata, reading no function body"),
+    cl::init(false));
+
+const char *HelpMessage = "SPIR Verifier expects argument <path to file name>...\n"
+  "Several files (or @file, a file listing them) may be given.\n";
+
+const char *Overview = "SPIR verifier\n\n"
+  "  With -server, requests are read from the standard input, one per line:\n"
+  "    file <path>    verify the bitcode file at <path>\n"
+  "    bitcode <n>    verify the <n> bytes of bitcode following the line\n"
+  "  and answered in order on the standard output with a line\n"
+  "    <verdict> <n>\n"
+  "  followed by <n> bytes of report (the errors found). <verdict> is\n"
+  "  valid, invalid, unreadable or error (a malformed request, or bitcode\n"
+  "  larger than -max-request-size).\n";
+
+/// @brief The outcome of the verification of a file.
+enum Verdict {
+  VERDICT_VALID,
+  VERDICT_INVALID,
+  /// The file could not be read.
+  VERDICT_UNREADABLE,
+  /// The request for the file was malformed.
+  VERDICT_ERROR
+};
+
+static const char *VerdictNames[] = {
+  "valid", "invalid", "unreadable", "error"
+};
+
+/// @brief A file to verify, given by its path or its contents.
+struct Input {
+  Input() : HasData(false) {
   }
 
-  StringRef Path = InputFilename;
-  LLVMContext Ctx;
-  OwningPtr<MemoryBuffer> result;
+  /// @brief Path of the file (or a name for its contents).
+  std::string Name;
+  /// @brief Contents of the file, if HasData.
+  std::string Data;
+  bool HasData;
+  /// @brief Why the request for the file is malformed, if it is.
+  std::string Error;
+};
 
-  // Parse the bitcode file into a module.
-  error_code ErrCode = MemoryBuffer::getFile(Path, result);
+/// @brief The verdict and messages of a file, kept until the verdicts of
+///        the files before it are printed.
+struct FileResult {
+  FileResult() : Done(false), V(VERDICT_UNREADABLE) {
+  }
 
-  if (!result.get()) {
-    errs() << "Buffer Creation Error. " << ErrCode.message() << "\n";
-    return 1;
+  bool Done;
+  Verdict V;
+  std::string Out;
+  std::string Err;
+};
+
+/// @brief Prints the verdict and errors of a module.
+/// @returns the verdict.
+static Verdict printErrors(const ErrorPrinter *EP, StringRef Name,
+                           raw_ostream &Out, raw_ostream &Err) {
+  if (EP->hasErrors()) {
+    Out << "According to this SPIR Verifier, " << Name << " is an invalid SPIR module.\n";
+    Err << "The module contains the following errors:\n\n";
+    EP->print(Err);
+    return VERDICT_INVALID;
   }
 
+  Out << "According to this SPIR Verifier, " << Name << " is a valid SPIR module.\n";
+  return VERDICT_VALID;
+}
+
+/// @brief Verifies a bitcode buffer.
+/// @param Buffer the bitcode, taken by the module if it is loaded lazily.
+/// @param Name name of the file, for the verdict.
+/// @param Ctx context to load the module in.
+/// @param Out stream for the verdict.
+/// @param Err stream for the errors.
+/// @returns the verdict.
+static Verdict verifyBuffer(OwningPtr<MemoryBuffer> &Buffer, StringRef Name,
+                            LLVMContext &Ctx, raw_ostream &Out,
+                            raw_ostream &Err) {
   std::string ErrMsg;
-  Module *M = ParseBitcodeFile(result.get(), Ctx, &ErrMsg);
+  if (TriageMode) {
+    // Most files which are not SPIR are rejected by their triple alone,
+    // read from the module block without reading the module.
+    std::string Triple = getBitcodeTargetTriple(Buffer.get(), Ctx, &ErrMsg);
+    if (ErrMsg.empty() && Triple != SPIR32_TRIPLE &&
+        Triple != SPIR64_TRIPLE) {
+      ErrorHolder Errors;
+      Errors.addError(ERR_INVALID_TRIPLE, Triple);
+      return printErrors(&Errors, Name, Out, Err);
+    }
+  }
+
+  OwningPtr<Module> M;
+  if (LazyMode || TriageMode) {
+    // Only the module header is read, the function bodies are read by the
+    // validation, one at a time (or not at all when triaging).
+    M.reset(getLazyBitcodeModule(Buffer.get(), Ctx, &ErrMsg));
+    if (M)
+      Buffer.take();
+  } else {
+    M.reset(ParseBitcodeFile(Buffer.get(), Ctx, &ErrMsg));
+  }
   if (!M) {
-    outs() << "According to this SPIR Verifier, " << Path << " is an invalid SPIR module.\n";
-    errs() << "Bitcode parsing error. " << ErrMsg << "\n";
-    return 1;
+    Out << "According to this SPIR Verifier, " << Name << " is an invalid SPIR module.\n";
+    Err << "Bitcode parsing error. " << ErrMsg << "\n";
+    return VERDICT_INVALID;
   }
 
   // Run the verification pass, and report errors if necessary.
   SpirValidation Validation;
-  Validation.runOnModule(*M);
-  const ErrorPrinter *EP = Validation.getErrorPrinter();
-  if (EP->hasErrors()) {
-    outs() << "According to this SPIR Verifier, " << Path << " is an invalid SPIR module.\n";
-    errs() << "The module contains the following errors:\n\n";
-    EP->print(errs());
+  if (TriageMode) {
+    Validation.triageModule(*M);
+  } else {
+    Validation.setNumThreads(NumThreads);
+    Validation.runOnModule(*M);
+  }
+  return printErrors(Validation.getErrorPrinter(), Name, Out, Err);
+}
+
+/// @brief Verifies a file, see verifyBuffer().
+static Verdict verifyInput(const Input &In, LLVMContext &Ctx,
+                           raw_ostream &Out, raw_ostream &Err) {
+  if (!In.Error.empty()) {
+    Err << In.Error << "\n";
+    return VERDICT_ERROR;
+  }
+  if (In.HasData) {
+    OwningPtr<MemoryBuffer> Buffer(
+      MemoryBuffer::getMemBuffer(In.Data, In.Name));
+    return verifyBuffer(Buffer, In.Name, Ctx, Out, Err);
+  }
+
+  OwningPtr<MemoryBuffer> result;
+
+  // Parse the bitcode file into a module.
+  error_code ErrCode = MemoryBuffer::getFile(In.Name, result);
+
+  if (!result.get()) {
+    Err << "Buffer Creation Error. " << ErrCode.message() << "\n";
+    return VERDICT_UNREADABLE;
+  }
+  return verifyBuffer(result, In.Name, Ctx, Out, Err);
+}
+
+/// @brief The files to verify, from the thread reading them (the command
+///        line or the requests) to the workers verifying them, then to the
+///        thread printing their results in input order. Holds a bounded
+///        number of files, so results waiting for the files before them to
+///        be printed use bounded memory.
+class WorkQueue {
+public:
+  /// @brief Constructor.
+  /// @param W maximal number of files not printed yet.
+  explicit WorkQueue(unsigned W) :
+    Window(W), First(0), Next(0), Closed(false) {
+  }
+
+  /// @brief Appends a file, waiting while the queue is full.
+  /// @param In the file, left empty.
+  void push(Input &In) {
+    std::unique_lock<std::mutex> L(Lock);
+    while (Entries.size() >= Window)
+      Printed.wait(L);
+    Entries.push_back(Entry());
+    std::swap(Entries.back().In, In);
+    Pushed.notify_all();
+  }
+
+  /// @brief Tells that no file will be appended.
+  void close() {
+    std::unique_lock<std::mutex> L(Lock);
+    Closed = true;
+    Pushed.notify_all();
+    Verified.notify_all();
+  }
+
+  /// @brief Takes the next file to verify, waiting for one if needed.
+  /// @param Index receives the index of the file.
+  /// @param In receives the file.
+  /// @returns false when the queue is closed and all files are taken.
+  bool take(unsigned &Index, Input &In) {
+    std::unique_lock<std::mutex> L(Lock);
+    while (!Closed && Next == First + Entries.size())
+      Pushed.wait(L);
+    if (Next == First + Entries.size())
+      return false;
+    Index = Next++;
+    std::swap(In, Entries[Index - First].In);
+    return true;
+  }
+
+  /// @brief Sets the result of a file.
+  /// @param Index the index of the file.
+  /// @param R its result, left empty.
+  void complete(unsigned Index, FileResult &R) {
+    std::unique_lock<std::mutex> L(Lock);
+    FileResult &Result = Entries[Index - First].Result;
+    std::swap(Result, R);
+    Result.Done = true;
+    Verified.notify_all();
+  }
+
+  /// @brief Removes the oldest file, waiting for its result if needed.
+  /// @param R receives its result.
+  /// @returns false when the queue is closed and all files are removed.
+  bool pop(FileResult &R) {
+    std::unique_lock<std::mutex> L(Lock);
+    while (!(Closed && Entries.empty()) &&
+           (Entries.empty() || !Entries.front().Result.Done))
+      Verified.wait(L);
+    if (Entries.empty())
+      return false;
+    std::swap(R, Entries.front().Result);
+    Entries.pop_front();
+    First++;
+    Printed.notify_all();
+    return true;
+  }
+
+private:
+  struct Entry {
+    Input In;
+    FileResult Result;
+  };
+
+  unsigned Window;
+  std::deque<Entry> Entries;
+  /// @brief Index of the first entry.
+  unsigned First;
+  /// @brief Index of the next file to verify.
+  unsigned Next;
+  bool Closed;
+  std::mutex Lock;
+  std::condition_variable Pushed;
+  std::condition_variable Verified;
+  std::condition_variable Printed;
+};
+
+/// @brief Verifies files of the queue until there are none left.
+static void verifyInputs(WorkQueue &Q) {
+  unsigned Index;
+  Input In;
+  while (Q.take(Index, In)) {
+    // Named types outlive their module in a context (a second module would
+    // get "opencl.image2d_t.0"), so each file gets a fresh one.
+    LLVMContext Ctx;
+    FileResult R;
+    raw_string_ostream Out(R.Out), Err(R.Err);
+    R.V = verifyInput(In, Ctx, Out, Err);
+    Out.flush();
+    Err.flush();
+    Q.complete(Index, R);
+  }
+}
+
+/// @brief Number of files of each verdict.
+struct Counts {
+  Counts() : Valid(0), Invalid(0), Unreadable(0) {
+  }
+
+  unsigned Valid;
+  unsigned Invalid;
+  unsigned Unreadable;
+};
+
+/// @brief Prints the verdict and errors of each file of the queue.
+static void printVerdicts(WorkQueue &Q, Counts &C) {
+  FileResult R;
+  while (Q.pop(R)) {
+    outs() << R.Out;
+    outs().flush();
+    errs() << R.Err;
+    switch (R.V) {
+    case VERDICT_VALID:
+      C.Valid++;
+      break;
+    case VERDICT_INVALID:
+      C.Invalid++;
+      break;
+    case VERDICT_UNREADABLE:
+    case VERDICT_ERROR:
+      C.Unreadable++;
+      break;
+    }
+  }
+}
+
+/// @brief Answers each request of the queue (see Overview).
+static void printResponses(WorkQueue &Q) {
+  FileResult R;
+  while (Q.pop(R)) {
+    outs() << VerdictNames[R.V] << " " << R.Err.size() << "\n" << R.Err;
+    outs().flush();
+  }
+}
+
+/// @brief Reads the requests of the standard input (see Overview) until its
+///        end, and queues them.
+static void readRequests(WorkQueue &Q) {
+#ifdef _WIN32
+  _setmode(_fileno(stdin), _O_BINARY);
+#endif
+  std::string Line;
+  while (std::getline(std::cin, Line)) {
+    StringRef Request(Line);
+    Request = Request.rtrim("\r");
+    if (Request.empty())
+      continue;
+    Input In;
+    if (Request.startswith("file ")) {
+      In.Name = Request.substr(5).str();
+    } else if (Request.startswith("bitcode ")) {
+      unsigned Size;
+      if (Request.substr(8).getAsInteger(10, Size)) {
+        In.Error = "Invalid bitcode size: " + Request.str();
+      } else if (Size > MaxRequestSize) {
+        // The bitcode is skipped rather than stored, so that the next
+        // request is still found.
+        In.Error = "Bitcode request too large: " + Request.str();
+        std::cin.ignore(Size);
+      } else {
+        In.Name = "<stdin>";
+        In.HasData = true;
+        In.Data.resize(Size);
+        if (Size)
+          std::cin.read(&In.Data[0], Size);
+        if ((unsigned)std::cin.gcount() != Size) {
+          In.HasData = false;
+          In.Error = "Truncated bitcode request";
+        }
+      }
+    } else {
+      In.Error = "Unknown request: " + Request.str();
+    }
+    Q.push(In);
+  }
+}
+
+int main(int argc, const char *argv[]) {
+  cl::ParseCommandLineOptions(argc, argv, Overview);
+
+  if (!ServerMode && InputFilenames.empty()) {
+    errs() << HelpMessage;
     return 1;
   }
 
-  outs() << "According to this SPIR Verifier, " << Path << " is a valid SPIR module.\n";
-  return 0;
+  unsigned Jobs = NumJobs;
+  if (!Jobs)
+    Jobs = std::max(std::thread::hardware_concurrency(), 1U);
+  if (!ServerMode)
+    Jobs = std::min<size_t>(Jobs, InputFilenames.size());
+  if (Jobs > 1 && !llvm_start_multithreaded())
+    Jobs = 1;
+
+  // Read the files (or requests) on this thread, verify them on the
+  // workers, and print the result of each in input order, as soon as the
+  // files before it are done.
+  WorkQueue Q(4 * Jobs);
+  std::vector<std::thread> Workers;
+  for (unsigned t = 0; t < Jobs; t++)
+    Workers.push_back(std::thread(verifyInputs, std::ref(Q)));
+  Counts C;
+  std::thread Printer;
+  if (ServerMode)
+    Printer = std::thread(printResponses, std::ref(Q));
+  else
+    Printer = std::thread(printVerdicts, std::ref(Q), std::ref(C));
+
+  if (ServerMode) {
+    readRequests(Q);
+  } else {
+    for (unsigned i = 0; i < InputFilenames.size(); i++) {
+      Input In;
+      In.Name = InputFilenames[i];
+      Q.push(In);
+    }
+  }
+  Q.close();
+  for (unsigned t = 0; t < Workers.size(); t++)
+    Workers[t].join();
+  Printer.join();
+
+  if (ServerMode)
+    return 0;
+  if (InputFilenames.size() > 1) {
+    outs() << "Verified " << InputFilenames.size() << " files: " << C.Valid
+           << " valid, " << C.Invalid << " invalid, " << C.Unreadable
+           << " unreadable.\n";
+  }
+  return (C.Invalid || C.Unreadable) ? 1 : 0;
 }
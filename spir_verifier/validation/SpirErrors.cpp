@@ -40,6 +40,7 @@ namespace SPIR {
   INFO_METADATA_KERNEL_ARG_INFO,
   INFO_METADATA_VERSION,
   INFO_MEM_FENCE,
+  INFO_BUILTIN,
 
   SPIR_INFO_NUM
 } SPIR_INFO_TYPE;
@@ -131,9 +132,13 @@ const SPIR_ERROR_DATA g_ErrorData[SPIR_ERROR_NUM] = {
       {INFO_INDIRECT_CALL}},
   {ERR_INVALID_MEM_FENCE, "Invalid cl_mem_fence value",
       {INFO_MEM_FENCE}},
+  {ERR_UNKNOWN_BUILTIN, "Call to an unknown built-in function",
+      {INFO_BUILTIN}},
   // Function errors
   {ERR_INVALID_CALLING_CONVENTION, "Invalid calling convention",
       {INFO_CALLING_CONVENTION}},
+  {ERR_UNREADABLE_FUNCTION_BODY, "Function body could not be read",
+      {}},
   // Metadata errors
   {ERR_INVALID_CORE_FEATURE, "Invalid core features",
       {INFO_CORE_FEATURE_METADATA}},
@@ -172,7 +177,8 @@ const SPIR_INFO_DATA g_InfoData[SPIR_INFO_NUM] = {
   {INFO_NAMED_METADATA, getValidNamedMetadataMsg},
   {INFO_METADATA_KERNEL_ARG_INFO, getValidKernelArgInfoMsg},
   {INFO_METADATA_VERSION, getValidVersionMsg},
-  {INFO_MEM_FENCE, getValidMemFenceMsg}
+  {INFO_MEM_FENCE, getValidMemFenceMsg},
+  {INFO_BUILTIN, getValidBuiltinMsg}
 };
 
 static bool isValidTables() {
@@ -338,4 +344,8 @@ bool ErrorHolder::hasErrors() const {
   return !EL.empty();
 }
 
+void ErrorHolder::takeErrors(ErrorHolder &Other) {
+  EL.splice(EL.end(), Other.EL);
+}
+
 } // End SPIR namespace
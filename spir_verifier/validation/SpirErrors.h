@@ -40,8 +40,10 @@ typedef enum {
   ERR_INVALID_ADDR_SPACE_CAST,
   ERR_INVALID_INDIRECT_CALL,
   ERR_INVALID_MEM_FENCE,
+  ERR_UNKNOWN_BUILTIN,
   // Function errors
   ERR_INVALID_CALLING_CONVENTION,
+  ERR_UNREADABLE_FUNCTION_BODY,
   // Metadata errors
   ERR_INVALID_CORE_FEATURE,
   ERR_INVALID_KHR_EXT,
@@ -120,7 +122,14 @@ struct ErrorHolder : ErrorCreator, ErrorPrinter {
   virtual void print(llvm::raw_ostream &S) const;
   virtual bool hasErrors() const;
 
+  /// @brief Moves the errors of another holder after the errors of this one.
+  /// @param Other holder to take the errors of, left empty.
+  void takeErrors(ErrorHolder &Other);
+
 private:
+  ErrorHolder(const ErrorHolder&);
+  ErrorHolder& operator=(const ErrorHolder&);
+
   /// @brief List of errors found in the module
   ErrorList EL;
 };
@@ -8,6 +8,11 @@
 #include "SpirIterators.h"
 #include "SpirErrors.h"
 #include "SpirTables.h"
+// The mangler headers declare SPIR::VectorType and SPIR::PointerType, which
+// hide the LLVM types of the same names in the code below: those must be
+// written llvm::VectorType and llvm::PointerType.
+#include "spir_name_mangler/BuiltinTable.h"
+#include "spir_name_mangler/NameRecognizer.h"
 
 #include "llvm/Module.h"
 #include "llvm/Function.h"
@@ -166,6 +171,15 @@ static bool isMDNodeTypeOf(const Value *V, StringRef type) {
   return StringVal && StringVal->getString() == type;
 }
 
+/// @brief Check if given function has no body. Functions of a lazily loaded
+///        module whose body is not read yet (or was dropped) look like
+///        declarations, but are definitions.
+/// @param F given function.
+/// @returns true if F is a declaration, false otherwise.
+static bool isDeclaration(const Function *F) {
+  return F->isDeclaration() && !F->isMaterializable();
+}
+
 static bool isAllowedIntrinsic(StringRef FName) {
   bool IsValidIntrinsic = hasPrefixValidNameOf(FName,
     g_valid_instrinsic, g_valid_instrinsic_len) != 0;
@@ -252,7 +266,7 @@ static bool isValidType(Type *Ty, DataHolder *D,
   }
 
   // Check if it is a vector
-  if (const VectorType *VTy = dyn_cast<VectorType>(Ty)) {
+  if (const llvm::VectorType *VTy = dyn_cast<llvm::VectorType>(Ty)) {
     if (!isValidVectorElementsNum(VTy->getNumElements())) {
       return false;
     }
@@ -300,7 +314,7 @@ static std::string MapLLVMToOCL(Type *Ty, bool &Ignore) {
   }
 
   // Check if it is a vector
-  if (const VectorType *VTy = dyn_cast<VectorType>(Ty)) {
+  if (const llvm::VectorType *VTy = dyn_cast<llvm::VectorType>(Ty)) {
     std::stringstream SS;
     SS << MapLLVMToOCL(VTy->getElementType(), Ignore) << VTy->getNumElements();
     return SS.str();
@@ -386,8 +400,8 @@ static bool isValidMapOCLToLLVM(StringRef TyName, Type *Ty, DataHolder *D) {
 }
 
 static bool isValidAddrSpaceCast(const BitCastInst *BI) {
-  const PointerType *LHS = dyn_cast<PointerType>(BI->getDestTy()),
-                    *RHS = dyn_cast<PointerType>(BI->getSrcTy());
+  const llvm::PointerType *LHS = dyn_cast<llvm::PointerType>(BI->getDestTy()),
+                          *RHS = dyn_cast<llvm::PointerType>(BI->getSrcTy());
   if (!LHS || !RHS)
     return true;
 
@@ -409,13 +423,14 @@ static bool isValidAddrSpaceCast(const User *V) {
   if (!CE)
     return true;
 
-  const PointerType *PTy  = dyn_cast<PointerType>(CE->getType());
+  const llvm::PointerType *PTy  = dyn_cast<llvm::PointerType>(CE->getType());
   if (!PTy)
     return true;
 
   const unsigned int DstAddress = PTy->getAddressSpace();
   if (Instruction::BitCast == CE->getOpcode()) {
-    const PointerType *STy = dyn_cast<PointerType>(CE->getOperand(0)->getType());
+    const llvm::PointerType *STy =
+      dyn_cast<llvm::PointerType>(CE->getOperand(0)->getType());
     if (STy) {
       const unsigned int SrcAddress = STy->getAddressSpace();
       return (SrcAddress == DstAddress);
@@ -458,7 +473,7 @@ void VerifyCall::execute(const Instruction *I) {
     return;
   }
 
-  if (!F->isDeclaration()) {
+  if (!isDeclaration(F)) {
     // Verify that this call has valid calling convention.
     if (CI->getCallingConv() != CallingConv::SPIR_KERNEL && 
         CI->getCallingConv() != CallingConv::SPIR_FUNC) {
@@ -467,7 +482,9 @@ void VerifyCall::execute(const Instruction *I) {
   }
 
   // Verify valid memfence for synchronize functions
-  if (hasPrefixValidNameOf(F->getName(), g_valid_sync_bi, g_valid_sync_bi_len)) {
+  RecognizedName Name;
+  if (recognize(F->getName(), Name) &&
+      isValidNameOf(Name.name, g_valid_sync_bi, g_valid_sync_bi_len)) {
     if (CI->getNumArgOperands() != 1) {
       ErrCreator->addError(ERR_INVALID_MEM_FENCE, I);
     }
@@ -484,6 +501,29 @@ void VerifyCall::execute(const Instruction *I) {
   }
 }
 
+void VerifyBuiltinCall::execute(const Instruction *I) {
+  const CallInst *CI = dyn_cast<CallInst>(I);
+  if (!CI)
+    return;
+
+  // Indirect calls, intrinsics and calls to defined functions are verified
+  // by VerifyCall.
+  const Function *F = CI->getCalledFunction();
+  if (!F || !isDeclaration(F) || F->isIntrinsic())
+    return;
+
+  DenseMap<const Function*, bool>::iterator it = KnownCallees.find(F);
+  if (it == KnownCallees.end()) {
+    // The module executors ran first, the pointer size is known.
+    bool IsKnown = lookupBuiltin(F->getName(), !Data->Is32Bit).isValid() ||
+      isValidNameOf(F->getName(), g_valid_unmangled_bi,
+                    g_valid_unmangled_bi_len);
+    it = KnownCallees.insert(std::make_pair(F, IsKnown)).first;
+  }
+  if (!it->second)
+    ErrCreator->addError(ERR_UNKNOWN_BUILTIN, I);
+}
+
 void VerifyBitcast::execute(const Instruction *I) {
   if (const BitCastInst *BI = dyn_cast<BitCastInst>(I)) {
     // Verify that this bitcast is not adress space cast.
@@ -516,7 +556,7 @@ void VerifyInstructionType::execute(const Instruction *I) {
 }
 
 void VerifyFunctionPrototype::execute(const Function *F) {
-  if (!F->isDeclaration()) {
+  if (!isDeclaration(F)) {
     // Verify calling convention for user defined functions
     if (F->getCallingConv() != CallingConv::SPIR_KERNEL && 
         F->getCallingConv() != CallingConv::SPIR_FUNC)
@@ -587,7 +627,7 @@ void VerifyMetadataArgAddrSpace::execute(const llvm::MDNode *Node) {
     const unsigned ArgIndex = i-1;
     Type *Ty = Func->getFunctionType()->getParamType(ArgIndex);
     unsigned ArgAddrSpace = 0;
-    if (PointerType *PTy = dyn_cast<PointerType>(Ty)) {
+    if (llvm::PointerType *PTy = dyn_cast<llvm::PointerType>(Ty)) {
       ArgAddrSpace = PTy->getAddressSpace();
     }
     if (ArgAddrSpace != AddrSpaceVal) {
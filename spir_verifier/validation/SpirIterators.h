@@ -8,6 +8,8 @@
 #ifndef __SPIR_ITERATORS_H__
 #define __SPIR_ITERATORS_H__
 
+#include "llvm/ADT/DenseMap.h"
+
 #include <list>
 #include <map>
 
@@ -181,6 +183,27 @@ private:
   ErrorCreator *ErrCreator;
 };
 
+struct VerifyBuiltinCall : public InstructionExecutor {
+  /// @brief Constructor.
+  /// @param EH error holder.
+  /// @param D data holder.
+  VerifyBuiltinCall(ErrorCreator *EH, DataHolder *D) :
+    ErrCreator(EH), Data(D) {
+  }
+
+  /// @brief Verify that given instruction is not a call to a declaration
+  ///        which is not a built-in of the pointer size of the module.
+  /// @param I instruction to verify.
+  void execute(const Instruction *I);
+
+private:
+  ErrorCreator *ErrCreator;
+  DataHolder *Data;
+  /// @brief Whether each declaration called so far is a built-in, so the
+  ///        built-in table is probed once per callee, not per call.
+  DenseMap<const Function*, bool> KnownCallees;
+};
+
 struct VerifyBitcast : public InstructionExecutor {
   /// @brief Constructor.
   /// @param EH error holder.
@@ -199,11 +199,18 @@ const char *g_ignored_instrinsic[] = {
 DCL_ARRAY_LENGTH(g_ignored_instrinsic);
 
 
+// Names (demangled) of the synchronization built-ins.
 const char *g_valid_sync_bi[] = {
-  "_Z7barrier"
+  "barrier"
 };
 DCL_ARRAY_LENGTH(g_valid_sync_bi);
 
+// Built-ins declared without overloadable, hence not mangled.
+const char *g_valid_unmangled_bi[] = {
+  "printf"
+};
+DCL_ARRAY_LENGTH(g_valid_unmangled_bi);
+
 const char *g_valid_address_space[] = {
   "private",
   "global",
@@ -450,6 +457,19 @@ std::string getValidMemFenceMsg() {
   return Msg;
 }
 
+std::string getValidBuiltinMsg() {
+  std::string Msg;
+  Msg += "Functions called but not defined in " + STR_SPIR +
+         " must be OpenCL C built-in functions,\n";
+  Msg += "declared with their mangled name for the pointer size of "
+         "the module.\n";
+  Msg += STR_IND1 + "Valid unmangled built-in functions are:\n";
+  for (unsigned i=0; i<g_valid_unmangled_bi_len; i++) {
+    Msg += STR_IND2 + g_valid_unmangled_bi[i] + "\n";
+  }
+  return Msg;
+}
+
 std::string getMapOpenCLToLLVMMsg() {
   std::string Msg;
   Msg += "OpenCL C mapping to SPIR\n";
@@ -84,6 +84,9 @@ EXTREN_DCL_ARRAY_LENGTH(g_ignored_instrinsic);
 extern const char *g_valid_sync_bi[];
 EXTREN_DCL_ARRAY_LENGTH(g_valid_sync_bi);
 
+extern const char *g_valid_unmangled_bi[];
+EXTREN_DCL_ARRAY_LENGTH(g_valid_unmangled_bi);
+
 extern const char *g_valid_address_space[];
 EXTREN_DCL_ARRAY_LENGTH(g_valid_address_space);
 
@@ -143,6 +146,8 @@ extern std::string getValidVersionMsg();
 
 extern std::string getValidMemFenceMsg();
 
+extern std::string getValidBuiltinMsg();
+
 extern std::string getMapOpenCLToLLVMMsg();
 
 extern std::string getValidNamedMetadataMsg();
@@ -8,23 +8,111 @@
 #include "SpirValidation.h"
 #include "SpirErrors.h"
 #include "SpirIterators.h"
+#include "SpirTables.h"
 
 #include "llvm/Module.h"
 #include "llvm/Instructions.h"
 #include "llvm/DataLayout.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
 using namespace llvm;
 
 namespace SPIR {
 
+//
+// Function verifiers.
+//
+
+/// @brief The function and instruction verifiers, reporting to a single
+///        error creator. Verifiers keep state (e.g. caches), so each thread
+///        verifying functions owns a set.
+struct FunctionVerifiers {
+  /// @brief Constructor.
+  /// @param EC error creator.
+  /// @param D data holder, initialized by the module verifiers.
+  FunctionVerifiers(ErrorCreator *EC, DataHolder *D) :
+    vb(EC), vc(EC), vbc(EC, D), vit(EC, D), vfp(EC, D),
+    BBI(iel), FI(fel, &BBI) {
+    // Initialize instruction verifiers.
+    // Bitcast instruction verifier.
+    iel.push_back(&vb);
+    // Call instruction verifier.
+    iel.push_back(&vc);
+    // Built-in call verifier.
+    iel.push_back(&vbc);
+    // Instruction type verifier.
+    iel.push_back(&vit);
+
+    // Initialize function verifiers.
+    // Function prototype verifier.
+    fel.push_back(&vfp);
+  }
+
+  VerifyBitcast vb;
+  VerifyCall vc;
+  VerifyBuiltinCall vbc;
+  VerifyInstructionType vit;
+  VerifyFunctionPrototype vfp;
+
+  InstructionExecutorList iel;
+  FunctionExecutorList fel;
+  /// @brief Basic block iterator.
+  BasicBlockIterator BBI;
+  /// @brief Function iterator, running all of the above.
+  FunctionIterator FI;
+};
+
+/// @brief Verifies functions of the module, taking the next one to verify
+///        from a shared counter, and moves the errors of each function to
+///        its shard.
+static void verifyFunctions(const std::vector<const Function*> &Functions,
+                            std::vector<ErrorHolder> &Shards,
+                            std::atomic<unsigned> &Next, DataHolder *Data) {
+  ErrorHolder Errors;
+  FunctionVerifiers FV(&Errors, Data);
+  for (unsigned i = Next++; i < Functions.size(); i = Next++) {
+    FV.FI.execute(*Functions[i]);
+    Shards[i].takeErrors(Errors);
+  }
+}
+
+/// @brief Verifies the functions of a lazily loaded module one at a time,
+///        reading the body of each before verifying it and dropping it
+///        after, so only one body is in memory at a time.
+static void verifyLazyFunctions(Module &M, ErrorCreator *EC,
+                                DataHolder *Data) {
+  FunctionVerifiers FV(EC, Data);
+  for (Module::iterator fi = M.begin(), fe = M.end(); fi != fe; fi++) {
+    Function *F = &*fi;
+    bool WasMaterializable = F->isMaterializable();
+    std::string ErrMsg;
+    if (WasMaterializable && F->Materialize(&ErrMsg)) {
+      EC->addError(ERR_UNREADABLE_FUNCTION_BODY,
+                   "Function: " + F->getName().str() + "\n" + ErrMsg);
+      continue;
+    }
+    FV.FI.execute(*F);
+    // Bodies whose block addresses are taken can't be dropped.
+    if (WasMaterializable && F->isDematerializable())
+      F->Dematerialize();
+  }
+}
+
 //
 // SpirValidation class public methods.
 //
 
 char SpirValidation::ID = 0;
 
-SpirValidation::SpirValidation() : ModulePass(ID) {
+SpirValidation::SpirValidation() : ModulePass(ID), NumThreads(1) {
 }
 
 SpirValidation::~SpirValidation() {
@@ -38,24 +126,6 @@ bool SpirValidation::runOnModule(Module& M) {
   // Holder for initialized data in the module
   DataHolder Data;
 
-  // Initialize instruction verifiers.
-  InstructionExecutorList iel;
-  // Bitcast instruction verifier.
-  VerifyBitcast vb(&ErrHolder);
-  iel.push_back(&vb);
-  // Call instruction verifier.
-  VerifyCall vc(&ErrHolder);
-  iel.push_back(&vc);
-  // Instruction type verifier.
-  VerifyInstructionType vit(&ErrHolder, &Data);
-  iel.push_back(&vit);
-
-  // Initialize function verifiers.
-  FunctionExecutorList fel;
-  // Function prototype verifier.
-  VerifyFunctionPrototype vfp(&ErrHolder, &Data);
-  fel.push_back(&vfp);
-
   // Initialize module verifiers.
   ModuleExecutorList mel;
   // Module triple and target data layout verifier.
@@ -82,21 +152,86 @@ bool SpirValidation::runOnModule(Module& M) {
   VerifyMetadataCompilerOptions vmdco(&ErrHolder, &Data);
   mel.push_back(&vmdco);
 
-  // Initialize basic block iterator.
-  BasicBlockIterator BBI(iel);
-
-  // Initialize function iterator.
-  FunctionIterator FI(fel, &BBI);
+  if (M.getMaterializer()) {
+    // The bitcode reader is not thread safe, so the functions of a lazily
+    // loaded module are verified on the calling thread.
+    ModuleIterator MI(mel);
+    MI.execute(M);
+    verifyLazyFunctions(M, &ErrHolder, &Data);
+    return false;
+  }
 
-  // Initialize module iterator.
-  ModuleIterator MI(mel, &FI);
+  unsigned Threads = NumThreads;
+  if (!Threads)
+    Threads = std::max(std::thread::hardware_concurrency(), 1U);
+  Threads = std::min<size_t>(Threads, M.size());
+  // LLVM guards its lazily created globals only once it is multithreaded,
+  // which it cannot be when built without threads. It must not be started
+  // twice, e.g. by the previous module of a server.
+  if (Threads > 1 && !llvm_is_multithreaded() && !llvm_start_multithreaded())
+    Threads = 1;
+
+  if (Threads <= 1) {
+    // Initialize function verifiers.
+    FunctionVerifiers FV(&ErrHolder, &Data);
+
+    // Initialize module iterator.
+    ModuleIterator MI(mel, &FV.FI);
+
+    // Run validation.
+    MI.execute(M);
+    return false;
+  }
 
-  // Run validation.
+  // Run the module verifiers first, they initialize the data holder.
+  ModuleIterator MI(mel);
   MI.execute(M);
 
+  // Verify the functions in parallel (the verifiers only read the module),
+  // each with its own errors, and report them in module order.
+  std::vector<const Function*> Functions;
+  Functions.reserve(M.size());
+  for (Module::const_iterator fi = M.begin(), fe = M.end(); fi != fe; fi++)
+    Functions.push_back(&*fi);
+  std::vector<ErrorHolder> Shards(Functions.size());
+  std::atomic<unsigned> Next(0);
+  // The calling thread verifies functions too.
+  std::vector<std::thread> Workers;
+  for (unsigned t = 1; t < Threads; t++)
+    Workers.push_back(std::thread(verifyFunctions, std::cref(Functions),
+                                  std::ref(Shards), std::ref(Next), &Data));
+  verifyFunctions(Functions, Shards, Next, &Data);
+  for (unsigned t = 0; t < Workers.size(); t++)
+    Workers[t].join();
+  for (unsigned i = 0; i < Shards.size(); i++)
+    ErrHolder.takeErrors(Shards[i]);
+
   return false;
 }
 
+void SpirValidation::triageModule(const Module& M) {
+  DataHolder Data;
+
+  ModuleExecutorList mel;
+  // Module triple and target data layout verifier.
+  VerifyTripleAndDataLayout vtdl(&ErrHolder, &Data);
+  mel.push_back(&vtdl);
+  // Module OCL version verifier.
+  VerifyMetadataVersions voclv(
+    &ErrHolder, VerifyMetadataVersions::VERSION_OCL);
+  mel.push_back(&voclv);
+  // Module SPIR version verifier.
+  VerifyMetadataVersions vspirv(
+    &ErrHolder, VerifyMetadataVersions::VERSION_SPIR);
+  mel.push_back(&vspirv);
+
+  ModuleIterator MI(mel);
+  MI.execute(M);
+
+  // The kernels themselves are verified by VerifyMetadataKernels.
+  if (!M.getNamedMetadata(OPENCL_KERNELS))
+    ErrHolder.addError(ERR_MISSING_NAMED_METADATA, OPENCL_KERNELS);
+}
 
 } // End SPIR namespace
 
@@ -30,21 +30,44 @@ public:
   /// @brief Provides name of pass.
   virtual const char *getPassName() const;
 
-  /// @brief LLVM Module pass entry.
+  /// @brief LLVM Module pass entry. The functions of a lazily loaded module
+  ///        (see getLazyBitcodeModule) are read one at a time, and dropped
+  ///        once verified.
   /// @param M Module to transform.
   /// @returns true if changed.
   bool runOnModule(llvm::Module&);
 
+  /// @brief Checks only what tells whether a module is SPIR at all: the
+  ///        triple, the data layout, the OpenCL and SPIR versions and the
+  ///        presence of the kernels metadata. No function body is read, so
+  ///        the module may be loaded lazily (see getLazyBitcodeModule).
+  /// @param M module to check.
+  void triageModule(const llvm::Module&);
+
   /// @brief returns instance of ErrorPrinter implementation.
   /// @returns error printer instance.
   const ErrorPrinter *getErrorPrinter() const {
     return &ErrHolder;
   }
+
+  /// @brief Sets the number of threads verifying the functions of the
+  ///        module. The errors are reported in the same order whatever the
+  ///        number of threads. The functions of lazily loaded modules, and
+  ///        all functions when LLVM is built without threads, are verified
+  ///        on the calling thread.
+  /// @param N number of threads, 1 (the default) to verify the functions on
+  ///        the calling thread, 0 for one thread per core.
+  void setNumThreads(unsigned N) {
+    NumThreads = N;
+  }
   
 private:
 
   /// @brief Holder for errors found in the module
   ErrorHolder ErrHolder;
+
+  /// @brief Number of threads verifying functions.
+  unsigned NumThreads;
 };
 
 } // End SPIR namespace
@@ -0,0 +1,245 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/BuiltinDatabase.h"
+#include "spir_name_mangler/BuiltinHash.h"
+#include "spir_name_mangler/BuiltinTable.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+// Writes the built-in table to a database, as spir-builtin-gen does.
+static std::string writeTable() {
+  std::string familyNames;
+  std::vector<uint32_t> familyNameOffsets;
+  for (unsigned f = 0; f < BF_NUM_FAMILIES; ++f) {
+    familyNameOffsets.push_back(familyNames.size());
+    familyNames += getBuiltinFamilyName((BuiltinFamily)f).str();
+    familyNames += '\0';
+  }
+  familyNameOffsets.push_back(familyNames.size());
+
+  std::vector<uint32_t> families, attributes, numParameters;
+  std::vector<uint32_t> returnTypes[2], firstParameters[2], parameters[2];
+  std::vector<uint32_t> nameOffsets[2];
+  std::string names[2];
+  std::vector<llvm::StringRef> hashNames;
+  std::vector<uint32_t> hashSlots;
+  for (unsigned i = 0; i < BI_NUM_BUILTINS; ++i) {
+    BuiltinID id = (BuiltinID)i;
+    families.push_back(getBuiltinFamily(id));
+    attributes.push_back(getBuiltinAttributes(id));
+    numParameters.push_back(getBuiltinNumParameters(id));
+    for (unsigned w = 0; w < 2; ++w) {
+      returnTypes[w].push_back(getBuiltinReturnType(id, w).getBits());
+      firstParameters[w].push_back(parameters[w].size());
+      for (unsigned p = 0; p < getBuiltinNumParameters(id); ++p)
+        parameters[w].push_back(getBuiltinParameter(id, p, w).getBits());
+      nameOffsets[w].push_back(names[w].size());
+      names[w] += getBuiltinMangledName(id, w).str();
+      names[w] += '\0';
+    }
+    llvm::StringRef name32 = getBuiltinMangledName(id, false);
+    llvm::StringRef name64 = getBuiltinMangledName(id, true);
+    hashNames.push_back(name32);
+    if (name32 == name64) {
+      hashSlots.push_back(i | BUILTIN_SLOT_SPIR32 | BUILTIN_SLOT_SPIR64);
+    } else {
+      hashSlots.push_back(i | BUILTIN_SLOT_SPIR32);
+      hashNames.push_back(name64);
+      hashSlots.push_back(i | BUILTIN_SLOT_SPIR64);
+    }
+  }
+  BuiltinHashTable hash;
+  EXPECT_TRUE(buildBuiltinHash(hashNames, hashSlots, hash));
+
+  BuiltinDatabaseTables tables;
+  tables.familyNames = familyNames;
+  tables.familyNameOffsets = familyNameOffsets;
+  tables.families = families;
+  tables.attributes = attributes;
+  tables.numParameters = numParameters;
+  for (unsigned w = 0; w < 2; ++w) {
+    nameOffsets[w].push_back(names[w].size());
+    tables.signatures[w].returnTypes = returnTypes[w];
+    tables.signatures[w].firstParameters = firstParameters[w];
+    tables.signatures[w].parameters = parameters[w];
+    tables.signatures[w].mangledNames = names[w];
+    tables.signatures[w].mangledNameOffsets = nameOffsets[w];
+  }
+  tables.hashSeed = hash.seed;
+  tables.hashDisplacements = hash.displacements;
+  tables.hashSlots = hash.slots;
+
+  std::string file;
+  llvm::raw_string_ostream o(file);
+  writeBuiltinDatabase(tables, o);
+  return o.str();
+}
+
+static BuiltinDatabase* load(llvm::StringRef file, std::string& error) {
+  return BuiltinDatabase::get(llvm::MemoryBuffer::getMemBufferCopy(file),
+                              error);
+}
+
+// Overwrites an entry of a table of a database.
+static void setTableEntry(std::string& file, unsigned section, unsigned i,
+                          uint32_t value) {
+  const BuiltinDatabaseHeader* header =
+    (const BuiltinDatabaseHeader*)file.data();
+  memcpy(&file[header->sections[section].offset + i * 4], &value,
+         sizeof(value));
+}
+
+//
+// Tests
+//
+
+TEST(BuiltinDatabaseTest, roundTrip) {
+  std::string error;
+  llvm::OwningPtr<BuiltinDatabase> db(load(writeTable(), error));
+  ASSERT_TRUE(db.get() != NULL) << error;
+  ASSERT_EQ((unsigned)BI_NUM_BUILTINS, db->getNumBuiltins());
+  ASSERT_EQ((unsigned)BF_NUM_FAMILIES, db->getNumFamilies());
+  ASSERT_EQ("cos", db->getFamilyName(BF_cos).str());
+
+  for (unsigned i = 0; i < BI_NUM_BUILTINS; ++i) {
+    BuiltinID id = (BuiltinID)i;
+    ASSERT_EQ(getBuiltinName(id), db->getName(i));
+    ASSERT_EQ(getBuiltinAttributes(id), db->getAttributes(i));
+    for (unsigned is64Bit = 0; is64Bit < 2; ++is64Bit) {
+      llvm::StringRef mangled = db->getMangledName(i, is64Bit);
+      ASSERT_EQ(getBuiltinMangledName(id, is64Bit), mangled);
+      ASSERT_EQ(i, db->lookup(mangled, is64Bit));
+      ASSERT_TRUE(getBuiltinReturnType(id, is64Bit) ==
+        db->getReturnType(i, is64Bit));
+      ASSERT_EQ(mangled.str(), mangle(db->getDescriptor(i, is64Bit)));
+    }
+  }
+
+  ASSERT_EQ((unsigned)BI_6vload4jPKU3AS1f,
+    db->lookup("_Z6vload4mPKU3AS1f", true));
+  ASSERT_EQ(BuiltinDatabase::NOT_FOUND,
+    db->lookup("_Z6vload4mPKU3AS1f", false));
+  ASSERT_EQ(BuiltinDatabase::NOT_FOUND, db->lookup("_Z3cos", false));
+  ASSERT_EQ(BuiltinDatabase::NOT_FOUND, db->lookup("", true));
+}
+
+TEST(BuiltinDatabaseTest, malformed) {
+  std::string file = writeTable();
+  std::string error;
+  llvm::OwningPtr<BuiltinDatabase> db(load(file, error));
+  ASSERT_TRUE(db.get() != NULL) << error;
+
+  // Truncated.
+  db.reset(load(llvm::StringRef(file).drop_back(8), error));
+  ASSERT_TRUE(db.get() == NULL);
+  ASSERT_EQ("truncated built-in database", error);
+  db.reset(load(llvm::StringRef(file).substr(0, 16), error));
+  ASSERT_TRUE(db.get() == NULL);
+
+  // Not a database.
+  std::string other = file;
+  other[0] = 'X';
+  db.reset(load(other, error));
+  ASSERT_TRUE(db.get() == NULL);
+  ASSERT_EQ("not a built-in database", error);
+
+  // Another version.
+  other = file;
+  BuiltinDatabaseHeader* header = (BuiltinDatabaseHeader*)&other[0];
+  ++header->version;
+  db.reset(load(other, error));
+  ASSERT_TRUE(db.get() == NULL);
+
+  // A section out of the file.
+  other = file;
+  header = (BuiltinDatabaseHeader*)&other[0];
+  header->sections[BDB_PARAMETERS_64].size = header->fileSize;
+  db.reset(load(other, error));
+  ASSERT_TRUE(db.get() == NULL);
+  ASSERT_EQ("malformed section", error);
+
+  // A count whose table size would wrap in 32 bits, with an empty table of
+  // family name offsets.
+  other = file;
+  header = (BuiltinDatabaseHeader*)&other[0];
+  header->numFamilies = 0xFFFFFFFF;
+  header->sections[BDB_FAMILY_NAME_OFFSETS].size = 0;
+  db.reset(load(other, error));
+  ASSERT_TRUE(db.get() == NULL);
+  ASSERT_EQ("malformed section", error);
+
+  // More built-ins than the hash slots can hold ids for, including counts
+  // whose table sizes would wrap in 32 bits.
+  const uint32_t tooManyBuiltins[] = {
+    BUILTIN_SLOT_ID_MASK + 2, 0x40000000, 0xFFFFFFFF
+  };
+  for (unsigned i = 0; i < 3; ++i) {
+    other = file;
+    header = (BuiltinDatabaseHeader*)&other[0];
+    header->numBuiltins = tooManyBuiltins[i];
+    header->hashNumSlots = tooManyBuiltins[i];
+    db.reset(load(other, error));
+    ASSERT_TRUE(db.get() == NULL);
+    ASSERT_EQ("malformed built-in database hash", error);
+  }
+
+  // A family out of range.
+  other = file;
+  setTableEntry(other, BDB_FAMILIES, 0, BF_NUM_FAMILIES);
+  db.reset(load(other, error));
+  ASSERT_TRUE(db.get() == NULL);
+  ASSERT_EQ("malformed built-in table", error);
+
+  // Type words which are not packed types: invalid, an unknown primitive,
+  // a vector length OpenCL does not have, and stray bits.
+  const uint32_t badTypes[] = {
+    0xFFFFFFFF, PRIMITIVE_NUM, PRIMITIVE_FLOAT | (5 << 5), 1U << 20
+  };
+  for (unsigned i = 0; i < sizeof(badTypes) / sizeof(badTypes[0]); ++i) {
+    other = file;
+    setTableEntry(other, BDB_RETURN_TYPES_32, 0, badTypes[i]);
+    db.reset(load(other, error));
+    ASSERT_TRUE(db.get() == NULL);
+    ASSERT_EQ("malformed built-in table", error);
+    other = file;
+    setTableEntry(other, BDB_PARAMETERS_64, 0, badTypes[i]);
+    db.reset(load(other, error));
+    ASSERT_TRUE(db.get() == NULL);
+    ASSERT_EQ("malformed built-in table", error);
+  }
+
+  // Parameter lists past the end of the parameters, the first one only if
+  // the sum is done in 64 bits.
+  other = file;
+  setTableEntry(other, BDB_FIRST_PARAMETERS_64, 0, 0xFFFFFFFF);
+  db.reset(load(other, error));
+  ASSERT_TRUE(db.get() == NULL);
+  ASSERT_EQ("malformed built-in table", error);
+  other = file;
+  header = (BuiltinDatabaseHeader*)&other[0];
+  unsigned last = BI_NUM_BUILTINS - 1;
+  setTableEntry(other, BDB_FIRST_PARAMETERS_32, last,
+                header->sections[BDB_PARAMETERS_32].size / 4 -
+                getBuiltinNumParameters((BuiltinID)last) + 1);
+  db.reset(load(other, error));
+  ASSERT_TRUE(db.get() == NULL);
+  ASSERT_EQ("malformed built-in table", error);
+}
+
+}// End namespace test
+}// End namespace namemangling
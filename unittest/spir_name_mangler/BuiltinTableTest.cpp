@@ -0,0 +1,113 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/BuiltinTable.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "gtest/gtest.h"
+#include <set>
+#include <string>
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+//
+// Tests
+//
+
+TEST(BuiltinTableTest, lookup) {
+  ASSERT_EQ("cos", getBuiltinName(BI_3cosf).str());
+  ASSERT_EQ("_Z3cosf", getBuiltinMangledName(BI_3cosf, false).str());
+  ASSERT_EQ("_Z3cosf", getBuiltinMangledName(BI_3cosf, true).str());
+  ASSERT_EQ((unsigned)BUILTIN_CONST, getBuiltinAttributes(BI_3cosf));
+  ASSERT_EQ(1U, getBuiltinNumParameters(BI_3cosf));
+  ASSERT_TRUE(getBuiltinReturnType(BI_3cosf, false) ==
+    PackedType::getPrimitive(PRIMITIVE_FLOAT));
+
+  // size_t is as wide as the pointers.
+  BuiltinID vload4 = BI_6vload4jPKU3AS1f;
+  ASSERT_EQ("vload4", getBuiltinName(vload4).str());
+  ASSERT_EQ("_Z6vload4jPKU3AS1f", getBuiltinMangledName(vload4, false).str());
+  ASSERT_EQ("_Z6vload4mPKU3AS1f", getBuiltinMangledName(vload4, true).str());
+  ASSERT_EQ(0U, getBuiltinAttributes(vload4));
+  ASSERT_EQ(2U, getBuiltinNumParameters(vload4));
+  ASSERT_TRUE(getBuiltinParameter(vload4, 0, false) ==
+    PackedType::getPrimitive(PRIMITIVE_UINT));
+  ASSERT_TRUE(getBuiltinParameter(vload4, 0, true) ==
+    PackedType::getPrimitive(PRIMITIVE_ULONG));
+  ASSERT_TRUE(getBuiltinParameter(vload4, 1, true) ==
+    PackedType::getPrimitive(PRIMITIVE_FLOAT).getPointer(ATTR_GLOBAL,
+      1U << (ATTR_CONST - ATTR_QUALIFIER_FIRST)));
+
+  // An empty parameter list is mangled as 'void'.
+  ASSERT_EQ(1U, getBuiltinNumParameters(BI_12get_work_dimv));
+  ASSERT_TRUE(getBuiltinParameter(BI_12get_work_dimv, 0, false) ==
+    PackedType::getPrimitive(PRIMITIVE_VOID));
+}
+
+TEST(BuiltinTableTest, descriptors) {
+  // The descriptors rebuild the mangled names, which are all distinct.
+  ASSERT_GT((unsigned)BI_NUM_BUILTINS, 10000U);
+  std::set<std::string> names32, names64;
+  for (unsigned i = 0; i < BI_NUM_BUILTINS; ++i) {
+    BuiltinID id = (BuiltinID)i;
+    for (unsigned is64Bit = 0; is64Bit < 2; ++is64Bit) {
+      llvm::StringRef mangled = getBuiltinMangledName(id, is64Bit);
+      FunctionDescriptor fd = getBuiltinDescriptor(id, is64Bit);
+      ASSERT_EQ(mangled.str(), mangle(fd));
+      ASSERT_EQ(getBuiltinName(id).str(), fd.name);
+      ASSERT_TRUE(getBuiltinReturnType(id, is64Bit).isValid());
+      std::set<std::string>& names = is64Bit ? names64 : names32;
+      ASSERT_TRUE(names.insert(mangled.str()).second) << mangled.str();
+    }
+  }
+}
+
+TEST(BuiltinTableTest, families) {
+  ASSERT_EQ(BF_cos, getBuiltinFamily(BI_3cosf));
+  ASSERT_EQ(BF_cos, getBuiltinFamily(BI_3cosDv4_f));
+  ASSERT_EQ(BF_vload4, getBuiltinFamily(BI_6vload4jPKU3AS1f));
+  ASSERT_EQ("cos", getBuiltinFamilyName(BF_cos).str());
+  for (unsigned i = 0; i < BI_NUM_BUILTINS; ++i) {
+    BuiltinID id = (BuiltinID)i;
+    ASSERT_EQ(getBuiltinName(id), getBuiltinFamilyName(getBuiltinFamily(id)));
+  }
+}
+
+TEST(BuiltinTableTest, lookupBuiltin) {
+  // Every mangled name finds its built-in.
+  for (unsigned i = 0; i < BI_NUM_BUILTINS; ++i) {
+    BuiltinID id = (BuiltinID)i;
+    for (unsigned is64Bit = 0; is64Bit < 2; ++is64Bit) {
+      BuiltinRecord record =
+        lookupBuiltin(getBuiltinMangledName(id, is64Bit), is64Bit);
+      ASSERT_TRUE(record.isValid());
+      ASSERT_EQ(id, record.id);
+      ASSERT_EQ(getBuiltinFamily(id), record.family);
+      ASSERT_EQ(getBuiltinAttributes(id), record.attributes);
+      ASSERT_EQ(getBuiltinNumParameters(id), record.numParameters);
+    }
+  }
+
+  BuiltinRecord record = lookupBuiltin("_Z6vload4mPKU3AS1f", true);
+  ASSERT_EQ(BI_6vload4jPKU3AS1f, record.id);
+  ASSERT_EQ(BF_vload4, record.family);
+  ASSERT_TRUE(record.getParameter(0) ==
+    PackedType::getPrimitive(PRIMITIVE_ULONG));
+
+  // Names of the other pointer size, and other strings, are not found.
+  ASSERT_FALSE(lookupBuiltin("_Z6vload4mPKU3AS1f", false).isValid());
+  ASSERT_FALSE(lookupBuiltin("_Z6vload4jPKU3AS1f", true).isValid());
+  ASSERT_FALSE(lookupBuiltin("", false).isValid());
+  ASSERT_FALSE(lookupBuiltin("_Z3cos", false).isValid());
+  ASSERT_FALSE(lookupBuiltin("_Z3cosfx", false).isValid());
+  ASSERT_FALSE(lookupBuiltin("_Z3cosi", false).isValid());
+  ASSERT_FALSE(lookupBuiltin("cos", true).isValid());
+}
+
+}// End namespace test
+}// End namespace namemangling
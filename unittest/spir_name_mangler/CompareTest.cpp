@@ -0,0 +1,117 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/FunctionDescriptor.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/ParameterType.h"
+#include "llvm/ADT/DenseMap.h"
+#include "gtest/gtest.h"
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+static const char* Names[] = {
+  "_Z4funci",
+  "_Z4funcj",
+  "_Z4funcf",
+  "_Z4funcff",
+  "_Z4funcDv2_f",
+  "_Z4funcDv4_f",
+  "_Z4funcDv4_i",
+  "_Z4funcPf",
+  "_Z4funcPKf",
+  "_Z4funcPVf",
+  "_Z4funcPU3AS1f",
+  "_Z4funcPU3AS3Dv4_f",
+  "_Z4func4myTy",
+  "_Z4func5myTy2",
+  "_Z4func11ocl_image2d",
+  "_Z5frexpDv2_fPU3AS1Dv2_i",
+  "_Z5frexpDv2_fPU3AS3Dv2_i",
+};
+
+static const unsigned NumNames = sizeof(Names) / sizeof(Names[0]);
+
+//
+// Tests
+//
+
+TEST(CompareTest, consistentWithEquals) {
+  for (unsigned i = 0; i < NumNames; ++i) {
+    FunctionDescriptor l = demangle(Names[i]);
+    for (unsigned j = 0; j < NumNames; ++j) {
+      FunctionDescriptor r = demangle(Names[j]);
+      int cmp = l.compare(r);
+      ASSERT_EQ(i == j, cmp == 0) << Names[i] << " " << Names[j];
+      ASSERT_EQ(i == j, l == r) << Names[i] << " " << Names[j];
+      ASSERT_EQ(cmp < 0, r.compare(l) > 0) << Names[i] << " " << Names[j];
+      ASSERT_EQ(cmp < 0, l < r) << Names[i] << " " << Names[j];
+      if (i == j) {
+        ASSERT_EQ(hash_value(l), hash_value(r));
+        ASSERT_EQ(l.parameters[0]->getHash(), r.parameters[0]->getHash());
+      }
+    }
+  }
+}
+
+TEST(CompareTest, transitive) {
+  std::vector<FunctionDescriptor> fds;
+  for (unsigned i = 0; i < NumNames; ++i)
+    fds.push_back(demangle(Names[i]));
+  for (unsigned i = 0; i < NumNames; ++i)
+    for (unsigned j = 0; j < NumNames; ++j)
+      for (unsigned k = 0; k < NumNames; ++k)
+        if (fds[i] < fds[j] && fds[j] < fds[k]) {
+          ASSERT_TRUE(fds[i] < fds[k]);
+        }
+}
+
+TEST(CompareTest, hashContainers) {
+  llvm::DenseMap<FunctionDescriptor, unsigned> denseMap;
+  std::unordered_map<FunctionDescriptor, unsigned> stdMap;
+  llvm::DenseMap<RefParamType, unsigned> typeMap;
+  std::unordered_set<RefParamType, std::hash<RefParamType>, ParamTypeEqual>
+    typeSet;
+  for (unsigned i = 0; i < NumNames; ++i) {
+    FunctionDescriptor fd = demangle(Names[i]);
+    denseMap[fd] = i;
+    stdMap[fd] = i;
+    typeMap.insert(std::make_pair(fd.parameters[0], i));
+    typeSet.insert(fd.parameters[0]);
+  }
+  ASSERT_EQ(NumNames, denseMap.size());
+  ASSERT_EQ(NumNames, stdMap.size());
+  // "func(float, float)" and both "frexp(float2, ...)" repeat a first
+  // parameter.
+  ASSERT_EQ(NumNames - 3, typeMap.size());
+  ASSERT_EQ(NumNames - 3, typeSet.size());
+
+  // Lookups with separately built, structurally equal keys.
+  for (unsigned i = 0; i < NumNames; ++i) {
+    FunctionDescriptor fd = demangle(Names[i]);
+    ASSERT_EQ(i, denseMap.lookup(fd));
+    ASSERT_EQ(i, stdMap[fd]);
+    ASSERT_TRUE(typeMap.count(fd.parameters[0]));
+    ASSERT_TRUE(typeSet.count(fd.parameters[0]));
+  }
+  denseMap.erase(demangle(Names[0]));
+  ASSERT_EQ(0U, denseMap.count(demangle(Names[0])));
+  ASSERT_EQ(1U, denseMap.count(demangle(Names[1])));
+
+  // Any name is a valid key, even one which looks like a special key.
+  denseMap[FunctionDescriptor("<empty>")] = 1;
+  denseMap[FunctionDescriptor("<tombstone>")] = 2;
+  ASSERT_EQ(1U, denseMap.lookup(FunctionDescriptor("<empty>")));
+  ASSERT_EQ(2U, denseMap.lookup(FunctionDescriptor("<tombstone>")));
+  ASSERT_EQ(NumNames + 1, denseMap.size());
+}
+
+}// End namespace test
+}// End namespace namemangling
@@ -0,0 +1,169 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/FunctionDescriptor.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/ParameterType.h"
+#include "spir_name_mangler/BuiltinParser.h"
+#include "gtest/gtest.h"
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+// Demangles the given string and checks that mangling the result gives
+// back the very same string.
+static void roundTrip(const char* s) {
+  FunctionDescriptor fd = demangle(s);
+  ASSERT_FALSE(fd.isNull()) << s;
+  ASSERT_STREQ(s, mangle(fd).c_str());
+}
+
+//
+// Tests
+//
+
+TEST(DemangleBasic, scalars) {
+  roundTrip("_Z4funci");
+  roundTrip("_Z4funcf");
+  roundTrip("_Z4funcd");
+  roundTrip("_Z4funcDh");
+  roundTrip("_Z12get_work_dimv");
+}
+
+TEST(DemangleBasic, descriptor) {
+  // "frexp(float2, __global int2*)"
+  FunctionDescriptor fd = demangle("_Z5frexpDv2_fPU3AS1Dv2_i");
+  ASSERT_EQ("frexp", fd.name);
+  ASSERT_EQ(2U, fd.parameters.size());
+
+  const VectorType* v = dyn_cast<VectorType>(&*fd.parameters[0]);
+  ASSERT_TRUE(v != NULL);
+  ASSERT_EQ(2, v->getLength());
+  const PrimitiveType* f = dyn_cast<PrimitiveType>(&*v->getScalarType());
+  ASSERT_TRUE(f != NULL);
+  ASSERT_EQ(PRIMITIVE_FLOAT, f->getPrimitive());
+
+  const PointerType* p = dyn_cast<PointerType>(&*fd.parameters[1]);
+  ASSERT_TRUE(p != NULL);
+  ASSERT_EQ(ATTR_GLOBAL, p->getAddressSpace());
+  ASSERT_FALSE(p->hasQualifier(ATTR_CONST));
+  ASSERT_TRUE(dyn_cast<VectorType>(&*p->getPointee()) != NULL);
+}
+
+TEST(DemangleTest, mangleTestCases) {
+  roundTrip("_Z4FuncfPfPf");
+  roundTrip("_Z11read_imagef11ocl_image2d11ocl_samplerDv2_f");
+  roundTrip("_Z6myfunc5myTy15myTy2");
+  roundTrip("_Z9mask_fmaxtDv16_fDv16_f");
+  roundTrip(
+    "_Z10soa_cross3Dv16_fDv16_fDv16_fDv16_fDv16_fDv16_fPDv16_fPDv16_fPDv16_f");
+  roundTrip("_Z21async_work_group_copyPU3AS3Dv2_cPKU3AS1Dv2_cPDv2_cPU3AS2Dv2_c");
+  roundTrip("_Z3myfPU3AS23mta");
+  roundTrip("_Z4funcPrVKU3AS2i");
+  roundTrip("_Z4funcPrKi");
+}
+
+TEST(DemangleTest, oclTypes) {
+  FunctionDescriptor fd = demangle("_Z11read_imagef11ocl_image2d11ocl_samplerDv2_f");
+  ASSERT_EQ(3U, fd.parameters.size());
+  const PrimitiveType* image = dyn_cast<PrimitiveType>(&*fd.parameters[0]);
+  ASSERT_TRUE(image != NULL);
+  ASSERT_EQ(PRIMITIVE_IMAGE_2D_T, image->getPrimitive());
+  const PrimitiveType* sampler = dyn_cast<PrimitiveType>(&*fd.parameters[1]);
+  ASSERT_TRUE(sampler != NULL);
+  ASSERT_EQ(PRIMITIVE_SAMPLER_T, sampler->getPrimitive());
+}
+
+TEST(DemangleTest, view) {
+  // "async_work_group_copy(__local char2 *, __global const char2 *)"
+  const char* s = "_Z21async_work_group_copyPU3AS3Dv2_cPKU3AS1Dv2_c";
+  DemangledName dn;
+  ASSERT_TRUE(demangle(s, dn));
+  ASSERT_EQ("async_work_group_copy", dn.name.str());
+  ASSERT_EQ(2U, dn.numParameters);
+  // The view borrows the name from the mangled string.
+  ASSERT_EQ(s + 4, dn.name.data());
+
+  const DemangledType& p = dn.getParameter(1);
+  ASSERT_EQ(TYPE_ID_POINTER, p.typeId);
+  ASSERT_EQ(ATTR_GLOBAL, p.addressSpace);
+  ASSERT_TRUE(p.hasQualifier(ATTR_CONST));
+  const DemangledType& v = dn.getElement(p);
+  ASSERT_EQ(TYPE_ID_VECTOR, v.typeId);
+  ASSERT_EQ(2U, v.length);
+  ASSERT_EQ(PRIMITIVE_CHAR, dn.getElement(v).primitive);
+}
+
+TEST(DemangleTest, malformed) {
+  ASSERT_TRUE(demangle("").isNull());
+  ASSERT_TRUE(demangle("func").isNull());
+  ASSERT_TRUE(demangle("_Z").isNull());
+  ASSERT_TRUE(demangle("_Z5func").isNull());
+  ASSERT_TRUE(demangle("_Z04funci").isNull());
+  ASSERT_TRUE(demangle("_Z4funcDv").isNull());
+  ASSERT_TRUE(demangle("_Z4funcDv4f").isNull());
+  ASSERT_TRUE(demangle("_Z4funcP").isNull());
+  ASSERT_TRUE(demangle("_Z4funcQ").isNull());
+  ASSERT_TRUE(demangle("_Z4func12ocl_image").isNull());
+  // Bytes past ASCII, as names from bitcode may hold.
+  ASSERT_TRUE(demangle("_Z" "\xb9" "4funci").isNull());
+  ASSERT_TRUE(demangle("_Z4funci\xe9").isNull());
+  ASSERT_TRUE(demangle("_Z4funcDv\xb4_f").isNull());
+}
+
+TEST(BuiltinParserTest, declarations) {
+  BuiltinDeclaration decl;
+  ASSERT_TRUE(parseBuiltinDeclaration(
+    "float4 __attribute__((overloadable)) vload4(size_t offset, "
+    "const __global float *p);", false, decl));
+  ASSERT_STREQ("_Z6vload4jPKU3AS1f", mangle(decl.descriptor).c_str());
+  ASSERT_TRUE(parseBuiltinDeclaration(
+    "float4 __attribute__((overloadable)) vload4(size_t offset, "
+    "const __global float *p);", true, decl));
+  ASSERT_STREQ("_Z6vload4mPKU3AS1f", mangle(decl.descriptor).c_str());
+  ASSERT_FALSE(decl.isConst);
+
+  ASSERT_TRUE(parseBuiltinDeclaration(
+    "uint const_func __attribute__((overloadable)) get_work_dim(void);",
+    false, decl));
+  ASSERT_STREQ("_Z12get_work_dimv", mangle(decl.descriptor).c_str());
+  ASSERT_TRUE(decl.isConst);
+
+  ASSERT_TRUE(parseBuiltinDeclaration(
+    "float4 __attribute__((overloadable)) const_func read_imagef("
+    "__read_only image2d_t image, sampler_t sampler, int2 coord);",
+    false, decl));
+  ASSERT_STREQ("_Z11read_imagef11ocl_image2d11ocl_samplerDv2_i",
+    mangle(decl.descriptor).c_str());
+
+  ASSERT_TRUE(parseBuiltinDeclaration(
+    "unsigned int __attribute__((overloadable)) atom_xor("
+    "volatile __local unsigned int *p, unsigned int val);", false, decl));
+  ASSERT_STREQ("_Z8atom_xorPVU3AS3jj", mangle(decl.descriptor).c_str());
+
+  ASSERT_FALSE(parseBuiltinDeclaration(
+    "float4 __attribute__((overloadable)) f(unknown_t x);", false, decl));
+}
+
+TEST(BuiltinParserTest, types) {
+  RefParamType type = parseBuiltinType("const __global float4*", false);
+  ASSERT_FALSE(type.isNull());
+  ASSERT_EQ("const __global float4 *", type->toString());
+  type = parseBuiltinType("uint", false);
+  ASSERT_FALSE(type.isNull());
+  ASSERT_EQ("uint", type->toString());
+  type = parseBuiltinType("size_t", true);
+  ASSERT_FALSE(type.isNull());
+  ASSERT_EQ("ulong", type->toString());
+  ASSERT_TRUE(parseBuiltinType("", false).isNull());
+  ASSERT_TRUE(parseBuiltinType("unknown_t", false).isNull());
+  ASSERT_TRUE(parseBuiltinType("\xa0uint \xe9*", false).isNull());
+}
+
+}// End namespace test
+}// End namespace namemangling
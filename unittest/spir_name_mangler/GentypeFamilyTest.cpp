@@ -0,0 +1,126 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/BuiltinTable.h"
+#include "spir_name_mangler/GentypeFamily.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "llvm/ADT/SmallString.h"
+#include "gtest/gtest.h"
+#include <set>
+#include <string>
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+// The declarations of the built-in table.
+static BuiltinDeclarationList getDeclarations(bool is64Bit) {
+  BuiltinDeclarationList decls(BI_NUM_BUILTINS);
+  for (unsigned i = 0; i < BI_NUM_BUILTINS; ++i) {
+    BuiltinID id = (BuiltinID)i;
+    decls[i].descriptor = getBuiltinDescriptor(id, is64Bit);
+    decls[i].returnType = getBuiltinReturnType(id, is64Bit).toParamType();
+    decls[i].isConst = getBuiltinAttributes(id) & BUILTIN_CONST;
+    decls[i].isReadOnly = getBuiltinAttributes(id) & BUILTIN_READ_ONLY;
+  }
+  return decls;
+}
+
+//
+// Tests
+//
+
+TEST(GentypeFamilyTest, cos) {
+  BuiltinDeclarationList decls = getDeclarations(false);
+  BuiltinDeclarationList cos;
+  for (unsigned i = 0; i < decls.size(); ++i) {
+    if (decls[i].descriptor.name == "cos")
+      cos.push_back(decls[i]);
+  }
+  GentypeFamilySet set;
+  ASSERT_EQ(0U, set.build(cos));
+  ASSERT_EQ(1U, set.size());
+  ASSERT_EQ(12U, set.getNumOverloads());
+
+  GentypeFamily f = set[0];
+  ASSERT_EQ("cos", f.getName().str());
+  ASSERT_EQ(12U, f.size());
+  ASSERT_EQ(1U, f.getNumParameters());
+  ASSERT_EQ((unsigned)BUILTIN_CONST, f.getAttributes());
+  ASSERT_EQ(PRIMITIVE_FLOAT, f.getElement(0));
+  ASSERT_EQ(0U, f.getLength(0));
+  ASSERT_EQ(PRIMITIVE_DOUBLE, f.getElement(11));
+  ASSERT_EQ(16U, f.getLength(11));
+  ASSERT_TRUE(PackedType::getVector(PRIMITIVE_FLOAT, 4) == f.getReturnType(3));
+
+  llvm::SmallString<32> name;
+  f.mangle(3, name);
+  ASSERT_EQ("_Z3cosDv4_f", name.str().str());
+  ASSERT_EQ("_Z3cosDv4_f", mangle(f.getDescriptor(3)));
+}
+
+TEST(GentypeFamilyTest, mixedTypes) {
+  // vload4 takes a scalar offset and a pointer to the element type of its
+  // vector result.
+  BuiltinDeclarationList decls = getDeclarations(true);
+  BuiltinDeclarationList vload4;
+  for (unsigned i = 0; i < decls.size(); ++i) {
+    if (decls[i].descriptor.name == "vload4")
+      vload4.push_back(decls[i]);
+  }
+  GentypeFamilySet set;
+  ASSERT_EQ(0U, set.build(vload4));
+  ASSERT_EQ(vload4.size(), set.getNumOverloads());
+  ASSERT_LT(set.size(), vload4.size() / 4);
+  for (unsigned f = 0; f < set.size(); ++f) {
+    llvm::ArrayRef<TemplateType> signature = set[f].getSignature();
+    ASSERT_EQ(3U, signature.size());
+    ASSERT_EQ((unsigned)TemplateType::ELEMENT, signature[2].flags);
+    ASSERT_EQ(0U, signature[1].flags);
+    for (unsigned i = 0; i < set[f].size(); ++i) {
+      ASSERT_EQ(4U, set[f].getReturnType(i).getLength());
+      ASSERT_TRUE(PackedType::getPrimitive(PRIMITIVE_ULONG) ==
+        set[f].getParameter(i, 0));
+    }
+  }
+
+  // Repeated declarations are kept once.
+  vload4.push_back(vload4.front());
+  ASSERT_EQ(0U, set.build(vload4));
+  ASSERT_EQ(vload4.size() - 1, set.getNumOverloads());
+}
+
+TEST(GentypeFamilyTest, allBuiltins) {
+  for (unsigned is64Bit = 0; is64Bit < 2; ++is64Bit) {
+    GentypeFamilySet set;
+    ASSERT_EQ(0U, set.build(getDeclarations(is64Bit)));
+    ASSERT_EQ((size_t)BI_NUM_BUILTINS, set.getNumOverloads());
+    ASSERT_LT(set.size(), (unsigned)BI_NUM_BUILTINS / 4);
+
+    // Every overload is a built-in, with its signature and attributes.
+    std::set<BuiltinID> found;
+    for (unsigned f = 0; f < set.size(); ++f) {
+      GentypeFamily family = set[f];
+      for (unsigned i = 0; i < family.size(); ++i) {
+        llvm::SmallString<64> name;
+        family.mangle(i, name);
+        BuiltinRecord record = lookupBuiltin(name, is64Bit);
+        ASSERT_TRUE(record.isValid()) << name.str().str();
+        ASSERT_TRUE(found.insert(record.id).second) << name.str().str();
+        ASSERT_EQ(family.getName(), getBuiltinName(record.id));
+        ASSERT_EQ(record.attributes, family.getAttributes());
+        ASSERT_TRUE(getBuiltinReturnType(record.id, is64Bit) ==
+          family.getReturnType(i));
+        ASSERT_EQ(name.str().str(), mangle(family.getDescriptor(i)));
+      }
+    }
+    ASSERT_EQ((size_t)BI_NUM_BUILTINS, found.size());
+  }
+}
+
+}// End namespace test
+}// End namespace namemangling
@@ -0,0 +1,74 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/FunctionDescriptor.h"
+#include "spir_name_mangler/MangleBatch.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+// Overloads of a few functions, with a null descriptor in between.
+static std::vector<FunctionDescriptor> getOverloads() {
+  const char* names[] = {
+    "_Z5frexpDv2_fPU3AS1Dv2_i",
+    "_Z5frexpDv4_fPU3AS1Dv4_i",
+    "_Z5frexpfPi",
+    "_Z6vload4jPKU3AS2f",
+    "_Z21async_work_group_copyPU3AS3Dv2_cPKU3AS1Dv2_cj9ocl_event",
+    "_Z6vload4jPKU3AS1f"
+  };
+  std::vector<FunctionDescriptor> fds;
+  for (unsigned i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+    fds.push_back(demangle(names[i]));
+  fds.insert(fds.begin() + 3, FunctionDescriptor::null());
+  // Long enough to be split between threads.
+  std::vector<FunctionDescriptor> all;
+  for (unsigned i = 0; i < 500; ++i)
+    all.insert(all.end(), fds.begin(), fds.end());
+  return all;
+}
+
+//
+// Tests
+//
+
+TEST(MangleBatchTest, matchesMangle) {
+  std::vector<FunctionDescriptor> fds = getOverloads();
+  unsigned threads[] = { 1, 4, 0 };
+  for (unsigned t = 0; t < 3; ++t) {
+    MangledNameTable table;
+    mangleBatch(fds, table, threads[t]);
+    ASSERT_EQ(fds.size(), table.size());
+    for (size_t i = 0; i < fds.size(); ++i)
+      ASSERT_EQ(mangle(fds[i]), table[i].str());
+    ASSERT_EQ(table.getPool().size(), table.getOffset(table.size()));
+  }
+}
+
+TEST(MangleBatchTest, contiguous) {
+  std::vector<FunctionDescriptor> fds = getOverloads();
+  fds.resize(7);
+  MangledNameTable table;
+  mangleBatch(fds, table);
+  std::string pool;
+  for (size_t i = 0; i < fds.size(); ++i) {
+    ASSERT_EQ(pool.size(), table.getOffset(i));
+    pool += mangle(fds[i]);
+  }
+  ASSERT_EQ(pool, table.getPool().str());
+
+  mangleBatch(std::vector<FunctionDescriptor>(), table);
+  ASSERT_EQ(0U, table.size());
+  ASSERT_TRUE(table.getPool().empty());
+}
+
+}// End namespace test
+}// End namespace namemangling
@@ -0,0 +1,104 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/FunctionDescriptor.h"
+#include "spir_name_mangler/MangleCache.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/ParameterType.h"
+#include "spir_name_mangler/TypeArena.h"
+#include "gtest/gtest.h"
+#include <string.h>
+#include <thread>
+#include <vector>
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+//
+// Tests
+//
+
+TEST(MangleCacheTest, hitsAndMisses) {
+  MangleCache cache;
+  FunctionDescriptor fd = demangle("_Z6vload4jPKU3AS1f");
+  llvm::StringRef name = cache.get(fd);
+  ASSERT_EQ("_Z6vload4jPKU3AS1f", name.str());
+
+  // A structurally equal descriptor gets the very same string.
+  FunctionDescriptor same = demangle("_Z6vload4jPKU3AS1f");
+  ASSERT_EQ(name.data(), cache.get(same).data());
+  ASSERT_EQ("_Z12get_work_dimv",
+    cache.get(demangle("_Z12get_work_dimv")).str());
+
+  MangleCache::Statistics stats = cache.getStatistics();
+  ASSERT_EQ(1U, stats.hits);
+  ASSERT_EQ(2U, stats.misses);
+  ASSERT_EQ(0U, stats.rejected);
+  ASSERT_EQ(2U, stats.entries);
+  ASSERT_EQ(name.size() + strlen("_Z12get_work_dimv"), stats.bytes);
+}
+
+TEST(MangleCacheTest, bounded) {
+  MangleCache cache(2);
+  ASSERT_FALSE(cache.get(demangle("_Z4funci")).empty());
+  ASSERT_FALSE(cache.get(demangle("_Z4funcf")).empty());
+  ASSERT_TRUE(cache.get(demangle("_Z4funcd")).empty());
+  // Cached names are still served.
+  ASSERT_EQ("_Z4funci", cache.get(demangle("_Z4funci")).str());
+
+  MangleCache::Statistics stats = cache.getStatistics();
+  ASSERT_EQ(1U, stats.hits);
+  ASSERT_EQ(2U, stats.misses);
+  ASSERT_EQ(1U, stats.rejected);
+  ASSERT_EQ(2U, stats.entries);
+}
+
+TEST(MangleCacheTest, ownsItsKeys) {
+  MangleCache cache;
+  {
+    // The cache copies the types of the descriptors it keeps, so they may
+    // be modified or freed afterwards.
+    TypeArena arena;
+    FunctionDescriptor fd = demangle("_Z6vload4jPKU3AS1f");
+    arena.clone(fd);
+    ASSERT_EQ("_Z6vload4jPKU3AS1f", cache.get(fd).str());
+    PointerType* p = dyn_cast<PointerType>(&*fd.parameters[1]);
+    ASSERT_TRUE(p);
+    p->setAddressSpace(ATTR_LOCAL);
+  }
+  FunctionDescriptor same = demangle("_Z6vload4jPKU3AS1f");
+  ASSERT_EQ("_Z6vload4jPKU3AS1f", cache.get(same).str());
+  ASSERT_EQ(1U, cache.getStatistics().hits);
+}
+
+TEST(MangleCacheTest, threads) {
+  static const char* Names[] = {
+    "_Z4funci", "_Z4funcf", "_Z4funcPf", "_Z4funcDv4_f", "_Z4funcPU3AS1f"
+  };
+  MangleCache cache;
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < 4; ++t) {
+    threads.push_back(std::thread([&cache]() {
+      std::vector<FunctionDescriptor> fds;
+      for (unsigned i = 0; i < 5; ++i)
+        fds.push_back(demangle(Names[i]));
+      for (unsigned it = 0; it < 1000; ++it)
+        for (unsigned i = 0; i < 5; ++i)
+          ASSERT_EQ(Names[i], cache.get(fds[i]).str());
+    }));
+  }
+  for (unsigned t = 0; t < threads.size(); ++t)
+    threads[t].join();
+  MangleCache::Statistics stats = cache.getStatistics();
+  ASSERT_EQ(5U, stats.entries);
+  ASSERT_EQ(5U, stats.misses);
+  ASSERT_EQ(4U * 1000 * 5 - 5, stats.hits);
+}
+
+}// End namespace test
+}// End namespace namemangling
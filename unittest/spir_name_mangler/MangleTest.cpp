@@ -8,7 +8,9 @@
 #include "spir_name_mangler/FunctionDescriptor.h"
 #include "spir_name_mangler/NameMangleAPI.h"
 #include "spir_name_mangler/ParameterType.h"
+#include "llvm/ADT/SmallString.h"
 #include "gtest/gtest.h"
+#include <string.h>
 
 using namespace SPIR;
 
@@ -342,6 +344,48 @@ TEST(AttrOrderTest, removePtrQualifiers) {
   ASSERT_STREQ(s, mangled.c_str());
 }
 
+TEST(MangleBuffer, append) {
+  // "async_work_group_copy(__local char2 *, __global const char2 *)"
+  const char* s = "_Z21async_work_group_copyPU3AS3Dv2_cPKU3AS1Dv2_c";
+  FunctionDescriptor fd;
+  RefParamType char2(new VectorType(
+    RefParamType(new PrimitiveType(PRIMITIVE_CHAR)), 2));
+  PointerType* dst = new PointerType(char2);
+  dst->setAddressSpace(ATTR_LOCAL);
+  PointerType* src = new PointerType(char2);
+  src->setAddressSpace(ATTR_GLOBAL);
+  src->setQualifier(ATTR_CONST, true);
+  fd.name = "async_work_group_copy";
+  fd.parameters.push_back(RefParamType(dst));
+  fd.parameters.push_back(RefParamType(src));
+
+  ASSERT_EQ(strlen(s), mangledLength(fd));
+  llvm::SmallString<16> buffer("prefix:");
+  mangle(fd, buffer);
+  ASSERT_EQ(std::string("prefix:") + s, buffer.str().str());
+
+  buffer.clear();
+  fd.toString(buffer);
+  ASSERT_EQ(fd.toString(), buffer.str().str());
+  ASSERT_EQ("async_work_group_copy(__local char2 *, const __global char2 *)",
+    fd.toString());
+
+  ASSERT_EQ(FunctionDescriptor::nullString().size(),
+    mangledLength(FunctionDescriptor::null()));
+}
+
+TEST(MangleBuffer, length) {
+  // "func(myTy1234567890, float16)" - multi digit lengths.
+  FunctionDescriptor fd;
+  fd.name = "func";
+  fd.parameters.push_back(RefParamType(new UserDefinedType("myTy1234567890")));
+  fd.parameters.push_back(RefParamType(new VectorType(
+    RefParamType(new PrimitiveType(PRIMITIVE_FLOAT)), 16)));
+  std::string mangled = mangle(fd);
+  ASSERT_STREQ("_Z4func14myTy1234567890Dv16_f", mangled.c_str());
+  ASSERT_EQ(mangled.size(), mangledLength(fd));
+}
+
 }// End namespace test
 }// End namespace namemangling
 
@@ -0,0 +1,118 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/NameRecognizer.h"
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+static const char* WellFormed[] = {
+  "_Z4funci",
+  "_Z12get_work_dimv",
+  "_Z3foo",
+  "_Z5frexpDv2_fPU3AS1Dv2_i",
+  "_Z6vload4jPKU3AS2f",
+  "_Z4funcPrVKU3AS2i",
+  "_Z4funcPPVi",
+  "_Z6myfunc5myTy15myTy2",
+  "_Z3myfPU3AS23mta",
+  "_Z11read_imagef11ocl_image2d11ocl_samplerDv2_i",
+  "_Z21async_work_group_copyPU3AS3Dv16_cPKU3AS1Dv16_cj9ocl_event",
+  "_Z4funcDv4_Dh17ocl_image1dbuffer16ocl_image2darray"
+};
+
+// Checks that recognize() and demangle() agree on the given string.
+static void checkAgreement(const std::string& s) {
+  RecognizedName rn;
+  DemangledName dn;
+  ASSERT_EQ(demangle(s, dn), recognize(s, rn)) << s;
+}
+
+//
+// Tests
+//
+
+TEST(NameRecognizerTest, structure) {
+  RecognizedName rn;
+  ASSERT_TRUE(recognize("_Z5frexpDv2_fPU3AS1Dv2_i", rn));
+  ASSERT_EQ("frexp", rn.name.str());
+  ASSERT_EQ(2U, rn.numParameters);
+  ASSERT_EQ("Dv2_f", rn.getParameter(0).str());
+  ASSERT_EQ("PU3AS1Dv2_i", rn.getParameter(1).str());
+
+  ASSERT_TRUE(recognize(
+    "_Z11read_imagef11ocl_image2d11ocl_samplerDv2_i", rn));
+  ASSERT_EQ("read_imagef", rn.name.str());
+  ASSERT_EQ(3U, rn.numParameters);
+  ASSERT_EQ("11ocl_image2d", rn.getParameter(0).str());
+  ASSERT_EQ("11ocl_sampler", rn.getParameter(1).str());
+  ASSERT_EQ("Dv2_i", rn.getParameter(2).str());
+
+  ASSERT_TRUE(recognize("_Z3foo", rn));
+  ASSERT_EQ("foo", rn.name.str());
+  ASSERT_EQ(0U, rn.numParameters);
+}
+
+TEST(NameRecognizerTest, parameters) {
+  // Each parameter slice is a complete type on its own.
+  for (unsigned i = 0; i < sizeof(WellFormed) / sizeof(WellFormed[0]); ++i) {
+    RecognizedName rn;
+    ASSERT_TRUE(recognize(WellFormed[i], rn)) << WellFormed[i];
+    FunctionDescriptor fd = demangle(WellFormed[i]);
+    ASSERT_EQ(fd.name, rn.name.str());
+    ASSERT_EQ(fd.parameters.size(), rn.numParameters);
+    for (unsigned j = 0; j < rn.numParameters; ++j) {
+      FunctionDescriptor single = demangle("_Z1f" + rn.getParameter(j).str());
+      ASSERT_EQ(1U, single.parameters.size());
+      ASSERT_TRUE(single.parameters[0]->equals(fd.parameters[j]));
+    }
+  }
+}
+
+TEST(NameRecognizerTest, malformed) {
+  const char* names[] = {
+    "", "func", "_Z", "_Z5func", "_Z04funci", "_Z4funcDv", "_Z4funcDv4f",
+    "_Z4funcP", "_Z4funcQ", "_Z4func12ocl_image", "_Z4funcDv0_f",
+    "_Z4funcDv4_", "_Z4funcPU3AS4i", "_Z4funcPU3AS", "_Z4funcPKri",
+    "_Z4funcDx", "_Z4func0", "_Z4func99999999999999f"
+  };
+  for (unsigned i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+    RecognizedName rn;
+    ASSERT_FALSE(recognize(names[i], rn)) << names[i];
+    checkAgreement(names[i]);
+  }
+
+  std::string many = "_Z4func";
+  for (unsigned i = 0; i <= RecognizedName::MAX_PARAMETERS; ++i)
+    many += "i";
+  checkAgreement(many);
+}
+
+TEST(NameRecognizerTest, matchesDemangle) {
+  // Truncations, deletions and replacements of well formed names.
+  const char replacements[] = "_ZDPUASrVKvhi0139x";
+  for (unsigned i = 0; i < sizeof(WellFormed) / sizeof(WellFormed[0]); ++i) {
+    const std::string s = WellFormed[i];
+    checkAgreement(s);
+    for (size_t pos = 0; pos < s.size(); ++pos) {
+      checkAgreement(s.substr(0, pos));
+      checkAgreement(s.substr(0, pos) + s.substr(pos + 1));
+      for (const char* r = replacements; *r; ++r) {
+        std::string mutated = s;
+        mutated[pos] = *r;
+        checkAgreement(mutated);
+      }
+    }
+  }
+}
+
+}// End namespace test
+}// End namespace namemangling
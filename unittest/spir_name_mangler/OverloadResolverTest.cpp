@@ -0,0 +1,130 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/OverloadResolver.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+static PackedType prim(TypePrimitiveEnum p) {
+  return PackedType::getPrimitive(p);
+}
+
+static PackedType vec(TypePrimitiveEnum p, unsigned len) {
+  return PackedType::getVector(p, len);
+}
+
+static const unsigned ConstBit = 1U << (ATTR_CONST - ATTR_QUALIFIER_FIRST);
+
+//
+// Tests
+//
+
+TEST(OverloadResolverTest, exact) {
+  OverloadResolver resolver(false);
+  PackedType f = prim(PRIMITIVE_FLOAT);
+  OverloadResult r = resolver.resolve("cos", f);
+  ASSERT_TRUE(r.isFound());
+  ASSERT_EQ(BI_3cosf, r.id);
+  ASSERT_EQ("_Z3cosf", r.getMangledName().str());
+  ASSERT_EQ("_Z3cosf", mangle(r.getDescriptor()));
+
+  r = resolver.resolve("cos", vec(PRIMITIVE_FLOAT, 4));
+  ASSERT_EQ(BI_3cosDv4_f, r.id);
+
+  // No arguments.
+  r = resolver.resolve("get_work_dim", llvm::ArrayRef<PackedType>());
+  ASSERT_EQ(BI_12get_work_dimv, r.id);
+}
+
+TEST(OverloadResolverTest, conversions) {
+  OverloadResolver resolver32(false), resolver64(true);
+  // int converts to the size_t offset, as wide as the pointers.
+  PackedType f = prim(PRIMITIVE_FLOAT);
+  PackedType load[] = { prim(PRIMITIVE_INT),
+    f.getPointer(ATTR_GLOBAL, ConstBit) };
+  OverloadResult r = resolver32.resolve("vload4", load);
+  ASSERT_EQ(OVERLOAD_FOUND, r.status);
+  ASSERT_EQ("_Z6vload4jPKU3AS1f", r.getMangledName().str());
+  r = resolver64.resolve("vload4", load);
+  ASSERT_EQ("_Z6vload4mPKU3AS1f", r.getMangledName().str());
+
+  // A promotion to int is better than a conversion to uint.
+  PackedType s = prim(PRIMITIVE_SHORT);
+  PackedType shorts[] = { s, s, s };
+  ASSERT_EQ(BI_5mad24iii, resolver32.resolve("mad24", shorts).id);
+  // half is promoted to float.
+  ASSERT_EQ(BI_4sqrtf, resolver32.resolve("sqrt", prim(PRIMITIVE_HALF)).id);
+
+  // A pointer may gain qualifiers.
+  PackedType args[] = { prim(PRIMITIVE_UINT), f.getPointer(ATTR_GLOBAL) };
+  ASSERT_EQ(BI_6vload4jPKU3AS1f, resolver32.resolve("vload4", args).id);
+  args[1] = f.getPointer(ATTR_GLOBAL, ConstBit);
+  ASSERT_EQ(BI_6vload4jPKU3AS1f, resolver32.resolve("vload4", args).id);
+
+  // The same call, with ParamTypes.
+  std::vector<RefParamType> params;
+  params.push_back(prim(PRIMITIVE_UINT).toParamType());
+  params.push_back(f.getPointer(ATTR_GLOBAL).toParamType());
+  ASSERT_EQ(BI_6vload4jPKU3AS1f, resolver32.resolve("vload4", params).id);
+}
+
+TEST(OverloadResolverTest, failures) {
+  OverloadResolver resolver(false);
+  PackedType f = prim(PRIMITIVE_FLOAT);
+  PackedType i = prim(PRIMITIVE_INT);
+  ASSERT_EQ(OVERLOAD_NO_MATCH, resolver.resolve("no_such_builtin", f).status);
+  // Vectors are not converted.
+  OverloadResult r = resolver.resolve("cos", vec(PRIMITIVE_INT, 4));
+  ASSERT_EQ(OVERLOAD_NO_MATCH, r.status);
+  ASSERT_EQ(BI_NUM_BUILTINS, r.id);
+  // Arity.
+  PackedType two[] = { f, f };
+  ASSERT_EQ(OVERLOAD_NO_MATCH, resolver.resolve("cos", two).status);
+  // Pointees are not converted.
+  PackedType args[] = { prim(PRIMITIVE_UINT), f.getPointer(ATTR_LOCAL) };
+  ASSERT_TRUE(resolver.resolve("vload4", args).isFound());
+  args[1] = prim(PRIMITIVE_HALF).getPointer(ATTR_LOCAL);
+  ASSERT_EQ(OVERLOAD_NO_MATCH, resolver.resolve("vload4", args).status);
+  // Nor are address spaces (there is no vstore to __constant).
+  PackedType store[] = { vec(PRIMITIVE_FLOAT, 4), prim(PRIMITIVE_UINT),
+    f.getPointer(ATTR_GLOBAL) };
+  ASSERT_TRUE(resolver.resolve("vstore4", store).isFound());
+  store[2] = f.getPointer(ATTR_CONSTANT);
+  ASSERT_EQ(OVERLOAD_NO_MATCH, resolver.resolve("vstore4", store).status);
+  // Pointers do not lose qualifiers.
+  store[2] = f.getPointer(ATTR_GLOBAL, ConstBit);
+  ASSERT_EQ(OVERLOAD_NO_MATCH, resolver.resolve("vstore4", store).status);
+  // int converts to float as well as to double.
+  ASSERT_EQ(OVERLOAD_AMBIGUOUS, resolver.resolve("sqrt", i).status);
+  PackedType mixed[] = { i, f };
+  ASSERT_EQ(OVERLOAD_AMBIGUOUS, resolver.resolve("max", mixed).status);
+}
+
+TEST(OverloadResolverTest, allBuiltins) {
+  // Called with the types of its parameters, a built-in resolves to itself.
+  for (unsigned is64Bit = 0; is64Bit < 2; ++is64Bit) {
+    OverloadResolver resolver(is64Bit);
+    for (unsigned i = 0; i < BI_NUM_BUILTINS; ++i) {
+      BuiltinID id = (BuiltinID)i;
+      std::vector<PackedType> args;
+      for (unsigned p = 0; p < getBuiltinNumParameters(id); ++p)
+        args.push_back(getBuiltinParameter(id, p, is64Bit));
+      if (args.size() == 1 && args[0] == prim(PRIMITIVE_VOID))
+        args.clear();
+      OverloadResult r = resolver.resolve(getBuiltinName(id), args);
+      ASSERT_EQ(id, r.id) << getBuiltinMangledName(id, is64Bit).str();
+    }
+  }
+}
+
+}// End namespace test
+}// End namespace namemangling
@@ -0,0 +1,107 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/FunctionDescriptor.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/PackedType.h"
+#include "spir_name_mangler/ParameterType.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "gtest/gtest.h"
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+//
+// Tests
+//
+
+TEST(PackedTypeTest, encoding) {
+  PackedType float4 = PackedType::getVector(PRIMITIVE_FLOAT, 4);
+  ASSERT_TRUE(float4.isValid());
+  ASSERT_TRUE(float4.isVector());
+  ASSERT_FALSE(float4.isPointer());
+  ASSERT_EQ(PRIMITIVE_FLOAT, float4.getPrimitive());
+  ASSERT_EQ(4U, float4.getLength());
+
+  PackedType p = float4.getPointer(ATTR_LOCAL,
+    1U << (ATTR_CONST - ATTR_QUALIFIER_FIRST));
+  ASSERT_TRUE(p.isPointer());
+  ASSERT_EQ(ATTR_LOCAL, p.getAddressSpace());
+  ASSERT_TRUE(p.hasQualifier(ATTR_CONST));
+  ASSERT_FALSE(p.hasQualifier(ATTR_VOLATILE));
+  ASSERT_TRUE(p == PackedType::fromBits(p.getBits()));
+  ASSERT_TRUE(p != float4);
+
+  // Shapes which do not fit.
+  ASSERT_FALSE(PackedType::getVector(PRIMITIVE_INT, 32).isValid());
+  ASSERT_FALSE(p.getPointer().isValid());
+  ASSERT_FALSE(PackedType().isValid());
+}
+
+TEST(PackedTypeTest, mangle) {
+  const char* s =
+    "_Z21async_work_group_copyPU3AS3Dv16_cPKU3AS1Dv16_cj9ocl_event";
+  PackedType char16 = PackedType::getVector(PRIMITIVE_CHAR, 16);
+  PackedType params[] = {
+    char16.getPointer(ATTR_LOCAL),
+    char16.getPointer(ATTR_GLOBAL, 1U << (ATTR_CONST - ATTR_QUALIFIER_FIRST)),
+    PackedType::getPrimitive(PRIMITIVE_UINT),
+    PackedType::getPrimitive(PRIMITIVE_EVENT_T)
+  };
+  llvm::SmallString<64> mangled;
+  mangle("async_work_group_copy", params, mangled);
+  ASSERT_EQ(s, mangled.str());
+
+  size_t len = 2 + 2 + 21;
+  for (unsigned i = 0; i < 4; ++i)
+    len += params[i].mangledLength();
+  ASSERT_EQ(strlen(s), len);
+}
+
+TEST(PackedTypeTest, roundTrip) {
+  const char* names[] = {
+    "_Z5frexpDv2_fPU3AS1Dv2_i",
+    "_Z6vload4jPKU3AS2f",
+    "_Z7vstore3Dv3_hjPVU3AS3h",
+    "_Z8prefetchPrVKU3AS1Dv8_lj",
+    "_Z11read_imagef11ocl_image2d11ocl_samplerDv2_i"
+  };
+  for (unsigned i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+    FunctionDescriptor fd = demangle(names[i]);
+    ASSERT_FALSE(fd.isNull());
+    llvm::SmallVector<PackedType, 4> packed;
+    FunctionDescriptor copy(fd.name);
+    for (unsigned j = 0; j < fd.parameters.size(); ++j) {
+      PackedType t = PackedType::get(fd.parameters[j]);
+      ASSERT_TRUE(t.isValid());
+      packed.push_back(t);
+      RefParamType back = t.toParamType();
+      ASSERT_TRUE(back->equals(fd.parameters[j]));
+      ASSERT_TRUE(PackedType::get(back) == t);
+      copy.parameters.push_back(back);
+    }
+    llvm::SmallString<64> mangled;
+    mangle(fd.name, packed, mangled);
+    ASSERT_EQ(mangle(fd), mangled.str().str());
+    ASSERT_TRUE(fd == copy);
+  }
+}
+
+TEST(PackedTypeTest, unsupported) {
+  RefParamType user(new UserDefinedType("myTy"));
+  ASSERT_FALSE(PackedType::get(user).isValid());
+  RefParamType ptr(new PointerType(user));
+  ASSERT_FALSE(PackedType::get(ptr).isValid());
+  RefParamType i(new PrimitiveType(PRIMITIVE_INT));
+  RefParamType ptrPtr(new PointerType(RefParamType(new PointerType(i))));
+  ASSERT_FALSE(PackedType::get(ptrPtr).isValid());
+}
+
+}// End namespace test
+}// End namespace namemangling
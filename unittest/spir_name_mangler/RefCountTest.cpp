@@ -0,0 +1,95 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/FunctionDescriptor.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/ParameterType.h"
+#include "gtest/gtest.h"
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+//
+// Tests
+//
+
+TEST(RefCountTest, intrusive) {
+  PrimitiveType* f = new PrimitiveType(PRIMITIVE_FLOAT);
+  RefParamType a(f);
+  ASSERT_EQ(1U, f->getRefCount());
+  {
+    // A second handle made from the raw pointer shares the counter.
+    RefParamType b(f);
+    ASSERT_EQ(2U, f->getRefCount());
+  }
+  ASSERT_EQ(1U, f->getRefCount());
+  RefParamType c = a;
+  ASSERT_EQ(2U, f->getRefCount());
+  c = a;
+  ASSERT_EQ(2U, f->getRefCount());
+}
+
+TEST(RefCountTest, move) {
+  PrimitiveType* f = new PrimitiveType(PRIMITIVE_FLOAT);
+  RefParamType a(f);
+  RefParamType b(std::move(a));
+  ASSERT_TRUE(a.isNull());
+  ASSERT_EQ(1U, f->getRefCount());
+  RefParamType c;
+  c = std::move(b);
+  ASSERT_TRUE(b.isNull());
+  ASSERT_EQ(1U, f->getRefCount());
+  c.swap(a);
+  ASSERT_TRUE(c.isNull());
+  ASSERT_EQ(f, &*a);
+}
+
+TEST(RefCountTest, threads) {
+  RefParamType shared(new PrimitiveType(PRIMITIVE_INT));
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < 4; ++t) {
+    threads.push_back(std::thread([&shared]() {
+      for (unsigned i = 0; i < 10000; ++i) {
+        RefParamType copy = shared;
+        TypeVector v(4, copy);
+      }
+    }));
+  }
+  for (unsigned t = 0; t < threads.size(); ++t)
+    threads[t].join();
+  ASSERT_EQ(1U, shared->getRefCount());
+}
+
+TEST(RefCountTest, emplaceParameter) {
+  // "frexp(float2, __global int2*)"
+  FunctionDescriptor fd("frexp");
+  fd.emplaceParameter<VectorType>(
+    RefParamType(new PrimitiveType(PRIMITIVE_FLOAT)), 2);
+  PointerType* p = fd.emplaceParameter<PointerType>(
+    RefParamType(new VectorType(RefParamType(
+      new PrimitiveType(PRIMITIVE_INT)), 2)));
+  p->setAddressSpace(ATTR_GLOBAL);
+  ASSERT_STREQ("_Z5frexpDv2_fPU3AS1Dv2_i", mangle(fd).c_str());
+
+  FunctionDescriptor moved(std::move(fd));
+  ASSERT_TRUE(fd.parameters.empty());
+  ASSERT_EQ(1U, moved.parameters[1]->getRefCount());
+
+  FunctionDescriptor assigned("ldexp");
+  assigned.emplaceParameter<PrimitiveType>(PRIMITIVE_FLOAT);
+  assigned = std::move(moved);
+  ASSERT_TRUE(moved.parameters.empty());
+  ASSERT_EQ(2U, assigned.parameters.size());
+  ASSERT_EQ(1U, assigned.parameters[1]->getRefCount());
+}
+
+}// End namespace test
+}// End namespace namemangling
@@ -0,0 +1,161 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/FunctionDescriptor.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/StaticMangle.h"
+#include "gtest/gtest.h"
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+// Checks a compile time mangled name against the expected string and
+// against the runtime mangling of the same signature.
+template <typename Signature, size_t N>
+static void check(const char* expected, llvm::StringRef mangled,
+                  const char (&name)[N]) {
+  ASSERT_EQ(expected, mangled.str());
+  ASSERT_EQ(mangle(Signature::descriptor(name)), mangled.str());
+}
+
+//
+// Tests (the cases of MangleTest.cpp)
+//
+
+TEST(StaticMangleTest, scalars) {
+  typedef StaticSignature<StaticInt> Int;
+  typedef StaticSignature<StaticFloat> Float;
+  typedef StaticSignature<StaticDouble> Double;
+  constexpr auto i = Int::mangle("func");
+  constexpr auto f = Float::mangle("func");
+  constexpr auto d = Double::mangle("func");
+  static_assert(i.size() == 8 && i[7] == 'i', "computed at compile time");
+  check<Int>("_Z4funci", i.str(), "func");
+  check<Float>("_Z4funcf", f.str(), "func");
+  check<Double>("_Z4funcd", d.str(), "func");
+}
+
+TEST(StaticMangleTest, PtrType) {
+  typedef StaticSignature<StaticFloat, StaticPointer<StaticFloat>,
+    StaticPointer<StaticFloat> > Sig;
+  constexpr auto s = Sig::mangle("Func");
+  check<Sig>("_Z4FuncfPfPf", s.str(), "Func");
+}
+
+TEST(StaticMangleTest, imageBuiltin) {
+  typedef StaticSignature<StaticImage2D, StaticSampler,
+    StaticVector<StaticFloat, 2> > Sig;
+  constexpr auto s = Sig::mangle("read_imagef");
+  check<Sig>("_Z11read_imagef11ocl_image2d11ocl_samplerDv2_f", s.str(),
+    "read_imagef");
+}
+
+struct MyTy1 {
+  static constexpr const char* name() {
+    return "myTy1";
+  }
+};
+
+struct MyTy2 {
+  static constexpr const char* name() {
+    return "myTy2";
+  }
+};
+
+struct Mta {
+  static constexpr const char* name() {
+    return "mta";
+  }
+};
+
+TEST(StaticMangleTest, userDefinedTypes) {
+  typedef StaticSignature<StaticUserDefined<MyTy1>,
+    StaticUserDefined<MyTy2> > Sig;
+  constexpr auto s = Sig::mangle("myfunc");
+  check<Sig>("_Z6myfunc5myTy15myTy2", s.str(), "myfunc");
+}
+
+TEST(StaticMangleTest, vecAndVecPtr) {
+  typedef StaticSignature<StaticVector<StaticFloat, 2>,
+    StaticPointer<StaticVector<StaticInt, 2>, ATTR_GLOBAL> > Sig;
+  constexpr auto s = Sig::mangle("frexp");
+  check<Sig>("_Z5frexpDv2_fPU3AS1Dv2_i", s.str(), "frexp");
+}
+
+TEST(StaticMangleTest, mask_fmax) {
+  typedef StaticVector<StaticFloat, 16> Float16;
+  typedef StaticSignature<StaticUShort, Float16, Float16> Sig;
+  constexpr auto s = Sig::mangle("mask_fmax");
+  check<Sig>("_Z9mask_fmaxtDv16_fDv16_f", s.str(), "mask_fmax");
+}
+
+TEST(StaticMangleTest, duplicateParam) {
+  typedef StaticVector<StaticFloat, 16> Float16;
+  typedef StaticPointer<Float16> Float16Ptr;
+  typedef StaticSignature<Float16, Float16, Float16, Float16, Float16,
+    Float16, Float16Ptr, Float16Ptr, Float16Ptr> Sig;
+  constexpr auto s = Sig::mangle("soa_cross3");
+  check<Sig>(
+    "_Z10soa_cross3Dv16_fDv16_fDv16_fDv16_fDv16_fDv16_fPDv16_fPDv16_fPDv16_f",
+    s.str(), "soa_cross3");
+}
+
+TEST(StaticMangleTest, addrSpaceAttrs) {
+  typedef StaticVector<StaticChar, 2> Char2;
+  typedef StaticSignature<StaticPointer<Char2, ATTR_LOCAL>,
+    StaticPointer<Char2, ATTR_GLOBAL, qualifierBit(ATTR_CONST)>,
+    StaticPointer<Char2, ATTR_PRIVATE>,
+    StaticPointer<Char2, ATTR_CONSTANT> > Sig;
+  constexpr auto s = Sig::mangle("async_work_group_copy");
+  check<Sig>(
+    "_Z21async_work_group_copyPU3AS3Dv2_cPKU3AS1Dv2_cPDv2_cPU3AS2Dv2_c",
+    s.str(), "async_work_group_copy");
+}
+
+TEST(StaticMangleTest, addressSpaceAndUserDefTy) {
+  typedef StaticSignature<
+    StaticPointer<StaticUserDefined<Mta>, ATTR_CONSTANT> > Sig;
+  constexpr auto s = Sig::mangle("myf");
+  check<Sig>("_Z3myfPU3AS23mta", s.str(), "myf");
+}
+
+TEST(StaticMangleTest, pointerAttributes) {
+  const unsigned restrictBit = qualifierBit(ATTR_RESTRICT);
+  const unsigned volatileBit = qualifierBit(ATTR_VOLATILE);
+  const unsigned constBit = qualifierBit(ATTR_CONST);
+  typedef StaticSignature<StaticPointer<StaticInt, ATTR_CONSTANT,
+    restrictBit | volatileBit | constBit> > RVK;
+  typedef StaticSignature<StaticPointer<StaticInt, ATTR_CONSTANT,
+    restrictBit | constBit> > RK;
+  typedef StaticSignature<StaticPointer<StaticInt, ATTR_PRIVATE,
+    restrictBit | constBit> > RKPrivate;
+  typedef StaticSignature<StaticPointer<StaticInt, ATTR_LOCAL,
+    restrictBit> > RLocal;
+  typedef StaticSignature<StaticPointer<StaticInt> > Plain;
+  constexpr auto rvk = RVK::mangle("func");
+  constexpr auto rk = RK::mangle("func");
+  constexpr auto rkPrivate = RKPrivate::mangle("func");
+  constexpr auto rLocal = RLocal::mangle("func");
+  constexpr auto plain = Plain::mangle("func");
+  check<RVK>("_Z4funcPrVKU3AS2i", rvk.str(), "func");
+  check<RK>("_Z4funcPrKU3AS2i", rk.str(), "func");
+  check<RKPrivate>("_Z4funcPrKi", rkPrivate.str(), "func");
+  check<RLocal>("_Z4funcPrU3AS3i", rLocal.str(), "func");
+  check<Plain>("_Z4funcPi", plain.str(), "func");
+}
+
+TEST(StaticMangleTest, length) {
+  typedef StaticSignature<StaticVector<StaticFloat, 16> > Sig;
+  constexpr auto s = Sig::mangle("a_function_name_with_a_long_name");
+  static_assert(s.size() == 2 + 2 + 32 + 6, "multi digit name length");
+  check<Sig>("_Z32a_function_name_with_a_long_nameDv16_f", s.str(),
+    "a_function_name_with_a_long_name");
+}
+
+}// End namespace test
+}// End namespace namemangling
@@ -0,0 +1,138 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/FunctionDescriptor.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/NameRecognizer.h"
+#include "spir_name_mangler/ParameterType.h"
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+// Pairs of names mangled in full and with substitutions.
+static const char* Names[][2] = {
+  { "_Z4funci", "_Z4funci" },
+  { "_Z4funcff", "_Z4funcff" },
+  { "_Z5frexpDv2_fPU3AS1Dv2_f", "_Z5frexpDv2_fPU3AS1S_" },
+  { "_Z7vstore4Dv4_fjPU3AS1f", "_Z7vstore4Dv4_fjPU3AS1f" },
+  { "_Z10soa_cross3Dv16_fDv16_fDv16_fDv16_fDv16_fDv16_fPDv16_fPDv16_fPDv16_f",
+    "_Z10soa_cross3Dv16_fS_S_S_S_S_PS_S0_S0_" },
+  { "_Z21async_work_group_copyPU3AS3Dv2_cPKU3AS1Dv2_cj9ocl_event",
+    "_Z21async_work_group_copyPU3AS3Dv2_cPKU3AS1S_j9ocl_event" },
+  { "_Z4funcPKfPKf", "_Z4funcPKfS0_" },
+  { "_Z4funcPfPPf", "_Z4funcPfPS_" },
+  { "_Z4func11ocl_image2d11ocl_samplerDv2_i11ocl_image2d",
+    "_Z4func11ocl_image2d11ocl_samplerDv2_iS_" },
+  { "_Z6myfunc5myTy15myTy25myTy1", "_Z6myfunc5myTy15myTy2S_" },
+  // Half and the other builtin types are never substituted.
+  { "_Z4funcDhDhii", "_Z4funcDhDhii" }
+};
+
+//
+// Tests
+//
+
+TEST(SubstitutionTest, mangle) {
+  for (unsigned i = 0; i < sizeof(Names) / sizeof(Names[0]); ++i) {
+    FunctionDescriptor fd = demangle(Names[i][0]);
+    ASSERT_FALSE(fd.isNull()) << Names[i][0];
+    ASSERT_EQ(Names[i][0], mangle(fd));
+    ASSERT_EQ(Names[i][0], mangle(fd, MANGLING_DEFAULT));
+    ASSERT_EQ(Names[i][1], mangle(fd, MANGLING_SUBSTITUTIONS));
+    ASSERT_EQ(strlen(Names[i][1]), mangledLength(fd, MANGLING_SUBSTITUTIONS));
+  }
+}
+
+TEST(SubstitutionTest, demangle) {
+  for (unsigned i = 0; i < sizeof(Names) / sizeof(Names[0]); ++i) {
+    FunctionDescriptor fd = demangle(Names[i][1]);
+    ASSERT_FALSE(fd.isNull()) << Names[i][1];
+    ASSERT_TRUE(fd == demangle(Names[i][0])) << Names[i][1];
+
+    RecognizedName rn;
+    ASSERT_TRUE(recognize(Names[i][1], rn)) << Names[i][1];
+    ASSERT_EQ(fd.parameters.size(), rn.numParameters);
+  }
+
+  // A substituted qualified pointee (S_ is "Kf").
+  ASSERT_TRUE(demangle("_Z4funcPKfPS_") == demangle("_Z4funcPKfPKf"));
+}
+
+TEST(SubstitutionTest, sequenceIds) {
+  // Every pointer of a chain is a candidate, the outermost one completes
+  // last. Index 11 is "SA_", index 38 is "S11_".
+  std::string chain = "f";
+  RefParamType type(new PrimitiveType(PRIMITIVE_FLOAT));
+  for (unsigned i = 0; i < 39; ++i) {
+    chain = "P" + chain;
+    type = RefParamType(new PointerType(type));
+  }
+  FunctionDescriptor fd("func");
+  fd.parameters.push_back(type);
+  fd.parameters.push_back(type);
+  // Too many type nodes to demangle in full.
+  ASSERT_EQ("_Z4func" + chain + chain, mangle(fd));
+  ASSERT_EQ("_Z4func" + chain + "S11_", mangle(fd, MANGLING_SUBSTITUTIONS));
+  ASSERT_TRUE(fd == demangle("_Z4func" + chain + "S11_"));
+
+  fd = demangle("_Z4func" + chain.substr(27) + chain.substr(27));
+  ASSERT_FALSE(fd.isNull());
+  ASSERT_EQ("_Z4func" + chain.substr(27) + "SA_",
+    mangle(fd, MANGLING_SUBSTITUTIONS));
+  ASSERT_TRUE(fd == demangle("_Z4func" + chain.substr(27) + "SA_"));
+}
+
+TEST(SubstitutionTest, malformed) {
+  const char* names[] = {
+    // No candidates yet.
+    "_Z4funcS_", "_Z4funciS_", "_Z4funcPS_",
+    // Out of range.
+    "_Z4funcDv4_fS0_", "_Z4funcPfS1_",
+    // Not terminated, or not a base 36 number.
+    "_Z4funcDv4_fS", "_Z4funcDv4_fS0", "_Z4funcDv4_fSa_",
+    // A qualified pointee is not a parameter type.
+    "_Z4funcPKfS_", "_Z4funcPKfPKS_",
+    // Builtin types are not candidates.
+    "_Z4funcfS_", "_Z4funcDhS_"
+  };
+  for (unsigned i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+    DemangledName dn;
+    RecognizedName rn;
+    ASSERT_FALSE(demangle(names[i], dn)) << names[i];
+    ASSERT_FALSE(recognize(names[i], rn)) << names[i];
+  }
+}
+
+TEST(SubstitutionTest, recognizerMatchesDemangle) {
+  // Truncations, deletions and replacements of names with substitutions.
+  const char replacements[] = "_SPKU3A0129ACZfi";
+  for (unsigned i = 0; i < sizeof(Names) / sizeof(Names[0]); ++i) {
+    const std::string s = Names[i][1];
+    for (size_t pos = 0; pos < s.size(); ++pos) {
+      std::string mutations[2 + sizeof(replacements) - 1];
+      unsigned n = 0;
+      mutations[n++] = s.substr(0, pos);
+      mutations[n++] = s.substr(0, pos) + s.substr(pos + 1);
+      for (const char* r = replacements; *r; ++r) {
+        mutations[n] = s;
+        mutations[n++][pos] = *r;
+      }
+      for (unsigned m = 0; m < n; ++m) {
+        DemangledName dn;
+        RecognizedName rn;
+        ASSERT_EQ(demangle(mutations[m], dn), recognize(mutations[m], rn))
+          << mutations[m];
+      }
+    }
+  }
+}
+
+}// End namespace test
+}// End namespace namemangling
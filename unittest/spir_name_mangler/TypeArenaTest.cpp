@@ -0,0 +1,77 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/FunctionDescriptor.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/ParameterType.h"
+#include "spir_name_mangler/TypeArena.h"
+#include "gtest/gtest.h"
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+//
+// Tests
+//
+
+TEST(TypeArenaTest, create) {
+  // "async_work_group_copy(__local char2 *, __global const char2 *, myTy)"
+  TypeArena arena;
+  FunctionDescriptor fd;
+  RefParamType char2 = arena.create<VectorType>(
+    arena.create<PrimitiveType>(PRIMITIVE_CHAR), 2);
+  PointerType* dst = arena.create<PointerType>(char2);
+  dst->setAddressSpace(ATTR_LOCAL);
+  PointerType* src = arena.create<PointerType>(char2);
+  src->setAddressSpace(ATTR_GLOBAL);
+  src->setQualifier(ATTR_CONST, true);
+  fd.name = "async_work_group_copy";
+  fd.parameters.push_back(dst);
+  fd.parameters.push_back(src);
+  fd.parameters.push_back(arena.create<UserDefinedType>("myTy"));
+  ASSERT_EQ(5U, arena.size());
+  ASSERT_EQ(&arena, fd.parameters[0]->getArena());
+  ASSERT_STREQ("_Z21async_work_group_copyPU3AS3Dv2_cPKU3AS1Dv2_c4myTy",
+    mangle(fd).c_str());
+
+  // Dropping all references does not free arena types.
+  fd.parameters.clear();
+  char2 = RefParamType();
+  ASSERT_EQ(2, dyn_cast<VectorType>(src->getPointee())->getLength());
+}
+
+TEST(TypeArenaTest, clone) {
+  const char* s = "_Z5frexpDv2_fPU3AS1Dv2_i";
+  // The arena outlives the descriptor cloned into it.
+  TypeArena arena;
+  FunctionDescriptor fd = demangle(s);
+  FunctionDescriptor copy = fd;
+  arena.clone(copy);
+  ASSERT_EQ(&arena, copy.parameters[1]->getArena());
+  ASSERT_TRUE(fd.parameters[1]->getArena() == NULL);
+  ASSERT_TRUE(fd == copy);
+  ASSERT_STREQ(s, mangle(copy).c_str());
+  // Cloning arena types again is a no-op.
+  unsigned size = arena.size();
+  arena.clone(copy);
+  ASSERT_EQ(size, arena.size());
+}
+
+TEST(TypeArenaTest, heapSubTypes) {
+  RefParamType heap(new PrimitiveType(PRIMITIVE_INT));
+  {
+    TypeArena arena;
+    RefParamType p = arena.create<PointerType>(heap);
+    ASSERT_EQ(2U, heap->getRefCount());
+  }
+  // The arena released its types' references to heap types.
+  ASSERT_EQ(1U, heap->getRefCount());
+}
+
+}// End namespace test
+}// End namespace namemangling
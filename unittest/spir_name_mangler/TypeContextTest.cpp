@@ -0,0 +1,101 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_name_mangler/FunctionDescriptor.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "spir_name_mangler/ParameterType.h"
+#include "spir_name_mangler/TypeContext.h"
+#include "gtest/gtest.h"
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+//
+// Tests
+//
+
+TEST(TypeContextTest, uniquing) {
+  TypeContext ctx;
+  RefParamType f = ctx.getPrimitive(PRIMITIVE_FLOAT);
+  ASSERT_EQ(&*f, &*ctx.getPrimitive(PRIMITIVE_FLOAT));
+  ASSERT_EQ(&ctx, f->getContext());
+
+  RefParamType v1 = ctx.getVector(f, 4);
+  RefParamType v2 = ctx.getVector(RefParamType(new PrimitiveType(PRIMITIVE_FLOAT)), 4);
+  ASSERT_EQ(&*v1, &*v2);
+  ASSERT_NE(&*v1, &*ctx.getVector(f, 8));
+
+  RefParamType p1 = ctx.getPointer(v1, ATTR_GLOBAL,
+                                   1U << (ATTR_CONST - ATTR_QUALIFIER_FIRST));
+  RefParamType p2 = ctx.getPointer(v2, ATTR_GLOBAL,
+                                   1U << (ATTR_CONST - ATTR_QUALIFIER_FIRST));
+  ASSERT_EQ(&*p1, &*p2);
+  ASSERT_NE(&*p1, &*ctx.getPointer(v1, ATTR_GLOBAL));
+  ASSERT_NE(&*p1, &*ctx.getPointer(v1, ATTR_LOCAL,
+                                   1U << (ATTR_CONST - ATTR_QUALIFIER_FIRST)));
+  const PointerType* p = dyn_cast<PointerType>(&*p1);
+  ASSERT_TRUE(p->hasQualifier(ATTR_CONST));
+  ASSERT_FALSE(p->hasQualifier(ATTR_VOLATILE));
+  ASSERT_EQ(ATTR_GLOBAL, p->getAddressSpace());
+
+  ASSERT_EQ(&*ctx.getUserDefined("myTy"), &*ctx.getUserDefined("myTy"));
+  ASSERT_NE(&*ctx.getUserDefined("myTy"), &*ctx.getUserDefined("myTy2"));
+}
+
+TEST(TypeContextTest, equalsAndHash) {
+  TypeContext ctx;
+  // "__local const float4 *" built by hand, and through the context.
+  RefParamType v(new VectorType(RefParamType(
+    new PrimitiveType(PRIMITIVE_FLOAT)), 4));
+  PointerType* ptr = new PointerType(v);
+  ptr->setAddressSpace(ATTR_LOCAL);
+  ptr->setQualifier(ATTR_CONST, true);
+  RefParamType freePtr(ptr);
+
+  RefParamType uniqued = ctx.unique(freePtr);
+  ASSERT_NE(&*freePtr, &*uniqued);
+  ASSERT_TRUE(uniqued->equals(freePtr));
+  ASSERT_TRUE(freePtr->equals(uniqued));
+  ASSERT_EQ(freePtr->getHash(), uniqued->getHash());
+  ASSERT_EQ(&*uniqued, &*ctx.unique(uniqued));
+
+  RefParamType other = ctx.getPointer(v, ATTR_LOCAL);
+  ASSERT_FALSE(uniqued->equals(other));
+  ASSERT_FALSE(other->equals(freePtr));
+}
+
+TEST(TypeContextTest, descriptor) {
+  TypeContext ctx;
+  FunctionDescriptor fd = demangle("_Z5frexpDv2_fPU3AS1Dv2_i");
+  FunctionDescriptor same = demangle("_Z5frexpDv2_fPU3AS1Dv2_i");
+  unsigned size = ctx.size();
+  ctx.unique(fd);
+  // float2, int2 and the pointer.
+  ASSERT_EQ(size + 3, ctx.size());
+  ctx.unique(same);
+  ASSERT_EQ(size + 3, ctx.size());
+  ASSERT_EQ(&*fd.parameters[0], &*same.parameters[0]);
+  ASSERT_EQ(&*fd.parameters[1], &*same.parameters[1]);
+  ASSERT_TRUE(fd == same);
+  ASSERT_STREQ("_Z5frexpDv2_fPU3AS1Dv2_i", mangle(fd).c_str());
+}
+
+TEST(TypeContextTest, outlivesContext) {
+  RefParamType p;
+  {
+    TypeContext ctx;
+    p = ctx.getPointer(ctx.getPrimitive(PRIMITIVE_INT), ATTR_GLOBAL);
+  }
+  ASSERT_TRUE(p->getContext() == NULL);
+  RefParamType q(new PointerType(RefParamType(new PrimitiveType(PRIMITIVE_INT))));
+  dyn_cast<PointerType>(&*q)->setAddressSpace(ATTR_GLOBAL);
+  ASSERT_TRUE(p->equals(q));
+}
+
+}// End namespace test
+}// End namespace namemangling
@@ -0,0 +1,145 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_remangler/FunctionBridge.h"
+#include "spir_name_mangler/NameMangleAPI.h"
+#include "llvm/Assembly/Parser.h"
+#include "llvm/Function.h"
+#include "llvm/LLVMContext.h"
+#include "llvm/Module.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+//
+// Helpers
+//
+
+static llvm::Module* parseModule(const char* assembly,
+                                 llvm::LLVMContext& context) {
+  llvm::SMDiagnostic error;
+  return llvm::ParseAssemblyString(assembly, NULL, error, context);
+}
+
+static std::string mangleFunction(const llvm::Function* f) {
+  FunctionDescriptor fd = getFunctionDescriptor(*f);
+  return fd.isNull() ? std::string() : mangle(fd);
+}
+
+//
+// Tests
+//
+
+TEST(FunctionBridgeTest, opaqueTypes) {
+  llvm::LLVMContext context;
+  llvm::OwningPtr<llvm::Module> m(parseModule(
+    "%opencl.image1d_t = type opaque\n"
+    "%opencl.image1d_array_t = type opaque\n"
+    "%opencl.image1d_buffer_t = type opaque\n"
+    "%opencl.image2d_t = type opaque\n"
+    "%opencl.image2d_array_t = type opaque\n"
+    "%opencl.image3d_t = type opaque\n"
+    "%opencl.event_t = type opaque\n"
+    "declare void @_Z6images11ocl_image1d16ocl_image1darray17ocl_image1dbuffer"
+      "11ocl_image2d16ocl_image2darray11ocl_image3d("
+      "%opencl.image1d_t addrspace(1)*, %opencl.image1d_array_t addrspace(1)*,"
+      " %opencl.image1d_buffer_t addrspace(1)*,"
+      " %opencl.image2d_t addrspace(1)*, %opencl.image2d_array_t addrspace(1)*,"
+      " %opencl.image3d_t addrspace(1)*)\n"
+    "declare <4 x float> @_Z11read_imagef11ocl_image2d11ocl_samplerDv2_i("
+      "%opencl.image2d_t addrspace(1)*, i32, <2 x i32>)\n"
+    "declare void @_Z17wait_group_eventsiP9ocl_event(i32, %opencl.event_t**)\n",
+    context));
+  ASSERT_TRUE(m.get() != NULL);
+
+  // Each name is rebuilt from the signature alone, the sampler from the
+  // hint of the current name.
+  for (llvm::Module::iterator i = m->begin(), e = m->end(); i != e; ++i)
+    ASSERT_EQ(i->getName().str(), mangleFunction(&*i));
+}
+
+TEST(FunctionBridgeTest, signednessFromHint) {
+  llvm::LLVMContext context;
+  llvm::OwningPtr<llvm::Module> m(parseModule(
+    "declare i32 @_Z3absc(i8)\n"
+    "declare i32 @_Z3abss(i16)\n"
+    "declare <2 x i32> @_Z3absDv2_h(<2 x i8>)\n"
+    "declare i64 @_Z3absm(i64)\n"
+    "declare i32 @foo(i32, i64)\n",
+    context));
+  ASSERT_TRUE(m.get() != NULL);
+
+  ASSERT_EQ("_Z3absc", mangleFunction(m->getFunction("_Z3absc")));
+  ASSERT_EQ("_Z3abss", mangleFunction(m->getFunction("_Z3abss")));
+  ASSERT_EQ("_Z3absDv2_h", mangleFunction(m->getFunction("_Z3absDv2_h")));
+  ASSERT_EQ("_Z3absm", mangleFunction(m->getFunction("_Z3absm")));
+  // Without any hint, integers are signed.
+  ASSERT_EQ("_Z3fooil", mangleFunction(m->getFunction("foo")));
+}
+
+TEST(FunctionBridgeTest, kernelArgTypes) {
+  llvm::LLVMContext context;
+  llvm::OwningPtr<llvm::Module> m(parseModule(
+    "%opencl.image2d_t = type opaque\n"
+    "define void @copy(float addrspace(1)* %dst, i32 %n,"
+      " <4 x i32> addrspace(3)* %tmp, %opencl.image2d_t addrspace(1)* %img,"
+      " i32 %smp) {\n"
+    "  ret void\n"
+    "}\n"
+    "define void @helper(i32 %n) {\n"
+    "  ret void\n"
+    "}\n"
+    "!opencl.kernels = !{!0}\n"
+    "!0 = metadata !{void (float addrspace(1)*, i32, <4 x i32> addrspace(3)*,"
+      " %opencl.image2d_t addrspace(1)*, i32)* @copy, metadata !1,"
+      " metadata !2}\n"
+    "!1 = metadata !{metadata !\"kernel_arg_type\", metadata !\"float*\","
+      " metadata !\"uint\", metadata !\"uint4*\", metadata !\"image2d_t\","
+      " metadata !\"sampler_t\"}\n"
+    "!2 = metadata !{metadata !\"kernel_arg_type_qual\", metadata !\"const\","
+      " metadata !\"\", metadata !\"restrict volatile\", metadata !\"\","
+      " metadata !\"\"}\n",
+    context));
+  ASSERT_TRUE(m.get() != NULL);
+
+  FunctionDescriptor fd;
+  ASSERT_TRUE(getKernelArgTypes(*m->getFunction("copy"), fd));
+  ASSERT_EQ("copy", fd.name);
+  ASSERT_EQ(5U, fd.parameters.size());
+  ASSERT_EQ("const __private float *", fd.parameters[0]->toString());
+  ASSERT_EQ("uint", fd.parameters[1]->toString());
+
+  // The address spaces come from the signature, the qualifiers and the
+  // signedness from the metadata.
+  ASSERT_EQ("_Z4copyPKU3AS1fjPrVU3AS3Dv4_j11ocl_image2d11ocl_sampler",
+            mangleFunction(m->getFunction("copy")));
+
+  // A function which is not a kernel has no metadata to take hints from.
+  ASSERT_FALSE(getKernelArgTypes(*m->getFunction("helper"), fd));
+  ASSERT_EQ("_Z6helperi", mangleFunction(m->getFunction("helper")));
+}
+
+TEST(FunctionBridgeTest, unmangleableTypes) {
+  llvm::LLVMContext context;
+  llvm::OwningPtr<llvm::Module> m(parseModule(
+    "declare void @_Z3fooi([4 x i32])\n"
+    "declare void @_Z3barPi(i32 addrspace(5)*)\n"
+    "declare void @_Z3bazi(i128)\n",
+    context));
+  ASSERT_TRUE(m.get() != NULL);
+
+  for (llvm::Module::iterator i = m->begin(), e = m->end(); i != e; ++i)
+    ASSERT_TRUE(getFunctionDescriptor(*i).isNull());
+}
+
+}// End namespace test
+}// End namespace namemangling
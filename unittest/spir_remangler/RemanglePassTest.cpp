@@ -0,0 +1,135 @@
+//
+//                     SPIR Tools
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+
+#include "spir_remangler/RemanglePass.h"
+#include "llvm/Assembly/Parser.h"
+#include "llvm/Function.h"
+#include "llvm/LLVMContext.h"
+#include "llvm/Module.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace SPIR;
+
+namespace namemangling { namespace tests {
+
+//
+// Helpers
+//
+
+static llvm::Module* parseModule(const char* assembly,
+                                 llvm::LLVMContext& context) {
+  llvm::SMDiagnostic error;
+  return llvm::ParseAssemblyString(assembly, NULL, error, context);
+}
+
+//
+// Tests
+//
+
+TEST(RemanglePassTest, spirToSpir64) {
+  llvm::LLVMContext context;
+  // size_t was 32 bit wide when the names were mangled.
+  llvm::OwningPtr<llvm::Module> m(parseModule(
+    "target triple = \"spir64-unknown-unknown\"\n"
+    "declare <4 x float> @_Z6vload4jPKU3AS1f(i64, float addrspace(1)*)\n"
+    "declare i64 @_Z13get_global_idj(i32)\n"
+    "define void @_Z3fooj(i64 %n) {\n"
+    "  ret void\n"
+    "}\n",
+    context));
+  ASSERT_TRUE(m.get() != NULL);
+
+  RemanglePass pass;
+  ASSERT_TRUE(pass.runOnModule(*m));
+  ASSERT_EQ(1U, pass.getNumRenamed());
+  ASSERT_EQ(0U, pass.getNumFailed());
+  ASSERT_TRUE(m->getFunction("_Z6vload4mPKU3AS1f") != NULL);
+  ASSERT_TRUE(m->getFunction("_Z6vload4jPKU3AS1f") == NULL);
+  // Names which already agree with the signature, and definitions, are
+  // left alone.
+  ASSERT_TRUE(m->getFunction("_Z13get_global_idj") != NULL);
+  ASSERT_TRUE(m->getFunction("_Z3fooj") != NULL);
+
+  // A second run has nothing left to do.
+  ASSERT_FALSE(pass.runOnModule(*m));
+  ASSERT_EQ(0U, pass.getNumRenamed());
+}
+
+TEST(RemanglePassTest, spir64ToSpir) {
+  llvm::LLVMContext context;
+  llvm::OwningPtr<llvm::Module> m(parseModule(
+    "target triple = \"spir-unknown-unknown\"\n"
+    "declare <4 x float> @_Z6vload4mPKU3AS1f(i32, float addrspace(1)*)\n"
+    "declare void @_Z7vstore4Dv4_fmPU3AS3f(<4 x float>, i32,"
+      " float addrspace(3)*)\n",
+    context));
+  ASSERT_TRUE(m.get() != NULL);
+
+  RemanglePass pass;
+  ASSERT_TRUE(pass.runOnModule(*m));
+  ASSERT_EQ(2U, pass.getNumRenamed());
+  ASSERT_TRUE(m->getFunction("_Z6vload4jPKU3AS1f") != NULL);
+  ASSERT_TRUE(m->getFunction("_Z7vstore4Dv4_fjPU3AS3f") != NULL);
+}
+
+TEST(RemanglePassTest, cacheHits) {
+  llvm::LLVMContext context;
+  // Both declarations have the same function type and parameter mangling,
+  // so the second one reuses the parameter list of the first.
+  llvm::OwningPtr<llvm::Module> m(parseModule(
+    "declare <4 x float> @_Z6vload4jPKU3AS1f(i64, float addrspace(1)*)\n"
+    "declare <4 x float> @_Z11vload_half4jPKU3AS1f(i64,"
+      " float addrspace(1)*)\n"
+    "declare <4 x float> @_Z6vload4jPKU3AS2f(i64, float addrspace(2)*)\n",
+    context));
+  ASSERT_TRUE(m.get() != NULL);
+
+  RemanglePass pass;
+  ASSERT_TRUE(pass.runOnModule(*m));
+  ASSERT_EQ(3U, pass.getNumRenamed());
+  ASSERT_EQ(1U, pass.getNumCacheHits());
+  ASSERT_TRUE(m->getFunction("_Z6vload4mPKU3AS1f") != NULL);
+  ASSERT_TRUE(m->getFunction("_Z11vload_half4mPKU3AS1f") != NULL);
+  ASSERT_TRUE(m->getFunction("_Z6vload4mPKU3AS2f") != NULL);
+}
+
+TEST(RemanglePassTest, newNameTaken) {
+  llvm::LLVMContext context;
+  llvm::OwningPtr<llvm::Module> m(parseModule(
+    "declare i32 @_Z3absj(i64)\n"
+    "declare i64 @_Z3absm(i64)\n",
+    context));
+  ASSERT_TRUE(m.get() != NULL);
+
+  // Renaming the first declaration would clash with the second, so both
+  // keep their names.
+  RemanglePass pass;
+  ASSERT_FALSE(pass.runOnModule(*m));
+  ASSERT_EQ(0U, pass.getNumRenamed());
+  ASSERT_EQ(1U, pass.getNumFailed());
+  ASSERT_TRUE(m->getFunction("_Z3absj") != NULL);
+  ASSERT_TRUE(m->getFunction("_Z3absm") != NULL);
+  ASSERT_EQ(2U, m->size());
+}
+
+TEST(RemanglePassTest, unmangleableSignature) {
+  llvm::LLVMContext context;
+  llvm::OwningPtr<llvm::Module> m(parseModule(
+    "declare void @_Z3fooi([4 x i32])\n",
+    context));
+  ASSERT_TRUE(m.get() != NULL);
+
+  RemanglePass pass;
+  ASSERT_FALSE(pass.runOnModule(*m));
+  ASSERT_EQ(1U, pass.getNumFailed());
+  ASSERT_TRUE(m->getFunction("_Z3fooi") != NULL);
+}
+
+}// End namespace test
+}// End namespace namemangling